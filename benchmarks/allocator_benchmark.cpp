@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <valfuzz/valfuzz.hpp>
+
+// meet the two fighters:
+#include <tenno/arena.hpp>
+#include <tenno/huge_page_allocator.hpp>
+#include <tenno/memory.hpp>
+#include <tenno/numa_allocator.hpp>
+#include <tenno/vector.hpp>
+
+// A table of 64 MiB, large enough to miss the TLB on random access
+constexpr tenno::size table_size = 8 * 1024 * 1024;
+
+template <class Vec> static Vec &table()
+{
+  static Vec vec(table_size);
+  return vec;
+}
+
+// Read the table at pseudo random positions, the cost is dominated by
+// cache and TLB misses
+template <class Vec> static long random_reads(tenno::size n)
+{
+  Vec &vec = table<Vec>();
+  unsigned long state = 42;
+  long sum = 0;
+  for (tenno::size i = 0; i < n; ++i)
+  {
+    state = state * 6364136223846793005UL + 1442695040888963407UL;
+    sum += vec[(state >> 16) % table_size];
+  }
+  return sum;
+}
+
+BENCHMARK(benchmark_allocator_random_reads,
+          "tenno::vector<long> random reads over 64 MiB")
+{
+  RUN_BENCHMARK(10, random_reads<tenno::vector<long>>(1000000));
+}
+
+BENCHMARK(benchmark_huge_page_allocator_random_reads,
+          "tenno::vector<long, huge_page_allocator> random reads over 64 MiB")
+{
+  RUN_BENCHMARK(
+    10,
+    random_reads<tenno::vector<long, tenno::huge_page_allocator<long>>>(
+      1000000));
+}
+
+BENCHMARK(benchmark_numa_allocator_random_reads,
+          "tenno::vector<long, numa_allocator> random reads over 64 MiB")
+{
+  RUN_BENCHMARK(
+    10, random_reads<tenno::vector<long, tenno::numa_allocator<long>>>(
+          1000000));
+}
+
+struct request_node
+{
+  long id;
+  long parent;
+};
+
+// A request builds a few vectors and shared objects, then drops them
+// all together
+template <class Alloc> static long handle_request(const Alloc &alloc)
+{
+  using vec_t = tenno::vector<long, Alloc>;
+  long sum = 0;
+  for (long v = 0; v < 8; v++)
+  {
+    vec_t vec(alloc);
+    for (long i = 0; i < 64; i++)
+    {
+      vec.push_back(i * v);
+    }
+    sum += vec[63];
+  }
+  for (long i = 0; i < 32; i++)
+  {
+    auto node = tenno::allocate_shared<request_node>(alloc, i, i - 1);
+    sum += node->parent;
+  }
+  return sum;
+}
+
+BENCHMARK(benchmark_allocator_requests, "1000 requests with tenno::allocator")
+{
+  RUN_BENCHMARK(10,
+                [&]()
+                {
+                  for (int r = 0; r < 1000; r++)
+                  {
+                    handle_request(tenno::allocator<long>());
+                  }
+                }());
+}
+
+BENCHMARK(benchmark_arena_allocator_requests,
+          "1000 requests with tenno::arena_allocator")
+{
+  alignas(16) static char buffer[16 * 1024];
+  RUN_BENCHMARK(10,
+                [&]()
+                {
+                  for (int r = 0; r < 1000; r++)
+                  {
+                    tenno::monotonic_arena arena(buffer, sizeof(buffer));
+                    handle_request(tenno::arena_allocator<long>(arena));
+                  }
+                }());
+}
+
+static volatile float simd_sink;
+
+// Sum a buffer in 64 byte steps. With an aligned buffer the compiler
+// is told so and emits aligned vector loads, otherwise it has to use
+// unaligned loads.
+template <bool Aligned, class Vec> static void sum_floats(Vec &vec)
+{
+  const float *data = vec.data().value();
+  if constexpr (Aligned)
+  {
+    data = static_cast<const float *>(__builtin_assume_aligned(data, 64));
+  }
+  float lanes[16] = {};
+  for (tenno::size i = 0; i + 16 <= vec.size(); i += 16)
+  {
+    for (tenno::size j = 0; j < 16; j++)
+    {
+      lanes[j] += data[i + j];
+    }
+  }
+  float sum = 0;
+  for (float lane : lanes)
+  {
+    sum += lane;
+  }
+  simd_sink = sum;
+}
+
+BENCHMARK(benchmark_allocator_sum_floats,
+          "sum 1M floats, tenno::allocator buffer")
+{
+  tenno::vector<float> vec(1024 * 1024, 1.0f);
+  RUN_BENCHMARK(10, sum_floats<false>(vec));
+}
+
+BENCHMARK(benchmark_aligned_allocator_sum_floats,
+          "sum 1M floats, tenno::aligned_allocator<float, 64> buffer")
+{
+  tenno::vector<float, tenno::aligned_allocator<float, 64>> vec(1024 * 1024,
+                                                                1.0f);
+  RUN_BENCHMARK(10, sum_floats<true>(vec));
+}
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <valfuzz/valfuzz.hpp>
+
+// meet the two fighters:
+#include <tenno/concurrent_vector.hpp>
+#include <tenno/mutex.hpp>
+#include <tenno/thread.hpp>
+#include <tenno/vector.hpp>
+
+static const int num_threads = 32;
+static const int per_thread  = 10000;
+
+static void collect_concurrent_vector()
+{
+  tenno::concurrent_vector<long> results;
+  tenno::vector<tenno::jthread> threads;
+  for (int t = 0; t < num_threads; t++)
+  {
+    threads.emplace_back(
+      [&results]()
+      {
+        for (long i = 0; i < per_thread; i++)
+        {
+          results.push_back(i);
+        }
+      });
+  }
+}
+
+static void collect_locked_vector()
+{
+  tenno::vector<long> results;
+  tenno::mutex results_mutex;
+  tenno::vector<tenno::jthread> threads;
+  for (int t = 0; t < num_threads; t++)
+  {
+    threads.emplace_back(
+      [&results, &results_mutex]()
+      {
+        for (long i = 0; i < per_thread; i++)
+        {
+          tenno::lock_guard<tenno::mutex> lock(results_mutex);
+          results.push_back(i);
+        }
+      });
+  }
+}
+
+BENCHMARK(benchmark_tenno_concurrent_vector_push_back,
+          "tenno::concurrent_vector push_back from 32 threads")
+{
+  RUN_BENCHMARK(1, collect_concurrent_vector());
+}
+
+BENCHMARK(benchmark_tenno_locked_vector_push_back,
+          "tenno::vector + tenno::mutex push_back from 32 threads")
+{
+  RUN_BENCHMARK(1, collect_locked_vector());
+}
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <valfuzz/valfuzz.hpp>
+
+// meet the two fighters:
+#include <memory>
+#include <tenno/local_shared_ptr.hpp>
+#include <tenno/memory.hpp>
+#include <tenno/vector.hpp>
+
+static const long graph_nodes = 20000;
+static const long graph_edges = 4;
+
+template <template <class> class Ptr> struct graph_node
+{
+  long value;
+  long visited;
+  tenno::vector<Ptr<graph_node>> edges;
+};
+
+template <class T> using tenno_shared = tenno::shared_ptr<T>;
+template <class T> using tenno_local  = tenno::local_shared_ptr<T>;
+template <class T> using std_shared   = std::shared_ptr<T>;
+
+// A DAG where every node points to a few nodes after it, so the
+// reference counts never form a cycle
+template <template <class> class Ptr, class Make>
+static tenno::vector<Ptr<graph_node<Ptr>>> &graph(Make make)
+{
+  static tenno::vector<Ptr<graph_node<Ptr>>> nodes;
+  if (nodes.empty())
+  {
+    for (long i = 0; i < graph_nodes; i++)
+    {
+      nodes.push_back(make());
+      nodes[(tenno::size) i]->value = i;
+    }
+    for (long i = 0; i < graph_nodes; i++)
+    {
+      for (long e = 1; e <= graph_edges; e++)
+      {
+        long to = i + (e * 7919 + i) % 97 + 1;
+        if (to < graph_nodes)
+        {
+          nodes[(tenno::size) i]->edges.push_back(nodes[(tenno::size) to]);
+        }
+      }
+    }
+  }
+  return nodes;
+}
+
+// Depth first traversal that copies every pointer it follows
+template <template <class> class Ptr, class Make>
+static long traverse(Make make, long round)
+{
+  auto &nodes = graph<Ptr>(make);
+  tenno::vector<Ptr<graph_node<Ptr>>> stack;
+  stack.push_back(nodes[0]);
+  long sum = 0;
+  while (!stack.empty())
+  {
+    Ptr<graph_node<Ptr>> node = stack[stack.size() - 1];
+    stack.pop_back();
+    if (node->visited == round)
+    {
+      continue;
+    }
+    node->visited = round;
+    sum += node->value;
+    for (const auto &next : node->edges)
+    {
+      stack.push_back(next);
+    }
+  }
+  return sum;
+}
+
+BENCHMARK(benchmark_tenno_local_shared_ptr_graph,
+          "tenno::local_shared_ptr graph traversal")
+{
+  long round = 0;
+  RUN_BENCHMARK(10, traverse<tenno_local>(
+                      []()
+                      {
+                        return tenno::make_local_shared<
+                          graph_node<tenno_local>>();
+                      },
+                      ++round));
+}
+
+BENCHMARK(benchmark_tenno_shared_ptr_graph, "tenno::shared_ptr graph traversal")
+{
+  long round = 0;
+  RUN_BENCHMARK(10, traverse<tenno_shared>(
+                      []()
+                      { return tenno::make_shared<graph_node<tenno_shared>>(); },
+                      ++round));
+}
+
+BENCHMARK(benchmark_std_shared_ptr_graph, "std::shared_ptr graph traversal")
+{
+  long round = 0;
+  RUN_BENCHMARK(10, traverse<std_shared>(
+                      []()
+                      { return std::make_shared<graph_node<std_shared>>(); },
+                      ++round));
+}
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <valfuzz/valfuzz.hpp>
+
+// meet the two fighters:
+#include <tenno/memory_resource.hpp>
+#include <tenno/vector.hpp>
+
+static volatile long vector_sink;
+
+// Many short lived small vectors, the same code runs on any resource
+static long small_vectors(tenno::memory_resource *resource)
+{
+  long sum = 0;
+  for (long v = 0; v < 1000; v++)
+  {
+    tenno::pmr::vector<long> vec{
+      tenno::pmr::polymorphic_allocator<long>(resource)};
+    for (long i = 0; i < 16; i++)
+    {
+      vec.push_back(i + v);
+    }
+    sum += vec[15];
+  }
+  vector_sink = sum;
+  return sum;
+}
+
+static long small_vectors_default()
+{
+  long sum = 0;
+  for (long v = 0; v < 1000; v++)
+  {
+    tenno::vector<long> vec;
+    for (long i = 0; i < 16; i++)
+    {
+      vec.push_back(i + v);
+    }
+    sum += vec[15];
+  }
+  vector_sink = sum;
+  return sum;
+}
+
+BENCHMARK(benchmark_small_vectors_tenno_allocator,
+          "small vectors tenno::allocator")
+{
+  RUN_BENCHMARK(100, small_vectors_default());
+}
+
+BENCHMARK(benchmark_small_vectors_new_delete_resource,
+          "small vectors pmr new_delete_resource")
+{
+  RUN_BENCHMARK(100, small_vectors(tenno::pmr::new_delete_resource()));
+}
+
+BENCHMARK(benchmark_small_vectors_pool_resource,
+          "small vectors pmr unsynchronized_pool_resource")
+{
+  tenno::pmr::unsynchronized_pool_resource pool;
+  RUN_BENCHMARK(100, small_vectors(&pool));
+}
+
+BENCHMARK(benchmark_small_vectors_monotonic_resource,
+          "small vectors pmr monotonic_buffer_resource")
+{
+  alignas(16) static char buffer[64 * 1024];
+  RUN_BENCHMARK(100,
+                [&]()
+                {
+                  tenno::pmr::monotonic_buffer_resource arena(
+                    buffer, sizeof(buffer));
+                  small_vectors(&arena);
+                }());
+}
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <valfuzz/valfuzz.hpp>
+
+// meet the two fighters:
+#include <memory>
+#include <tenno/memory.hpp>
+#include <tenno/object_pool.hpp>
+#include <tenno/thread.hpp>
+#include <tenno/vector.hpp>
+
+static const int per_thread = 100000;
+static const int window     = 64;
+
+// A 64 byte message
+struct message
+{
+  long id;
+  char payload[56];
+
+  message(long i) : id(i), payload{}
+  {
+  }
+};
+
+// Every thread creates messages and drops them, keeping a small window
+// of them alive
+template <class Ptr, class Make> static void churn(int num_threads, Make make)
+{
+  tenno::vector<tenno::jthread> threads;
+  for (int t = 0; t < num_threads; t++)
+  {
+    threads.emplace_back(
+      [&make]()
+      {
+        tenno::vector<Ptr> live(window);
+        for (long i = 0; i < per_thread / window; i++)
+        {
+          for (int j = 0; j < window; j++)
+          {
+            live[(tenno::size) j] = make(i);
+          }
+        }
+      });
+  }
+}
+
+using pool = tenno::object_pool<message>;
+
+BENCHMARK(benchmark_make_unique_new_1, "tenno::make_unique message 1 thread")
+{
+  RUN_BENCHMARK(1, churn<tenno::unique_ptr<message>>(
+                     1, [](long i) { return tenno::make_unique<message>(i); }));
+}
+
+BENCHMARK(benchmark_make_unique_pool_1,
+          "tenno::object_pool::make_unique message 1 thread")
+{
+  RUN_BENCHMARK(1, churn<pool::unique_ptr>(
+                     1, [](long i) { return pool::make_unique(i); }));
+}
+
+BENCHMARK(benchmark_make_unique_new_8, "tenno::make_unique message 8 threads")
+{
+  RUN_BENCHMARK(1, churn<tenno::unique_ptr<message>>(
+                     8, [](long i) { return tenno::make_unique<message>(i); }));
+}
+
+BENCHMARK(benchmark_make_unique_pool_8,
+          "tenno::object_pool::make_unique message 8 threads")
+{
+  RUN_BENCHMARK(1, churn<pool::unique_ptr>(
+                     8, [](long i) { return pool::make_unique(i); }));
+}
+
+BENCHMARK(benchmark_std_make_unique_8, "std::make_unique message 8 threads")
+{
+  RUN_BENCHMARK(1, churn<std::unique_ptr<message>>(
+                     8, [](long i) { return std::make_unique<message>(i); }));
+}
+
+BENCHMARK(benchmark_make_shared_new_8, "tenno::make_shared message 8 threads")
+{
+  RUN_BENCHMARK(1, churn<tenno::shared_ptr<message>>(
+                     8, [](long i) { return tenno::make_shared<message>(i); }));
+}
+
+BENCHMARK(benchmark_make_shared_pool_8,
+          "tenno::object_pool::make_shared message 8 threads")
+{
+  RUN_BENCHMARK(1, churn<pool::shared_ptr>(
+                     8, [](long i) { return pool::make_shared(i); }));
+}
@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <valfuzz/valfuzz.hpp>
+
+// meet the two fighters:
+#include <tenno/ebr.hpp>
+#include <tenno/hazard_pointer.hpp>
+#include <tenno/memory.hpp>
+#include <tenno/thread.hpp>
+#include <tenno/vector.hpp>
+
+static const int num_readers = 8;
+static const int per_reader  = 100000;
+static const int num_updates = 1000;
+
+struct config
+{
+  long a;
+  long b;
+};
+
+// Readers read a configuration published through a pointer while one
+// writer keeps replacing it
+template <class Read, class Update>
+static void read_mostly(Read read, Update update)
+{
+  tenno::vector<tenno::jthread> threads;
+  for (int t = 0; t < num_readers; t++)
+  {
+    threads.emplace_back(
+      [&read]()
+      {
+        long sum = 0;
+        for (int i = 0; i < per_reader; i++)
+        {
+          sum += read();
+        }
+        (void) sum;
+      });
+  }
+  threads.emplace_back(
+    [&update]()
+    {
+      for (long i = 0; i < num_updates; i++)
+      {
+        update(i);
+      }
+    });
+}
+
+struct bench_tag;
+
+BENCHMARK(benchmark_hazard_pointer_read_mostly,
+          "tenno::hazard_pointer 8 readers, 1 writer")
+{
+  using domain = tenno::hazard_domain<bench_tag>;
+  config *current = new config{0, 0};
+  RUN_BENCHMARK(1, read_mostly(
+                     [&current]()
+                     {
+                       tenno::hazard_pointer<bench_tag> hp;
+                       config *c = hp.protect(current);
+                       return c->a + c->b;
+                     },
+                     [&current](long i)
+                     {
+                       config *old = __atomic_exchange_n(
+                         &current, new config{i, i}, __ATOMIC_ACQ_REL);
+                       domain::retire(old);
+                     }));
+  domain::retire(current);
+  domain::cleanup();
+}
+
+BENCHMARK(benchmark_ebr_read_mostly, "tenno::ebr_domain 8 readers, 1 writer")
+{
+  using domain = tenno::ebr_domain<bench_tag>;
+  config *current = new config{0, 0};
+  RUN_BENCHMARK(1, read_mostly(
+                     [&current]()
+                     {
+                       domain::guard g;
+                       config *c = __atomic_load_n(&current, __ATOMIC_ACQUIRE);
+                       return c->a + c->b;
+                     },
+                     [&current](long i)
+                     {
+                       config *old = __atomic_exchange_n(
+                         &current, new config{i, i}, __ATOMIC_ACQ_REL);
+                       domain::retire(old);
+                     }));
+  domain::retire(current);
+  domain::cleanup();
+}
+
+BENCHMARK(benchmark_atomic_shared_ptr_read_mostly,
+          "tenno::atomic<shared_ptr> 8 readers, 1 writer")
+{
+  tenno::atomic<tenno::shared_ptr<config>> current(
+    tenno::make_shared<config>(0, 0));
+  RUN_BENCHMARK(1, read_mostly(
+                     [&current]()
+                     {
+                       auto c = current.load();
+                       return c->a + c->b;
+                     },
+                     [&current](long i)
+                     { current.store(tenno::make_shared<config>(i, i)); }));
+}
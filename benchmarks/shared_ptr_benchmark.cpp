@@ -0,0 +1,237 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <valfuzz/valfuzz.hpp>
+
+// meet the two fighters:
+#include <atomic>
+#include <memory>
+#include <tenno/atomic.hpp>
+#include <tenno/intrusive_ptr.hpp>
+#include <tenno/memory.hpp>
+#include <tenno/mutex.hpp>
+#include <tenno/thread.hpp>
+#include <tenno/vector.hpp>
+
+static const int num_threads = 8;
+static const int per_thread  = 100000;
+
+// Every thread copies and destroys the same pointer, so they all hit
+// the same reference count
+template <class Ptr> static void copy_destroy(const Ptr &ptr)
+{
+  tenno::vector<tenno::jthread> threads;
+  for (int t = 0; t < num_threads; t++)
+  {
+    threads.emplace_back(
+      [&ptr]()
+      {
+        for (int i = 0; i < per_thread; i++)
+        {
+          Ptr copy = ptr;
+          (void) copy;
+        }
+      });
+  }
+}
+
+template <class Weak> static void lock_release(const Weak &weak)
+{
+  tenno::vector<tenno::jthread> threads;
+  for (int t = 0; t < num_threads; t++)
+  {
+    threads.emplace_back(
+      [&weak]()
+      {
+        for (int i = 0; i < per_thread; i++)
+        {
+          auto locked = weak.lock();
+          (void) locked;
+        }
+      });
+  }
+}
+
+BENCHMARK(benchmark_tenno_shared_ptr_copy_threads,
+          "tenno::shared_ptr copy/destroy from 8 threads")
+{
+  auto ptr = tenno::shared_ptr<int>(new int(42));
+  RUN_BENCHMARK(1, copy_destroy(ptr));
+}
+
+BENCHMARK(benchmark_std_shared_ptr_copy_threads,
+          "std::shared_ptr copy/destroy from 8 threads")
+{
+  auto ptr = std::make_shared<int>(42);
+  RUN_BENCHMARK(1, copy_destroy(ptr));
+}
+
+struct counted_int : tenno::intrusive_ref_counter<counted_int>
+{
+  int value = 42;
+};
+
+BENCHMARK(benchmark_tenno_intrusive_ptr_copy_threads,
+          "tenno::intrusive_ptr copy/destroy from 8 threads")
+{
+  auto ptr = tenno::make_intrusive<counted_int>();
+  RUN_BENCHMARK(1, copy_destroy(ptr));
+}
+
+BENCHMARK(benchmark_tenno_weak_ptr_lock_threads,
+          "tenno::weak_ptr lock from 8 threads")
+{
+  auto ptr = tenno::shared_ptr<int>(new int(42));
+  tenno::weak_ptr<int> weak(ptr);
+  RUN_BENCHMARK(1, lock_release(weak));
+}
+
+BENCHMARK(benchmark_std_weak_ptr_lock_threads,
+          "std::weak_ptr lock from 8 threads")
+{
+  auto ptr = std::make_shared<int>(42);
+  std::weak_ptr<int> weak(ptr);
+  RUN_BENCHMARK(1, lock_release(weak));
+}
+
+struct small_node
+{
+  long key;
+  long value;
+};
+
+template <class Ptr, class Make> static void make_nodes(Make make)
+{
+  tenno::vector<Ptr> nodes;
+  nodes.reserve(10000);
+  for (long i = 0; i < 10000; i++)
+  {
+    nodes.push_back(make(i));
+  }
+  long sum = 0;
+  for (const auto &node : nodes)
+  {
+    sum += node->value;
+  }
+  (void) sum;
+}
+
+BENCHMARK(benchmark_tenno_make_shared_nodes, "tenno::make_shared small nodes")
+{
+  RUN_BENCHMARK(10, make_nodes<tenno::shared_ptr<small_node>>(
+                      [](long i)
+                      { return tenno::make_shared<small_node>(i, i * 2); }));
+}
+
+BENCHMARK(benchmark_std_make_shared_nodes, "std::make_shared small nodes")
+{
+  RUN_BENCHMARK(10, make_nodes<std::shared_ptr<small_node>>(
+                      [](long i)
+                      { return std::make_shared<small_node>(i, i * 2); }));
+}
+
+struct intrusive_node : tenno::intrusive_ref_counter<intrusive_node>
+{
+  long key;
+  long value;
+
+  intrusive_node(long k, long v) : key(k), value(v)
+  {
+  }
+};
+
+BENCHMARK(benchmark_tenno_make_intrusive_nodes,
+          "tenno::make_intrusive small nodes")
+{
+  RUN_BENCHMARK(10, make_nodes<tenno::intrusive_ptr<intrusive_node>>(
+                      [](long i) {
+                        return tenno::make_intrusive<intrusive_node>(i, i * 2);
+                      }));
+}
+
+// Readers take a snapshot of a configuration published through a
+// shared pointer
+template <class Load> static void read_snapshots(Load load)
+{
+  tenno::vector<tenno::jthread> threads;
+  for (int t = 0; t < num_threads; t++)
+  {
+    threads.emplace_back(
+      [&load]()
+      {
+        long sum = 0;
+        for (int i = 0; i < per_thread; i++)
+        {
+          auto snapshot = load();
+          sum += *snapshot;
+        }
+        (void) sum;
+      });
+  }
+}
+
+BENCHMARK(benchmark_tenno_atomic_shared_ptr_load,
+          "tenno::atomic<shared_ptr> load from 8 threads")
+{
+  tenno::atomic<tenno::shared_ptr<int>> config(tenno::make_shared<int>(42));
+  RUN_BENCHMARK(1, read_snapshots([&config]() { return config.load(); }));
+}
+
+BENCHMARK(benchmark_tenno_mutex_shared_ptr_load,
+          "mutex + tenno::shared_ptr load from 8 threads")
+{
+  tenno::mutex lock;
+  auto config = tenno::make_shared<int>(42);
+  RUN_BENCHMARK(1, read_snapshots(
+                     [&lock, &config]()
+                     {
+                       tenno::lock_guard<tenno::mutex> guard(lock);
+                       return config;
+                     }));
+}
+
+BENCHMARK(benchmark_std_atomic_shared_ptr_load,
+          "std::atomic<std::shared_ptr> load from 8 threads")
+{
+  std::atomic<std::shared_ptr<int>> config(std::make_shared<int>(42));
+  RUN_BENCHMARK(1, read_snapshots([&config]() { return config.load(); }));
+}
+
+static volatile long dereference_sink;
+
+// Dereference many shared pointers, the hot path of read heavy code
+template <class Ptr> static void dereference(const tenno::vector<Ptr> &ptrs)
+{
+  long sum = 0;
+  for (int round = 0; round < 10; round++)
+  {
+    for (const auto &ptr : ptrs)
+    {
+      sum += ptr->value;
+    }
+  }
+  dereference_sink = sum;
+}
+
+BENCHMARK(benchmark_tenno_shared_ptr_dereference,
+          "tenno::shared_ptr dereference")
+{
+  tenno::vector<tenno::shared_ptr<small_node>> ptrs;
+  for (long i = 0; i < 10000; i++)
+  {
+    ptrs.push_back(tenno::make_shared<small_node>(i, i));
+  }
+  RUN_BENCHMARK(10, dereference(ptrs));
+}
+
+BENCHMARK(benchmark_std_shared_ptr_dereference, "std::shared_ptr dereference")
+{
+  tenno::vector<std::shared_ptr<small_node>> ptrs;
+  for (long i = 0; i < 10000; i++)
+  {
+    ptrs.push_back(std::make_shared<small_node>(i, i));
+  }
+  RUN_BENCHMARK(10, dereference(ptrs));
+}
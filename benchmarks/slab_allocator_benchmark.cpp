@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <valfuzz/valfuzz.hpp>
+
+// meet the two fighters:
+#include <tenno/memory.hpp>
+#include <tenno/slab_allocator.hpp>
+#include <tenno/thread.hpp>
+#include <tenno/vector.hpp>
+
+static const int per_thread = 100000;
+static const int window     = 64;
+
+struct shared_object
+{
+  long key;
+  long value;
+};
+
+// Every thread creates shared objects and drops them, keeping a small
+// window of them alive
+template <class Alloc> static void churn(int num_threads)
+{
+  tenno::vector<tenno::jthread> threads;
+  for (int t = 0; t < num_threads; t++)
+  {
+    threads.emplace_back(
+      []()
+      {
+        tenno::vector<tenno::shared_ptr<shared_object>> live(window);
+        for (int i = 0; i < per_thread / window; i++)
+        {
+          for (int j = 0; j < window; j++)
+          {
+            live[(tenno::size) j] =
+              tenno::allocate_shared<shared_object>(Alloc(), i, j);
+          }
+        }
+      });
+  }
+}
+
+// The control block is allocated separately from the object
+template <class Alloc> static void churn_control_blocks(int num_threads)
+{
+  using ptr_t = tenno::shared_ptr<shared_object,
+                                  tenno::default_delete<shared_object>, Alloc>;
+  tenno::vector<tenno::jthread> threads;
+  for (int t = 0; t < num_threads; t++)
+  {
+    threads.emplace_back(
+      []()
+      {
+        for (int i = 0; i < per_thread; i++)
+        {
+          ptr_t sp(new shared_object{i, i},
+                   tenno::default_delete<shared_object>(), Alloc());
+          (void) sp;
+        }
+      });
+  }
+}
+
+using default_alloc = tenno::allocator<shared_object>;
+using slab_alloc    = tenno::slab_allocator<shared_object>;
+
+BENCHMARK(benchmark_allocate_shared_default_1,
+          "allocate_shared tenno::allocator 1 thread")
+{
+  RUN_BENCHMARK(1, churn<default_alloc>(1));
+}
+
+BENCHMARK(benchmark_allocate_shared_slab_1,
+          "allocate_shared tenno::slab_allocator 1 thread")
+{
+  RUN_BENCHMARK(1, churn<slab_alloc>(1));
+}
+
+BENCHMARK(benchmark_allocate_shared_default_8,
+          "allocate_shared tenno::allocator 8 threads")
+{
+  RUN_BENCHMARK(1, churn<default_alloc>(8));
+}
+
+BENCHMARK(benchmark_allocate_shared_slab_8,
+          "allocate_shared tenno::slab_allocator 8 threads")
+{
+  RUN_BENCHMARK(1, churn<slab_alloc>(8));
+}
+
+BENCHMARK(benchmark_allocate_shared_default_32,
+          "allocate_shared tenno::allocator 32 threads")
+{
+  RUN_BENCHMARK(1, churn<default_alloc>(32));
+}
+
+BENCHMARK(benchmark_allocate_shared_slab_32,
+          "allocate_shared tenno::slab_allocator 32 threads")
+{
+  RUN_BENCHMARK(1, churn<slab_alloc>(32));
+}
+
+BENCHMARK(benchmark_control_block_default_8,
+          "shared_ptr control block tenno::allocator 8 threads")
+{
+  RUN_BENCHMARK(1, churn_control_blocks<default_alloc>(8));
+}
+
+BENCHMARK(benchmark_control_block_slab_8,
+          "shared_ptr control block tenno::slab_allocator 8 threads")
+{
+  RUN_BENCHMARK(1, churn_control_blocks<slab_alloc>(8));
+}
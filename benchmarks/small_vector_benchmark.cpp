@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <valfuzz/valfuzz.hpp>
+
+// meet the two fighters:
+#include <tenno/small_vector.hpp>
+#include <tenno/vector.hpp>
+
+template <class Vec> static int fill_and_sum(int n)
+{
+  Vec vec;
+  for (int i = 0; i < n; ++i)
+  {
+    vec.push_back(i);
+  }
+  int sum = 0;
+  for (auto it = vec.begin(); it != vec.end(); ++it)
+  {
+    sum += *it;
+  }
+  return sum;
+}
+
+BENCHMARK(benchmark_tenno_small_vector_short_lived,
+          "tenno::small_vector<int, 16> 12 elements")
+{
+  RUN_BENCHMARK(100000, fill_and_sum<tenno::small_vector<int, 16>>(12));
+}
+
+BENCHMARK(benchmark_tenno_vector_short_lived, "tenno::vector<int> 12 elements")
+{
+  RUN_BENCHMARK(100000, fill_and_sum<tenno::vector<int>>(12));
+}
+
+BENCHMARK(benchmark_tenno_small_vector_spill,
+          "tenno::small_vector<int, 16> 64 elements")
+{
+  RUN_BENCHMARK(100000, fill_and_sum<tenno::small_vector<int, 16>>(64));
+}
+
+BENCHMARK(benchmark_tenno_vector_spill, "tenno::vector<int> 64 elements")
+{
+  RUN_BENCHMARK(100000, fill_and_sum<tenno::vector<int>>(64));
+}
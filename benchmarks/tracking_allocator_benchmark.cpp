@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <valfuzz/valfuzz.hpp>
+
+// meet the two fighters:
+#include <tenno/instrumented_allocator.hpp>
+#include <tenno/memory.hpp>
+#include <tenno/thread.hpp>
+#include <tenno/tracking_allocator.hpp>
+#include <tenno/vector.hpp>
+
+static const int per_thread = 100000;
+
+static volatile long sink;
+
+struct benchmark_tag
+{
+};
+
+static tenno::allocation_tracker benchmark_memory("benchmark");
+
+// Every thread allocates and frees small blocks, the cost of the
+// allocator is dominated by the bookkeeping
+template <class Alloc> static void churn(int num_threads, Alloc alloc)
+{
+  tenno::vector<tenno::jthread> threads;
+  for (int t = 0; t < num_threads; t++)
+  {
+    threads.emplace_back(
+      [alloc]() mutable
+      {
+        for (int i = 0; i < per_thread; i++)
+        {
+          long *p = alloc.allocate(4);
+          p[0]    = i;
+          sink    = p[0];
+          alloc.deallocate(p, 4);
+        }
+      });
+  }
+}
+
+BENCHMARK(benchmark_allocator_1, "tenno::allocator churn 1 thread")
+{
+  RUN_BENCHMARK(1, churn(1, tenno::allocator<long>()));
+}
+
+BENCHMARK(benchmark_instrumented_allocator_1,
+          "tenno::instrumented_allocator churn 1 thread")
+{
+  RUN_BENCHMARK(
+    1, churn(1, tenno::instrumented_allocator<long, benchmark_tag>()));
+}
+
+BENCHMARK(benchmark_tracking_allocator_1,
+          "tenno::tracking_allocator churn 1 thread")
+{
+  RUN_BENCHMARK(
+    1, churn(1, tenno::tracking_allocator<long>(benchmark_memory)));
+}
+
+BENCHMARK(benchmark_allocator_8, "tenno::allocator churn 8 threads")
+{
+  RUN_BENCHMARK(1, churn(8, tenno::allocator<long>()));
+}
+
+BENCHMARK(benchmark_instrumented_allocator_8,
+          "tenno::instrumented_allocator churn 8 threads")
+{
+  RUN_BENCHMARK(
+    1, churn(8, tenno::instrumented_allocator<long, benchmark_tag>()));
+}
+
+BENCHMARK(benchmark_tracking_allocator_8,
+          "tenno::tracking_allocator churn 8 threads")
+{
+  RUN_BENCHMARK(
+    1, churn(8, tenno::tracking_allocator<long>(benchmark_memory)));
+}
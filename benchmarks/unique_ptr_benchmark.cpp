@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <valfuzz/valfuzz.hpp>
+
+// meet the two fighters:
+#include <cstring>
+#include <memory>
+#include <tenno/memory.hpp>
+#include <tenno/vector.hpp>
+
+// One million owning pointers, the smaller the pointer the fewer cache
+// lines a walk over them touches
+constexpr long num_ptrs = 1000000;
+
+static volatile long footprint_sink;
+
+struct stateful_delete
+{
+  long calls = 0;
+
+  void operator()(long *p) noexcept
+  {
+    calls++;
+    delete p;
+  }
+};
+
+template <class Ptr> static tenno::vector<Ptr> &pointers()
+{
+  static tenno::vector<Ptr> ptrs = []()
+  {
+    tenno::vector<Ptr> v;
+    v.reserve(num_ptrs);
+    for (long i = 0; i < num_ptrs; i++)
+    {
+      v.push_back(Ptr(new long(i)));
+    }
+    return v;
+  }();
+  return ptrs;
+}
+
+// Only the pointers are read, not the objects, so the walk measures
+// the footprint of the pointers themselves
+template <class Ptr> static void walk()
+{
+  long sum = 0;
+  for (const auto &ptr : pointers<Ptr>())
+  {
+    sum += (long) ((unsigned long) ptr.get() & 0xff);
+  }
+  footprint_sink = sum;
+}
+
+BENCHMARK(benchmark_tenno_unique_ptr_footprint,
+          "walk 1M tenno::unique_ptr<long>, 8 bytes each")
+{
+  pointers<tenno::unique_ptr<long>>();
+  RUN_BENCHMARK(10, walk<tenno::unique_ptr<long>>());
+}
+
+BENCHMARK(benchmark_std_unique_ptr_footprint,
+          "walk 1M std::unique_ptr<long>, 8 bytes each")
+{
+  pointers<std::unique_ptr<long>>();
+  RUN_BENCHMARK(10, walk<std::unique_ptr<long>>());
+}
+
+BENCHMARK(benchmark_tenno_unique_ptr_stateful_footprint,
+          "walk 1M tenno::unique_ptr<long, stateful>, 16 bytes each")
+{
+  pointers<tenno::unique_ptr<long, stateful_delete>>();
+  RUN_BENCHMARK(10, walk<tenno::unique_ptr<long, stateful_delete>>());
+}
+
+static volatile tenno::size block_sink;
+
+// Shared pointers with a separate control block, the block no longer
+// carries the empty deleter and allocator
+BENCHMARK(benchmark_tenno_shared_ptr_control_blocks,
+          "tenno::shared_ptr 100K separate control blocks")
+{
+  RUN_BENCHMARK(10,
+                [&]()
+                {
+                  tenno::vector<tenno::shared_ptr<long>> ptrs;
+                  ptrs.reserve(100000);
+                  for (long i = 0; i < 100000; i++)
+                  {
+                    ptrs.push_back(tenno::shared_ptr<long>(new long(i)));
+                  }
+                  block_sink = ptrs.size();
+                }());
+}
+
+// A 4 MiB I/O buffer filled right after it is created, value
+// initialization writes every byte twice
+constexpr tenno::size buffer_size = 4 << 20;
+
+static volatile char buffer_sink;
+
+template <class Buffer> static void fill(Buffer buf)
+{
+  std::memset(buf.get(), 'x', buffer_size);
+  buffer_sink = buf[buffer_size - 1];
+}
+
+BENCHMARK(benchmark_tenno_make_unique_array,
+          "tenno::make_unique<char[]> 4 MiB, then filled")
+{
+  RUN_BENCHMARK(10, fill(tenno::make_unique<char[]>(buffer_size)));
+}
+
+BENCHMARK(benchmark_tenno_make_unique_for_overwrite,
+          "tenno::make_unique_for_overwrite<char[]> 4 MiB, then filled")
+{
+  RUN_BENCHMARK(10,
+                fill(tenno::make_unique_for_overwrite<char[]>(buffer_size)));
+}
+
+BENCHMARK(benchmark_std_make_unique_for_overwrite,
+          "std::make_unique_for_overwrite<char[]> 4 MiB, then filled")
+{
+  RUN_BENCHMARK(10, fill(std::make_unique_for_overwrite<char[]>(buffer_size)));
+}
@@ -0,0 +1,198 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <valfuzz/valfuzz.hpp>
+
+// meet the two fighters:
+#include <algorithm>
+#include <tenno/instrumented_allocator.hpp>
+#include <tenno/mmap_allocator.hpp>
+#include <tenno/vector.hpp>
+#include <vector>
+
+struct small_struct
+{
+  long id;
+  double x, y, z;
+};
+
+template <class Vec, class T> static void push_back_n(tenno::size n)
+{
+  Vec vec;
+  for (tenno::size i = 0; i < n; ++i)
+  {
+    vec.push_back(T());
+  }
+}
+
+BENCHMARK(benchmark_tenno_vector_push_back_int,
+          "tenno::vector<int>.push_back() growth")
+{
+  RUN_BENCHMARK(10, push_back_n<tenno::vector<int>, int>(100000));
+}
+
+BENCHMARK(benchmark_std_vector_push_back_int,
+          "std::vector<int>.push_back() growth")
+{
+  RUN_BENCHMARK(10, push_back_n<std::vector<int>, int>(100000));
+}
+
+BENCHMARK(benchmark_tenno_vector_push_back_struct,
+          "tenno::vector<small_struct>.push_back() growth")
+{
+  RUN_BENCHMARK(10,
+                push_back_n<tenno::vector<small_struct>, small_struct>(100000));
+}
+
+BENCHMARK(benchmark_std_vector_push_back_struct,
+          "std::vector<small_struct>.push_back() growth")
+{
+  RUN_BENCHMARK(10,
+                push_back_n<std::vector<small_struct>, small_struct>(100000));
+}
+
+BENCHMARK(benchmark_tenno_vector_push_back_mmap,
+          "tenno::vector<long, mmap_allocator>.push_back() growth")
+{
+  RUN_BENCHMARK(
+    10, push_back_n<tenno::vector<long, tenno::mmap_allocator<long>>, long>(
+          4000000));
+}
+
+BENCHMARK(benchmark_tenno_vector_push_back_large,
+          "tenno::vector<long>.push_back() growth")
+{
+  RUN_BENCHMARK(10, push_back_n<tenno::vector<long>, long>(4000000));
+}
+
+template <class Vec> static long sort_and_sum(tenno::size n)
+{
+  Vec vec(n);
+  for (tenno::size i = 0; i < n; ++i)
+  {
+    vec[i] = (long) ((i * 7919) % n);
+  }
+  std::sort(vec.begin(), vec.end());
+  long sum = 0;
+  for (long x : vec)
+  {
+    sum += x;
+  }
+  return sum;
+}
+
+BENCHMARK(benchmark_tenno_vector_sort, "std::sort(tenno::vector<long>)")
+{
+  RUN_BENCHMARK(10, sort_and_sum<tenno::vector<long>>(100000));
+}
+
+BENCHMARK(benchmark_std_vector_sort, "std::sort(std::vector<long>)")
+{
+  RUN_BENCHMARK(10, sort_and_sum<std::vector<long>>(100000));
+}
+
+static long input_buffer[4096];
+
+static void append_push_back(tenno::size n)
+{
+  tenno::vector<long> vec;
+  for (tenno::size i = 0; i < n; ++i)
+  {
+    for (long x : input_buffer)
+    {
+      vec.push_back(x);
+    }
+  }
+}
+
+static void append_range(tenno::size n)
+{
+  tenno::vector<long> vec;
+  for (tenno::size i = 0; i < n; ++i)
+  {
+    vec.append_range(input_buffer);
+  }
+}
+
+BENCHMARK(benchmark_tenno_vector_append_push_back,
+          "tenno::vector<long> ingest with push_back()")
+{
+  RUN_BENCHMARK(10, append_push_back(100));
+}
+
+BENCHMARK(benchmark_tenno_vector_append_range,
+          "tenno::vector<long> ingest with append_range()")
+{
+  RUN_BENCHMARK(10, append_range(100));
+}
+
+BENCHMARK(benchmark_tenno_vector_resize, "tenno::vector<char>.resize()")
+{
+  RUN_BENCHMARK(10, tenno::vector<char>().resize(1 << 22));
+}
+
+BENCHMARK(benchmark_tenno_vector_resize_for_overwrite,
+          "tenno::vector<char>.resize_for_overwrite()")
+{
+  RUN_BENCHMARK(10, tenno::vector<char>().resize_for_overwrite(1 << 22));
+}
+
+// Report the allocation counters next to the timings
+template <class Policy> struct growth_site
+{
+};
+
+template <class Policy> static void instrumented_push_back(tenno::size n)
+{
+  using alloc = tenno::instrumented_allocator<long, growth_site<Policy>>;
+  push_back_n<tenno::vector<long, alloc, Policy>, long>(n);
+}
+
+BENCHMARK(benchmark_tenno_vector_instrumented_factor_2,
+          "tenno::vector<long, instrumented, growth_factor_2>.push_back()")
+{
+  using site = growth_site<tenno::growth_factor_2>;
+  tenno::allocation_counters<site>::reset();
+  RUN_BENCHMARK(10, instrumented_push_back<tenno::growth_factor_2>(1000000));
+  tenno::allocation_counters<site>::snapshot().print("  counters");
+}
+
+BENCHMARK(benchmark_tenno_vector_instrumented_factor_1_5,
+          "tenno::vector<long, instrumented, growth_factor_1_5>.push_back()")
+{
+  using site = growth_site<tenno::growth_factor_1_5>;
+  tenno::allocation_counters<site>::reset();
+  RUN_BENCHMARK(10, instrumented_push_back<tenno::growth_factor_1_5>(1000000));
+  tenno::allocation_counters<site>::snapshot().print("  counters");
+}
+
+// Drop about half of a million elements
+template <class Vec> static tenno::size filter_expired(tenno::size n)
+{
+  Vec vec(n);
+  for (tenno::size i = 0; i < n; ++i)
+  {
+    vec[i] = (long) ((i * 7919) % 1000);
+  }
+  auto expired = [](long x) { return x < 500; };
+  if constexpr (std::is_same_v<Vec, std::vector<long>>)
+  {
+    return std::erase_if(vec, expired);
+  }
+  else
+  {
+    return tenno::erase_if(vec, expired);
+  }
+}
+
+BENCHMARK(benchmark_tenno_vector_erase_if, "tenno::erase_if(tenno::vector<long>)")
+{
+  RUN_BENCHMARK(10, filter_expired<tenno::vector<long>>(1000000));
+}
+
+BENCHMARK(benchmark_std_vector_erase_if, "std::erase_if(std::vector<long>)")
+{
+  RUN_BENCHMARK(10, filter_expired<std::vector<long>>(1000000));
+}
@@ -5,8 +5,12 @@
 
 #pragma once
 
+#include <cstring>    // std::memmove
 #include <functional> // std::function
+#include <iterator>   // std::contiguous_iterator
+#include <memory>     // std::to_address
 #include <tenno/utility.hpp>
+#include <type_traits>
 
 namespace tenno
 {
@@ -24,10 +28,36 @@ namespace tenno
  * to copy.
  * @param d_first The iterator to the first element in the range to copy to.
  * @return OutputIt The iterator to the element after the last element copied.
+ *
+ * @note If both ranges are contiguous and hold the same trivially
+ * copyable type, the elements are copied with a single memmove.
  */
 template <typename InputIt, typename OutputIt>
 constexpr OutputIt copy(InputIt first, InputIt last, OutputIt d_first)
 {
+  if constexpr (std::contiguous_iterator<InputIt>
+                && std::contiguous_iterator<OutputIt>)
+  {
+    using in_t  = std::iter_value_t<InputIt>;
+    using out_t = std::iter_value_t<OutputIt>;
+    if constexpr (std::is_same_v<in_t, out_t>
+                  && std::is_trivially_copyable_v<in_t>
+                  && !std::is_const_v<
+                       std::remove_reference_t<std::iter_reference_t<OutputIt>>>)
+    {
+      if (!std::is_constant_evaluated())
+      {
+        auto count = last - first;
+        if (count > 0)
+        {
+          std::memmove(std::to_address(d_first), std::to_address(first),
+                       (size_t) count * sizeof(in_t));
+        }
+        return d_first + count;
+      }
+    }
+  }
+
   while (first != last)
   {
     //        *d_first++ = *first++;
@@ -90,6 +120,80 @@ constexpr T accumulate(InputIt first, InputIt last, T init) noexcept
   return init;
 }
 
+/**
+ * @brief Removes the elements for which p returns true from the range
+ * [first, last), keeping the order of the others.
+ *
+ * Every remaining element is moved at most once. The elements past the
+ * returned iterator are left in a valid but unspecified state.
+ *
+ * @tparam ForwardIt The type of the iterators of the range.
+ * @tparam UnaryPred The type of the predicate.
+ * @param first The iterator to the first element in the range.
+ * @param last The iterator to the element after the last element in the
+ * range.
+ * @param p The predicate, returns true for the elements to remove.
+ * @return ForwardIt The iterator past the last remaining element.
+ *
+ * @note For contiguous ranges of trivially copyable elements every
+ * element is written to the output position, which advances only past
+ * the kept ones, so the loop has no data dependent branches.
+ */
+template <class ForwardIt, class UnaryPred>
+constexpr ForwardIt remove_if(ForwardIt first, ForwardIt last, UnaryPred p)
+{
+  if constexpr (std::contiguous_iterator<ForwardIt>
+                && std::is_trivially_copyable_v<std::iter_value_t<ForwardIt>>)
+  {
+    if (!std::is_constant_evaluated())
+    {
+      auto *begin = std::to_address(first);
+      auto *end   = begin + (last - first);
+      auto *out   = begin;
+      for (auto *it = begin; it != end; ++it)
+      {
+        std::iter_value_t<ForwardIt> value = *it;
+        *out = value;
+        out += !p(value);
+      }
+      return first + (out - begin);
+    }
+  }
+
+  while (first != last && !p(*first))
+  {
+    ++first;
+  }
+  if (first == last)
+  {
+    return first;
+  }
+
+  ForwardIt out = first;
+  for (++first; first != last; ++first)
+  {
+    if (!p(*first))
+    {
+      *out = tenno::move(*first);
+      ++out;
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Removes the elements equal to value from the range
+ * [first, last), keeping the order of the others.
+ *
+ * @see tenno::remove_if
+ */
+template <class ForwardIt, class T>
+constexpr ForwardIt remove(ForwardIt first, ForwardIt last, const T &value)
+{
+  return tenno::remove_if(first, last,
+                          [&value](const auto &elem) { return elem == value; });
+}
+
 /**
  * @brief Exchanges the values of a and b.
  *
@@ -97,7 +201,7 @@ constexpr T accumulate(InputIt first, InputIt last, T init) noexcept
  * @param a The first value to swap.
  * @param b The second value to swap.
  */
-template <class T> void swap(T &a, T &b) noexcept
+template <class T> constexpr void swap(T &a, T &b) noexcept
 {
   T tmp = tenno::move(a);
   a = tenno::move(b);
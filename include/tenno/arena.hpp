@@ -0,0 +1,295 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <cstddef> // std::max_align_t
+#include <new>     // ::operator new
+#include <tenno/types.hpp>
+
+namespace tenno
+{
+
+/**
+ * @brief A bump pointer allocator that frees everything at once
+ *
+ * Memory is handed out from the current block by moving a pointer
+ * forward. When a request does not fit, a new block twice as large as
+ * the previous one is chained. Single deallocations are ignored, all
+ * the memory is given back by release() or by the destructor.
+ *
+ * The arena can start from a buffer provided by the caller, typically
+ * on the stack, which is used before any block is allocated and is
+ * never freed by the arena.
+ *
+ * The arena is not thread-safe.
+ *
+ * # Example
+ * ```cpp
+ * char buffer[4096];
+ * tenno::monotonic_arena arena(buffer, sizeof(buffer));
+ * tenno::vector<int, tenno::arena_allocator<int>> v(
+ *   tenno::arena_allocator<int>(arena));
+ * ```
+ */
+class monotonic_arena
+{
+public:
+  /**
+   * @brief The size of the first block allocated by default
+   */
+  static constexpr tenno::size default_block_size = 4096;
+
+  /**
+   * @brief Construct an arena whose first block has initial_size bytes
+   */
+  explicit monotonic_arena(
+    tenno::size initial_size = default_block_size) noexcept
+      : _blocks(nullptr), _cursor(nullptr), _end(nullptr),
+        _initial_buffer(nullptr), _initial_size(0),
+        _next_size(initial_size != 0 ? initial_size : default_block_size),
+        _first_size(_next_size), _used(0)
+  {
+  }
+
+  /**
+   * @brief Construct an arena that serves memory from buffer first
+   *
+   * @param buffer The memory to use first, not owned by the arena
+   * @param bytes The size of buffer
+   */
+  monotonic_arena(void *buffer, tenno::size bytes) noexcept
+      : _blocks(nullptr), _cursor(static_cast<char *>(buffer)),
+        _end(static_cast<char *>(buffer) + bytes),
+        _initial_buffer(static_cast<char *>(buffer)), _initial_size(bytes),
+        _next_size(bytes != 0 ? 2 * bytes : default_block_size),
+        _first_size(_next_size), _used(0)
+  {
+  }
+
+  monotonic_arena(const monotonic_arena &) = delete;
+  monotonic_arena &operator=(const monotonic_arena &) = delete;
+
+  ~monotonic_arena()
+  {
+    this->release();
+  }
+
+  /**
+   * @brief Get bytes of memory aligned to align
+   *
+   * @param bytes The size of the memory
+   * @param align The alignment, a power of two
+   * @return void* The memory, valid until release()
+   */
+  void *allocate(tenno::size bytes,
+                 tenno::size align = alignof(std::max_align_t))
+  {
+    char *p = align_up(this->_cursor, align);
+    if (p == nullptr || p > this->_end
+        || bytes > (tenno::size) (this->_end - p))
+    {
+      this->grow(bytes, align);
+      p = align_up(this->_cursor, align);
+    }
+    this->_cursor = p + bytes;
+    this->_used  += bytes;
+    return p;
+  }
+
+  /**
+   * @brief Does nothing, the memory is freed by release()
+   */
+  void deallocate(void *, tenno::size) noexcept
+  {
+  }
+
+  /**
+   * @brief Resize the last allocation in place
+   *
+   * @param p The memory returned by the last call to allocate
+   * @param old_bytes The size p was allocated with
+   * @param new_bytes The new size
+   * @return true if p now has new_bytes bytes, false if p is not the
+   * last allocation or the block has no room. In that case p is left
+   * untouched.
+   */
+  bool extend(void *p, tenno::size old_bytes, tenno::size new_bytes) noexcept
+  {
+    char *start = static_cast<char *>(p);
+    if (start == nullptr || start + old_bytes != this->_cursor
+        || new_bytes > (tenno::size) (this->_end - start))
+    {
+      return false;
+    }
+    this->_cursor = start + new_bytes;
+    this->_used   = this->_used - old_bytes + new_bytes;
+    return true;
+  }
+
+  /**
+   * @brief Free all the blocks and start again from the initial buffer
+   *
+   * Every pointer returned by the arena becomes invalid.
+   */
+  void release() noexcept
+  {
+    while (this->_blocks != nullptr)
+    {
+      block_header *prev = this->_blocks->prev;
+      ::operator delete(this->_blocks, this->_blocks->size);
+      this->_blocks = prev;
+    }
+    this->_cursor    = this->_initial_buffer;
+    this->_end       = this->_initial_buffer + this->_initial_size;
+    this->_next_size = this->_first_size;
+    this->_used      = 0;
+  }
+
+  /**
+   * @brief Get the number of bytes handed out since the last release
+   */
+  tenno::size used() const noexcept
+  {
+    return this->_used;
+  }
+
+  /**
+   * @brief Get the number of bytes left in the current block
+   */
+  tenno::size remaining() const noexcept
+  {
+    return (tenno::size) (this->_end - this->_cursor);
+  }
+
+private:
+  struct block_header
+  {
+    block_header *prev;
+    tenno::size   size;
+  };
+
+  static char *align_up(char *p, tenno::size align) noexcept
+  {
+    if (p == nullptr)
+    {
+      return nullptr;
+    }
+    tenno::size addr = (tenno::size) p;
+    return p + (((addr + align - 1) & ~(align - 1)) - addr);
+  }
+
+  void grow(tenno::size bytes, tenno::size align)
+  {
+    tenno::size needed = sizeof(block_header) + bytes + align;
+    tenno::size block_size = this->_next_size;
+    while (block_size < needed)
+    {
+      block_size *= 2;
+    }
+
+    auto *block = static_cast<block_header *>(::operator new(block_size));
+    block->prev   = this->_blocks;
+    block->size   = block_size;
+    this->_blocks = block;
+
+    this->_cursor    = reinterpret_cast<char *>(block + 1);
+    this->_end       = reinterpret_cast<char *>(block) + block_size;
+    this->_next_size = block_size * 2;
+  }
+
+  block_header *_blocks;
+  char         *_cursor;
+  char         *_end;
+  char         *_initial_buffer;
+  tenno::size   _initial_size;
+  tenno::size   _next_size;
+  tenno::size   _first_size;
+  tenno::size   _used;
+};
+
+/**
+ * @brief An allocator that takes its memory from a
+ * tenno::monotonic_arena
+ *
+ * Deallocation does nothing, the memory of every container using the
+ * arena is freed together when the arena is released. The arena must
+ * outlive the containers. If the last allocation of the arena is a
+ * buffer that grows, it is extended in place.
+ *
+ * # Example
+ * ```cpp
+ * tenno::monotonic_arena arena;
+ * tenno::arena_allocator<int> alloc(arena);
+ * tenno::vector<int, tenno::arena_allocator<int>> v(alloc);
+ * auto sp = tenno::allocate_shared<node>(alloc, 42);
+ * ```
+ *
+ * @tparam T The type of the objects to allocate
+ */
+template <class T> struct arena_allocator
+{
+  using value_type = T;
+  using pointer = T *;
+  using const_pointer = const T *;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = tenno::size;
+
+  template <class U> friend struct arena_allocator;
+
+  explicit arena_allocator(tenno::monotonic_arena &arena) noexcept
+      : _arena(&arena)
+  {
+  }
+
+  template <class U>
+  arena_allocator(const arena_allocator<U> &other) noexcept
+      : _arena(other._arena)
+  {
+  }
+
+  T *allocate(tenno::size n)
+  {
+    return static_cast<T *>(this->_arena->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T *, tenno::size) noexcept
+  {
+  }
+
+  /**
+   * @brief Grow or shrink a buffer in place, if it is the last
+   * allocation of the arena
+   *
+   * @return T* p, or nullptr if the buffer could not be resized
+   */
+  T *reallocate(T *p, tenno::size old_n, tenno::size new_n) noexcept
+  {
+    return this->_arena->extend(p, old_n * sizeof(T), new_n * sizeof(T))
+             ? p
+             : nullptr;
+  }
+
+  tenno::monotonic_arena &arena() const noexcept
+  {
+    return *this->_arena;
+  }
+
+  bool operator==(const arena_allocator &other) const noexcept
+  {
+    return this->_arena == other._arena;
+  }
+
+  bool operator!=(const arena_allocator &other) const noexcept
+  {
+    return !(*this == other);
+  }
+
+private:
+  tenno::monotonic_arena *_arena;
+};
+
+} // namespace tenno
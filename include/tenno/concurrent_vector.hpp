@@ -0,0 +1,439 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <bit>      // std::bit_width
+#include <cstddef>  // std::ptrdiff_t
+#include <iterator> // std::forward_iterator_tag
+#include <tenno/error.hpp>
+#include <tenno/expected.hpp>
+#include <tenno/functional.hpp>
+#include <tenno/memory.hpp>
+#include <tenno/types.hpp>
+#include <utility> // std::forward
+
+namespace tenno
+{
+
+/**
+ * @brief An append-only vector that supports concurrent growth
+ *
+ * Elements are stored in segments of geometrically increasing size:
+ * segment k holds first_segment_size * 2^k elements. Growing the
+ * vector allocates a new segment and never relocates existing
+ * elements, so references returned by push_back and emplace_back stay
+ * valid for the lifetime of the vector.
+ *
+ * push_back, emplace_back, reserve, size, at and operator[] can be
+ * called concurrently from any number of threads without locks. An
+ * index is claimed with a single atomic increment, so appending
+ * threads do not serialize on each other. The next segment is
+ * allocated as soon as the current one is half full, so appenders
+ * seldom find a segment missing. When they do, each of them allocates
+ * it and all but one free their copy, no thread waits for another.
+ * All other operations, including destruction, must not run
+ * concurrently with any other operation.
+ *
+ * @tparam T The type of the elements
+ * @tparam Allocator The allocator used for the segments
+ */
+template <class T, class Allocator = tenno::allocator<T>>
+class concurrent_vector
+{
+public:
+  using value_type = T;
+  using allocator_type = Allocator;
+  using size_type = tenno::size;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using pointer = typename Allocator::pointer;
+  using const_pointer = typename Allocator::const_pointer;
+  using difference_type = std::ptrdiff_t;
+
+  /**
+   * @brief The number of elements in the first segment
+   */
+  static constexpr size_type first_segment_size = 8;
+
+  concurrent_vector() : _allocator()
+  {
+  }
+
+  explicit concurrent_vector(const Allocator &alloc) : _allocator(alloc)
+  {
+  }
+
+  concurrent_vector(const concurrent_vector &) = delete;
+  concurrent_vector &operator=(const concurrent_vector &) = delete;
+
+  ~concurrent_vector()
+  {
+    this->clear();
+    for (size_type k = 0; k < max_segments; ++k)
+    {
+      if (_segments[k] != nullptr)
+      {
+        _allocator.deallocate(_segments[k], segment_slots(k));
+      }
+    }
+  }
+
+  allocator_type get_allocator() const
+  {
+    return this->_allocator;
+  }
+
+  /**
+   * @brief Append a copy of value
+   *
+   * @return reference The new element, it stays valid until the vector
+   * is cleared or destroyed
+   */
+  reference push_back(const T &value)
+  {
+    return this->emplace_back(value);
+  }
+
+  reference push_back(T &&value)
+  {
+    return this->emplace_back(tenno::move(value));
+  }
+
+  /**
+   * @brief Construct an element in place at the end
+   *
+   * If the allocation or the constructor throws, the claimed index is
+   * not given back: it stays counted by size() and at() reports it as
+   * tenno::error::not_initialized.
+   */
+  template <class... Args> reference emplace_back(Args &&...args)
+  {
+    size_type index = __atomic_fetch_add(&_size, 1, __ATOMIC_RELAXED);
+    size_type k     = segment_of(index);
+    size_type pos   = index - segment_base(k);
+    pointer segment = this->get_segment(k);
+
+    // The ready flag stays 0 if the constructor throws, the slot is
+    // never destroyed
+    new (&segment[pos]) T(std::forward<Args>(args)...);
+    __atomic_store_n(&ready_flags(segment, k)[pos], 1, __ATOMIC_RELEASE);
+    if (pos == segment_size(k) / 2)
+    {
+      this->prepare_next_segment(k);
+    }
+    return segment[pos];
+  }
+
+  /**
+   * @brief Access an element with bounds checking
+   *
+   * @return The element, tenno::error::out_of_range if pos has not
+   * been claimed yet, or tenno::error::not_initialized if the element
+   * is still being constructed by another thread.
+   */
+  expected<tenno::reference_wrapper<T>, tenno::error> at(size_type pos)
+  {
+    pointer element = this->find_ready(pos);
+    if (element == nullptr)
+    {
+      return tenno::unexpected(
+        (pos >= this->size()) ? tenno::error::out_of_range
+                              : tenno::error::not_initialized);
+    }
+    return tenno::reference_wrapper<T>(*element);
+  }
+
+  expected<tenno::reference_wrapper<const T>, tenno::error>
+  at(size_type pos) const
+  {
+    pointer element = this->find_ready(pos);
+    if (element == nullptr)
+    {
+      return tenno::unexpected(
+        (pos >= this->size()) ? tenno::error::out_of_range
+                              : tenno::error::not_initialized);
+    }
+    return tenno::reference_wrapper<const T>(*element);
+  }
+
+  // Unsafe! The element must have been fully constructed
+  T &operator[](size_type pos)
+  {
+    size_type k = segment_of(pos);
+    return __atomic_load_n(&_segments[k], __ATOMIC_ACQUIRE)
+      [pos - segment_base(k)];
+  }
+
+  // Unsafe! The element must have been fully constructed
+  const T &operator[](size_type pos) const
+  {
+    size_type k = segment_of(pos);
+    return __atomic_load_n(&_segments[k], __ATOMIC_ACQUIRE)
+      [pos - segment_base(k)];
+  }
+
+  /**
+   * @brief Get the number of claimed elements
+   *
+   * Under concurrent appends some of the last elements may still be
+   * under construction, use at() to access them safely.
+   */
+  size_type size() const noexcept
+  {
+    return __atomic_load_n(&_size, __ATOMIC_ACQUIRE);
+  }
+
+  bool empty() const noexcept
+  {
+    return this->size() == 0;
+  }
+
+  size_type max_size() const noexcept
+  {
+    return (tenno::size) -1;
+  }
+
+  /**
+   * @brief Get the number of elements that fit in the allocated
+   * segments without allocating
+   */
+  size_type capacity() const noexcept
+  {
+    size_type k = 0;
+    while (k < max_segments
+           && __atomic_load_n(&_segments[k], __ATOMIC_ACQUIRE) != nullptr)
+    {
+      ++k;
+    }
+    return segment_base(k);
+  }
+
+  /**
+   * @brief Allocate the segments needed to hold new_cap elements
+   */
+  void reserve(size_type new_cap)
+  {
+    if (new_cap == 0)
+    {
+      return;
+    }
+    for (size_type k = 0; k <= segment_of(new_cap - 1); ++k)
+    {
+      this->get_segment(k);
+    }
+  }
+
+  /**
+   * @brief Destroy all the elements, keeping the segments allocated
+   */
+  void clear() noexcept
+  {
+    for (size_type i = 0; i < _size; ++i)
+    {
+      size_type k     = segment_of(i);
+      pointer segment = _segments[k];
+      if (segment == nullptr)
+      {
+        // The allocation of the segment failed
+        i = segment_base(k + 1) - 1;
+        continue;
+      }
+      unsigned char &ready = ready_flags(segment, k)[i - segment_base(k)];
+      if (ready)
+      {
+        segment[i - segment_base(k)].~T();
+        ready = 0;
+      }
+    }
+    _size = 0;
+  }
+
+  /**
+   * @brief An iterator to iterate over the data
+   */
+  struct iterator
+  {
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using pointer = T *;
+    using reference = T &;
+
+    tenno::size index;
+    concurrent_vector *vec;
+
+    iterator() noexcept : index(0), vec(nullptr)
+    {
+    }
+
+    explicit iterator(concurrent_vector &_vec, const tenno::size _index)
+        : index(_index), vec(&_vec)
+    {
+    }
+
+    iterator &operator++() noexcept
+    {
+      index++;
+      return *this;
+    }
+
+    iterator operator++(int) noexcept
+    {
+      iterator _iterator = *this;
+      ++index;
+      return _iterator;
+    }
+
+    bool operator==(const iterator &other) const noexcept
+    {
+      return index == other.index;
+    }
+
+    bool operator!=(const iterator &other) const noexcept
+    {
+      return !(index == other.index);
+    }
+
+    T &operator*() const noexcept
+    {
+      return (*vec)[index];
+    }
+
+    T *operator->() const noexcept
+    {
+      return &(*vec)[index];
+    }
+
+    T &get() const noexcept
+    {
+      return (*vec)[index];
+    }
+  };
+
+  /**
+   * @brief Get an iterator to the beginning of the data
+   */
+  iterator begin() noexcept
+  {
+    return iterator(*this, tenno::size(0));
+  }
+
+  /**
+   * @brief Get an iterator past the elements claimed so far
+   */
+  iterator end() noexcept
+  {
+    return iterator(*this, this->size());
+  }
+
+private:
+  static constexpr size_type first_segment_log = 3;
+  static_assert(first_segment_size == (size_type) 1 << first_segment_log);
+  static constexpr size_type max_segments =
+    sizeof(size_type) * 8 - first_segment_log;
+
+  // Segment k covers the indices
+  // [segment_base(k), segment_base(k + 1))
+  static constexpr size_type segment_base(size_type k) noexcept
+  {
+    return first_segment_size * (((size_type) 1 << k) - 1);
+  }
+
+  static constexpr size_type segment_size(size_type k) noexcept
+  {
+    return first_segment_size << k;
+  }
+
+  static constexpr size_type segment_of(size_type index) noexcept
+  {
+    return (size_type) std::bit_width((index >> first_segment_log) + 1) - 1;
+  }
+
+  // Each segment stores its elements followed by one ready flag per
+  // element, in the same allocation
+  static constexpr size_type segment_slots(size_type k) noexcept
+  {
+    return segment_size(k) + (segment_size(k) + sizeof(T) - 1) / sizeof(T);
+  }
+
+  static unsigned char *ready_flags(pointer segment, size_type k) noexcept
+  {
+    return reinterpret_cast<unsigned char *>(segment + segment_size(k));
+  }
+
+  // Return segment k, allocating it if no thread did it yet. Threads
+  // that race on a missing segment all allocate it, the one whose
+  // compare-exchange succeeds installs it and the others free theirs,
+  // so no thread ever waits for another.
+  pointer get_segment(size_type k)
+  {
+    pointer segment = __atomic_load_n(&_segments[k], __ATOMIC_ACQUIRE);
+    if (segment != nullptr)
+    {
+      return segment;
+    }
+
+    pointer fresh = _allocator.allocate(segment_slots(k));
+    for (size_type i = 0; i < segment_size(k); ++i)
+    {
+      ready_flags(fresh, k)[i] = 0;
+    }
+    if (__atomic_compare_exchange_n(&_segments[k], &segment, fresh, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+      return fresh;
+    }
+
+    // Another thread installed the segment first
+    _allocator.deallocate(fresh, segment_slots(k));
+    return segment;
+  }
+
+  // Allocate the segment after k while k is only half full, so that
+  // appenders rarely find a segment missing and race to allocate it
+  void prepare_next_segment(size_type k) noexcept
+  {
+    if (k + 1 >= max_segments
+        || __atomic_load_n(&_segments[k + 1], __ATOMIC_RELAXED) != nullptr)
+    {
+      return;
+    }
+    try
+    {
+      this->get_segment(k + 1);
+    }
+    catch (...)
+    {
+      // Only a hint, the segment is allocated again when it is needed
+    }
+  }
+
+  pointer find_ready(size_type pos) const noexcept
+  {
+    if (pos >= this->size())
+    {
+      return nullptr;
+    }
+    size_type k     = segment_of(pos);
+    pointer segment = __atomic_load_n(&_segments[k], __ATOMIC_ACQUIRE);
+    if (segment == nullptr)
+    {
+      return nullptr;
+    }
+    size_type offset = pos - segment_base(k);
+    if (!__atomic_load_n(&ready_flags(segment, k)[offset], __ATOMIC_ACQUIRE))
+    {
+      return nullptr;
+    }
+    return &segment[offset];
+  }
+
+  size_type _size                  = 0;
+  pointer   _segments[max_segments] = {};
+  Allocator _allocator;
+};
+
+} // namespace tenno
@@ -0,0 +1,372 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <tenno/memory.hpp>
+#include <tenno/mutex.hpp>
+#include <tenno/types.hpp>
+#include <tenno/vector.hpp>
+
+namespace tenno
+{
+
+/**
+ * @brief Safe memory reclamation for lock-free data structures with
+ * epochs
+ *
+ * Readers enter a critical section with an ebr_domain::guard, which
+ * announces the global epoch the reader started in. A node retired in
+ * epoch e is deleted once the global epoch reaches e + 2: the epoch
+ * only advances when every reader inside a critical section has seen
+ * the current one, so after two advances no reader can still hold a
+ * node unlinked before the retire.
+ *
+ * A guard costs one store and one fence, independent of the number of
+ * nodes read, which makes epochs cheaper than hazard pointers for
+ * readers that walk many nodes. The price is that a reader stuck in a
+ * critical section holds back the reclamation of every node.
+ *
+ * Retired nodes are kept per thread in three lists, one per epoch
+ * modulo three. Every retire_threshold retires the thread tries to
+ * advance the epoch and deletes the lists that became safe. Nodes left
+ * by a thread that exits are adopted by the domain and reclaimed by
+ * later advances.
+ *
+ * The domain is selected by Tag, the class has no state and the
+ * domain lives as long as the program.
+ *
+ * # Example
+ * ```cpp
+ * // reader
+ * {
+ *   tenno::ebr_domain<>::guard g;
+ *   for (node *n = load(head); n != nullptr; n = load(n->next))
+ *     use(n);
+ * }
+ *
+ * // writer, after unlinking n
+ * tenno::ebr_domain<>::retire(n);
+ * ```
+ *
+ * @tparam Tag A type naming the domain
+ */
+template <class Tag = void> class ebr_domain
+{
+public:
+  /**
+   * @brief The number of nodes a thread retires between two attempts
+   * to advance the epoch
+   */
+  static constexpr tenno::size retire_threshold = 64;
+
+  /**
+   * @brief A critical section, the nodes read inside it are not
+   * deleted before it ends
+   *
+   * Guards can be nested, only the outermost one is announced.
+   */
+  class guard
+  {
+  public:
+    guard()
+    {
+      ebr_domain::enter();
+    }
+
+    guard(const guard &) = delete;
+    guard &operator=(const guard &) = delete;
+
+    ~guard()
+    {
+      ebr_domain::leave();
+    }
+  };
+
+  /**
+   * @brief Delete ptr with Deleter once no reader can hold it
+   *
+   * ptr must already be unreachable for new readers.
+   *
+   * @tparam Deleter A stateless deleter, default constructed when the
+   * node is reclaimed
+   */
+  template <class T, class Deleter = tenno::default_delete<T>>
+  static void retire(T *ptr)
+  {
+    thread_state &s = state();
+    unsigned long e = __atomic_load_n(&global().epoch, __ATOMIC_SEQ_CST);
+    limbo_list &l   = s.limbo[e % 3];
+    if (l.epoch != e)
+    {
+      // The list holds nodes of epoch e - 3 or older
+      free_all(l.nodes);
+      l.epoch = e;
+    }
+    l.nodes.push_back({ptr, &delete_as<T, Deleter>});
+    if (++s.since_advance >= retire_threshold)
+    {
+      s.since_advance = 0;
+      try_advance();
+      reclaim(s);
+    }
+  }
+
+  /**
+   * @brief Advance the epoch as far as the readers allow and delete
+   * every node that became safe, including the ones of exited threads
+   *
+   * Called outside of a critical section with no reader active, it
+   * deletes every retired node.
+   */
+  static void cleanup()
+  {
+    thread_state &s = state();
+    for (int i = 0; i < 3; i++)
+    {
+      try_advance();
+    }
+    reclaim(s);
+  }
+
+  /**
+   * @brief Get the global epoch
+   */
+  static unsigned long epoch() noexcept
+  {
+    return __atomic_load_n(&global().epoch, __ATOMIC_ACQUIRE);
+  }
+
+  /**
+   * @brief Get the number of nodes retired by this thread and not
+   * reclaimed yet
+   */
+  static tenno::size pending() noexcept
+  {
+    thread_state &s = state();
+    return s.limbo[0].nodes.size() + s.limbo[1].nodes.size()
+           + s.limbo[2].nodes.size();
+  }
+
+private:
+  // The announced epoch shifted left by one, the low bit is set while
+  // the thread is inside a critical section
+  struct record
+  {
+    unsigned long announce = 0;
+    record       *next     = nullptr;
+    bool          in_use   = false;
+  };
+
+  struct retired_node
+  {
+    void *ptr;
+    void (*deleter)(void *) noexcept;
+  };
+
+  struct limbo_list
+  {
+    unsigned long               epoch = 0;
+    tenno::vector<retired_node> nodes;
+  };
+
+  struct global_state
+  {
+    unsigned long  epoch   = 0;
+    record        *records = nullptr;
+    tenno::mutex   orphans_lock;
+    limbo_list     orphans[3];
+    tenno::size    num_orphans = 0;
+
+    ~global_state()
+    {
+      for (limbo_list &l : this->orphans)
+      {
+        free_all(l.nodes);
+      }
+      while (this->records != nullptr)
+      {
+        record *next = this->records->next;
+        delete this->records;
+        this->records = next;
+      }
+    }
+  };
+
+  struct thread_state
+  {
+    record     *rec     = nullptr;
+    tenno::size nesting = 0;
+    tenno::size since_advance = 0;
+    limbo_list  limbo[3];
+
+    ~thread_state()
+    {
+      reclaim(*this);
+      global_state &g = global();
+      {
+        tenno::lock_guard<tenno::mutex> guard(g.orphans_lock);
+        for (limbo_list &l : this->limbo)
+        {
+          // Lists with the same index are at least three epochs apart
+          // when their epochs differ, the older one is safe to delete
+          limbo_list &o = g.orphans[l.epoch % 3];
+          if (l.epoch < o.epoch)
+          {
+            free_all(l.nodes);
+            continue;
+          }
+          if (l.epoch > o.epoch)
+          {
+            __atomic_fetch_sub(&g.num_orphans, o.nodes.size(),
+                               __ATOMIC_RELAXED);
+            free_all(o.nodes);
+            o.epoch = l.epoch;
+          }
+          for (retired_node &r : l.nodes)
+          {
+            o.nodes.push_back(r);
+          }
+          __atomic_fetch_add(&g.num_orphans, l.nodes.size(),
+                             __ATOMIC_RELAXED);
+          l.nodes.clear();
+        }
+      }
+      if (this->rec != nullptr)
+      {
+        __atomic_store_n(&this->rec->announce, 0, __ATOMIC_RELEASE);
+        __atomic_store_n(&this->rec->in_use, false, __ATOMIC_RELEASE);
+      }
+    }
+  };
+
+  static thread_state &state() noexcept
+  {
+    thread_local thread_state s;
+    return s;
+  }
+
+  static global_state &global() noexcept
+  {
+    static global_state g;
+    return g;
+  }
+
+  template <class T, class Deleter>
+  static void delete_as(void *ptr) noexcept
+  {
+    Deleter()(static_cast<T *>(ptr));
+  }
+
+  static void free_all(tenno::vector<retired_node> &nodes) noexcept
+  {
+    for (retired_node &r : nodes)
+    {
+      r.deleter(r.ptr);
+    }
+    nodes.clear();
+  }
+
+  static record *acquire_record()
+  {
+    global_state &g = global();
+    for (record *r = __atomic_load_n(&g.records, __ATOMIC_ACQUIRE);
+         r != nullptr; r = r->next)
+    {
+      bool expected = false;
+      if (!__atomic_load_n(&r->in_use, __ATOMIC_RELAXED)
+          && __atomic_compare_exchange_n(&r->in_use, &expected, true, false,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+      {
+        return r;
+      }
+    }
+
+    record *r = new record();
+    r->in_use = true;
+    r->next   = __atomic_load_n(&g.records, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&g.records, &r->next, r, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    {
+    }
+    return r;
+  }
+
+  static void enter()
+  {
+    thread_state &s = state();
+    if (s.nesting++ != 0)
+    {
+      return;
+    }
+    if (s.rec == nullptr)
+    {
+      s.rec = acquire_record();
+    }
+    unsigned long e = __atomic_load_n(&global().epoch, __ATOMIC_RELAXED);
+    __atomic_store_n(&s.rec->announce, (e << 1) | 1, __ATOMIC_RELAXED);
+    // The announcement is visible before any node is read
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  }
+
+  static void leave() noexcept
+  {
+    thread_state &s = state();
+    if (--s.nesting != 0)
+    {
+      return;
+    }
+    // Every read of the critical section happens before the release
+    __atomic_store_n(&s.rec->announce, 0, __ATOMIC_RELEASE);
+  }
+
+  // Advance the epoch if every active reader announced the current one
+  static void try_advance() noexcept
+  {
+    global_state &g = global();
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    unsigned long e = __atomic_load_n(&g.epoch, __ATOMIC_SEQ_CST);
+    for (record *r = __atomic_load_n(&g.records, __ATOMIC_ACQUIRE);
+         r != nullptr; r = r->next)
+    {
+      unsigned long a = __atomic_load_n(&r->announce, __ATOMIC_ACQUIRE);
+      if ((a & 1) != 0 && (a >> 1) != e)
+      {
+        return;
+      }
+    }
+    __atomic_compare_exchange_n(&g.epoch, &e, e + 1, false, __ATOMIC_ACQ_REL,
+                                __ATOMIC_RELAXED);
+  }
+
+  // Delete the lists of s, and the orphans, retired two epochs ago
+  static void reclaim(thread_state &s)
+  {
+    global_state &g = global();
+    unsigned long e = __atomic_load_n(&g.epoch, __ATOMIC_ACQUIRE);
+    for (limbo_list &l : s.limbo)
+    {
+      if (l.epoch + 2 <= e)
+      {
+        free_all(l.nodes);
+      }
+    }
+    if (__atomic_load_n(&g.num_orphans, __ATOMIC_RELAXED) != 0)
+    {
+      tenno::lock_guard<tenno::mutex> guard(g.orphans_lock);
+      for (limbo_list &o : g.orphans)
+      {
+        if (o.epoch + 2 <= e)
+        {
+          __atomic_fetch_sub(&g.num_orphans, o.nodes.size(),
+                             __ATOMIC_RELAXED);
+          free_all(o.nodes);
+        }
+      }
+    }
+  }
+};
+
+} // namespace tenno
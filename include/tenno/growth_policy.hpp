@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <tenno/types.hpp>
+
+namespace tenno
+{
+
+/*
+// Example of a custom growth policy
+struct custom_growth
+{
+  // Return the new capacity of a container that holds `capacity`
+  // elements of `elem_size` bytes and needs room for `required`.
+  // The result must be at least `required`.
+  static constexpr tenno::size grow(tenno::size capacity,
+                                    tenno::size required,
+                                    tenno::size elem_size) noexcept;
+};
+*/
+
+/**
+ * @brief Double the capacity on each growth
+ *
+ * This is the default policy of tenno::vector, it minimizes the
+ * number of reallocations at the cost of up to half of the buffer
+ * being unused.
+ */
+struct growth_factor_2
+{
+  static constexpr tenno::size grow(tenno::size capacity,
+                                    tenno::size required,
+                                    tenno::size) noexcept
+  {
+    return (capacity * 2 > required) ? capacity * 2 : required;
+  }
+};
+
+/**
+ * @brief Grow the capacity by a factor of 1.5
+ *
+ * Wastes at most a third of the buffer and lets the allocator reuse
+ * previously freed blocks for later growths.
+ */
+struct growth_factor_1_5
+{
+  static constexpr tenno::size grow(tenno::size capacity,
+                                    tenno::size required,
+                                    tenno::size) noexcept
+  {
+    tenno::size next = capacity + capacity / 2;
+    return (next > required) ? next : required;
+  }
+};
+
+/**
+ * @brief Grow by a factor of 1.5 and round the buffer up to a whole
+ * number of pages
+ *
+ * The rounding hands the slack at the end of the last page to the
+ * container instead of wasting it, which pairs well with allocators
+ * that map memory directly, like tenno::mmap_allocator.
+ *
+ * @tparam PageSize The size of a page in bytes
+ */
+template <tenno::size PageSize = 4096> struct growth_page_rounded
+{
+  static_assert(PageSize != 0 && (PageSize & (PageSize - 1)) == 0,
+                "PageSize must be a power of two");
+
+  static constexpr tenno::size grow(tenno::size capacity,
+                                    tenno::size required,
+                                    tenno::size elem_size) noexcept
+  {
+    tenno::size next  = growth_factor_1_5::grow(capacity, required, elem_size);
+    tenno::size bytes = (next * elem_size + PageSize - 1) & ~(PageSize - 1);
+    return bytes / elem_size;
+  }
+};
+
+/**
+ * @brief Grow the capacity by a fixed number of elements
+ *
+ * Keeps the unused capacity bounded by Increment, at the cost of a
+ * linear number of reallocations.
+ *
+ * @tparam Increment The number of elements to add on each growth
+ */
+template <tenno::size Increment> struct growth_fixed
+{
+  static_assert(Increment != 0, "Increment must be greater than zero");
+
+  static constexpr tenno::size grow(tenno::size capacity,
+                                    tenno::size required,
+                                    tenno::size) noexcept
+  {
+    return (capacity + Increment > required) ? capacity + Increment
+                                             : required;
+  }
+};
+
+} // namespace tenno
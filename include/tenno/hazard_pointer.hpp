@@ -0,0 +1,418 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <algorithm> // std::sort, std::binary_search
+#include <tenno/memory.hpp>
+#include <tenno/mutex.hpp>
+#include <tenno/types.hpp>
+#include <tenno/vector.hpp>
+
+namespace tenno
+{
+
+template <class Tag> class hazard_pointer;
+
+/**
+ * @brief Safe memory reclamation for lock-free data structures with
+ * hazard pointers
+ *
+ * A reader publishes the address of the node it is about to use in a
+ * hazard pointer, and a writer that unlinks a node retires it instead
+ * of deleting it. Retired nodes are kept in a list per thread. When the
+ * list grows beyond a threshold proportional to the number of hazard
+ * pointers, the thread scans all the hazard pointers once and deletes
+ * the nodes that nobody protects, so the cost of a scan is spread over
+ * many retires. Readers never write to the nodes they read, there is
+ * no reference count traffic.
+ *
+ * The domain is selected by Tag, independent data structures can use
+ * different tags so that they do not scan each other's hazard
+ * pointers. The class has no state, the domain lives as long as the
+ * program.
+ *
+ * Nodes retired by a thread that exits while they are still protected
+ * are adopted by the next scan of another thread.
+ *
+ * # Example
+ * ```cpp
+ * // reader
+ * tenno::hazard_pointer<> hp;
+ * node *n = hp.protect(head);
+ * use(n);
+ * hp.reset_protection();
+ *
+ * // writer, after unlinking n
+ * tenno::hazard_domain<>::retire(n);
+ * ```
+ *
+ * @tparam Tag A type naming the domain
+ */
+template <class Tag = void> class hazard_domain
+{
+public:
+  /**
+   * @brief The minimum number of nodes a thread retires before it
+   * scans the hazard pointers
+   */
+  static constexpr tenno::size retire_threshold = 64;
+
+  /**
+   * @brief Delete ptr with Deleter once no hazard pointer protects it
+   *
+   * ptr must already be unreachable for new readers.
+   *
+   * @tparam Deleter A stateless deleter, default constructed when the
+   * node is reclaimed
+   */
+  template <class T, class Deleter = tenno::default_delete<T>>
+  static void retire(T *ptr)
+  {
+    thread_state &s = state();
+    s.pending.push_back({ptr, &delete_as<T, Deleter>});
+    if (s.pending.size() >= threshold())
+    {
+      scan(s);
+    }
+  }
+
+  /**
+   * @brief Delete every node retired by this thread, or orphaned by an
+   * exited thread, that is not protected right now
+   */
+  static void cleanup()
+  {
+    scan(state());
+  }
+
+  /**
+   * @brief Get the number of nodes retired by this thread and not
+   * reclaimed yet
+   */
+  static tenno::size pending() noexcept
+  {
+    return state().pending.size();
+  }
+
+private:
+  friend class tenno::hazard_pointer<Tag>;
+
+  struct record
+  {
+    const void *ptr    = nullptr;
+    record     *next   = nullptr;
+    bool        active = false;
+  };
+
+  struct retired_node
+  {
+    void *ptr;
+    void (*deleter)(void *) noexcept;
+  };
+
+  // Records are only freed with the domain, a reader can walk the list
+  // without any lock
+  struct global_state
+  {
+    record                      *records     = nullptr;
+    tenno::size                  num_records = 0;
+    tenno::mutex                 orphans_lock;
+    tenno::vector<retired_node>  orphans;
+    tenno::size                  num_orphans = 0;
+
+    ~global_state()
+    {
+      for (retired_node &r : this->orphans)
+      {
+        r.deleter(r.ptr);
+      }
+      while (this->records != nullptr)
+      {
+        record *next = this->records->next;
+        delete this->records;
+        this->records = next;
+      }
+    }
+  };
+
+  // Every thread keeps a few released records to avoid searching the
+  // global list for each new hazard pointer
+  static constexpr tenno::size cached_records = 8;
+
+  struct thread_state
+  {
+    tenno::vector<retired_node> pending;
+    record                     *free_records[cached_records];
+    tenno::size                 num_free = 0;
+
+    ~thread_state()
+    {
+      state_destroyed() = true;
+      for (tenno::size i = 0; i < this->num_free; i++)
+      {
+        __atomic_store_n(&this->free_records[i]->active, false,
+                         __ATOMIC_RELEASE);
+      }
+      if (this->pending.size() > 0)
+      {
+        scan(*this);
+      }
+      if (this->pending.size() > 0)
+      {
+        global_state &g = global();
+        tenno::lock_guard<tenno::mutex> guard(g.orphans_lock);
+        for (retired_node &r : this->pending)
+        {
+          g.orphans.push_back(r);
+        }
+        __atomic_store_n(&g.num_orphans, g.orphans.size(), __ATOMIC_RELAXED);
+      }
+    }
+  };
+
+  static thread_state &state() noexcept
+  {
+    thread_local thread_state s;
+    return s;
+  }
+
+  // Set when the thread_state of the calling thread is destroyed. A
+  // hazard pointer destroyed after it, such as one with static
+  // storage, must not touch the record cache.
+  static bool &state_destroyed() noexcept
+  {
+    thread_local bool destroyed = false;
+    return destroyed;
+  }
+
+  static global_state &global() noexcept
+  {
+    static global_state g;
+    return g;
+  }
+
+  template <class T, class Deleter>
+  static void delete_as(void *ptr) noexcept
+  {
+    Deleter()(static_cast<T *>(ptr));
+  }
+
+  static tenno::size threshold() noexcept
+  {
+    tenno::size records =
+      __atomic_load_n(&global().num_records, __ATOMIC_RELAXED);
+    return 2 * records > retire_threshold ? 2 * records : retire_threshold;
+  }
+
+  static record *acquire_record()
+  {
+    thread_state &s = state();
+    if (s.num_free > 0)
+    {
+      return s.free_records[--s.num_free];
+    }
+
+    global_state &g = global();
+    for (record *r = __atomic_load_n(&g.records, __ATOMIC_ACQUIRE);
+         r != nullptr; r = r->next)
+    {
+      bool expected = false;
+      if (!__atomic_load_n(&r->active, __ATOMIC_RELAXED)
+          && __atomic_compare_exchange_n(&r->active, &expected, true, false,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+      {
+        return r;
+      }
+    }
+
+    record *r = new record();
+    r->active = true;
+    r->next   = __atomic_load_n(&g.records, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&g.records, &r->next, r, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    {
+    }
+    __atomic_fetch_add(&g.num_records, 1, __ATOMIC_RELAXED);
+    return r;
+  }
+
+  static void release_record(record *r) noexcept
+  {
+    __atomic_store_n(&r->ptr, nullptr, __ATOMIC_RELEASE);
+    if (state_destroyed())
+    {
+      __atomic_store_n(&r->active, false, __ATOMIC_RELEASE);
+      return;
+    }
+    thread_state &s = state();
+    if (s.num_free < cached_records)
+    {
+      s.free_records[s.num_free++] = r;
+      return;
+    }
+    __atomic_store_n(&r->active, false, __ATOMIC_RELEASE);
+  }
+
+  // Delete the pending nodes of s that no hazard pointer protects
+  static void scan(thread_state &s)
+  {
+    global_state &g = global();
+    if (__atomic_load_n(&g.num_orphans, __ATOMIC_RELAXED) != 0)
+    {
+      tenno::lock_guard<tenno::mutex> guard(g.orphans_lock);
+      for (retired_node &r : g.orphans)
+      {
+        s.pending.push_back(r);
+      }
+      g.orphans.clear();
+      __atomic_store_n(&g.num_orphans, 0, __ATOMIC_RELAXED);
+    }
+
+    // Pairs with the fence in hazard_pointer::protect: either the
+    // reader sees the node unlinked, or the scan sees its hazard
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    tenno::vector<tenno::size> hazards;
+    for (record *r = __atomic_load_n(&g.records, __ATOMIC_ACQUIRE);
+         r != nullptr; r = r->next)
+    {
+      const void *p = __atomic_load_n(&r->ptr, __ATOMIC_ACQUIRE);
+      if (p != nullptr)
+      {
+        hazards.push_back((tenno::size) p);
+      }
+    }
+    std::sort(hazards.begin(), hazards.end());
+
+    tenno::size kept = 0;
+    for (tenno::size i = 0; i < s.pending.size(); i++)
+    {
+      retired_node r = s.pending[i];
+      if (std::binary_search(hazards.begin(), hazards.end(),
+                             (tenno::size) r.ptr))
+      {
+        s.pending[kept++] = r;
+      }
+      else
+      {
+        r.deleter(r.ptr);
+      }
+    }
+    s.pending.resize(kept);
+  }
+};
+
+/**
+ * @brief A hazard pointer of the domain tenno::hazard_domain<Tag>
+ *
+ * Owns one slot of the domain for its lifetime. While the slot holds
+ * the address of a node, the node is not deleted by the domain even
+ * if it is retired. A hazard pointer is meant to be used by one
+ * thread.
+ *
+ * @tparam Tag A type naming the domain
+ */
+template <class Tag = void> class hazard_pointer
+{
+  using domain = tenno::hazard_domain<Tag>;
+
+public:
+  hazard_pointer() : _record(domain::acquire_record())
+  {
+  }
+
+  hazard_pointer(const hazard_pointer &) = delete;
+  hazard_pointer &operator=(const hazard_pointer &) = delete;
+
+  hazard_pointer(hazard_pointer &&other) noexcept : _record(other._record)
+  {
+    other._record = nullptr;
+  }
+
+  hazard_pointer &operator=(hazard_pointer &&other) noexcept
+  {
+    hazard_pointer tmp(tenno::move(other));
+    this->swap(tmp);
+    return *this;
+  }
+
+  ~hazard_pointer()
+  {
+    if (this->_record != nullptr)
+    {
+      domain::release_record(this->_record);
+    }
+  }
+
+  /**
+   * @brief Load src and protect the loaded node
+   *
+   * src is read with atomic loads, it must be written atomically by
+   * the writers.
+   *
+   * @return T* The node src pointed to, safe to use until the
+   * protection is reset
+   */
+  template <class T> T *protect(T *const &src) noexcept
+  {
+    T *ptr = __atomic_load_n(&src, __ATOMIC_RELAXED);
+    while (!this->try_protect(ptr, src))
+    {
+    }
+    return ptr;
+  }
+
+  /**
+   * @brief Protect ptr if src still points to it
+   *
+   * @param ptr The node to protect, updated with the current value of
+   * src on failure
+   * @param src Where ptr was loaded from
+   * @return true if ptr is protected
+   */
+  template <class T> bool try_protect(T *&ptr, T *const &src) noexcept
+  {
+    T *expected = ptr;
+    this->reset_protection(expected);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    ptr = __atomic_load_n(&src, __ATOMIC_ACQUIRE);
+    if (ptr != expected)
+    {
+      this->reset_protection();
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Protect ptr, the caller checks that ptr is still reachable
+   */
+  template <class T> void reset_protection(const T *ptr) noexcept
+  {
+    __atomic_store_n(&this->_record->ptr, static_cast<const void *>(ptr),
+                     __ATOMIC_RELAXED);
+  }
+
+  /**
+   * @brief Stop protecting any node
+   */
+  void reset_protection() noexcept
+  {
+    __atomic_store_n(&this->_record->ptr, nullptr, __ATOMIC_RELEASE);
+  }
+
+  void swap(hazard_pointer &other) noexcept
+  {
+    auto *tmp     = this->_record;
+    this->_record = other._record;
+    other._record = tmp;
+  }
+
+private:
+  typename domain::record *_record;
+};
+
+} // namespace tenno
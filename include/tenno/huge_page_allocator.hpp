@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <new> // std::bad_alloc
+#include <tenno/memory.hpp>
+#include <tenno/types.hpp>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace tenno
+{
+
+/**
+ * @brief An allocator that backs large buffers with huge pages
+ *
+ * Allocations of at least one huge page are mapped directly and
+ * aligned to the huge page size. The allocator first asks for
+ * explicit huge pages (MAP_HUGETLB), and if none are reserved it
+ * maps regular memory and marks it with MADV_HUGEPAGE so that
+ * transparent huge pages can back it. If neither is available the
+ * memory is still valid, just backed by regular pages.
+ *
+ * Smaller allocations, and every allocation on platforms without
+ * mmap, go through tenno::allocator.
+ *
+ * @tparam T The type of the objects to allocate
+ */
+template <class T> struct huge_page_allocator
+{
+  using value_type = T;
+  using pointer = T *;
+  using const_pointer = const T *;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = tenno::size;
+
+  /**
+   * @brief The size of a huge page in bytes
+   */
+  static constexpr tenno::size huge_page_size = 2 * 1024 * 1024;
+
+  huge_page_allocator() noexcept = default;
+
+  template <class U>
+  huge_page_allocator(const huge_page_allocator<U> &) noexcept
+  {
+  }
+
+  T *allocate(tenno::size n)
+  {
+    if (!is_mapped(n))
+    {
+      return tenno::allocator<T>().allocate(n);
+    }
+
+#if defined(__linux__)
+    tenno::size bytes = mapped_size(n);
+
+#if defined(MAP_HUGETLB)
+    void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED)
+    {
+      return (T *) p;
+    }
+#endif
+
+    // Over-allocate so the buffer can be aligned to a huge page
+    // boundary, then give back the unused head and tail
+    void *raw = mmap(nullptr, bytes + huge_page_size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+    {
+      throw std::bad_alloc();
+    }
+    tenno::size addr    = (tenno::size) raw;
+    tenno::size aligned = (addr + huge_page_size - 1) & ~(huge_page_size - 1);
+    tenno::size head    = aligned - addr;
+    if (head != 0)
+    {
+      munmap(raw, head);
+    }
+    munmap((void *) (aligned + bytes), huge_page_size - head);
+
+#if defined(MADV_HUGEPAGE)
+    madvise((void *) aligned, bytes, MADV_HUGEPAGE);
+#endif
+    return (T *) aligned;
+#else
+    return nullptr;
+#endif
+  }
+
+  void deallocate(T *p, tenno::size n)
+  {
+    if (p == nullptr)
+    {
+      return;
+    }
+    if (!is_mapped(n))
+    {
+      tenno::allocator<T>().deallocate(p, n);
+      return;
+    }
+
+#if defined(__linux__)
+    munmap(p, mapped_size(n));
+#endif
+  }
+
+  /**
+   * @brief Check whether an allocation of n objects is mapped with
+   * huge pages
+   */
+  static constexpr bool is_mapped(tenno::size n) noexcept
+  {
+#if defined(__linux__)
+    return n * sizeof(T) >= huge_page_size;
+#else
+    (void) n;
+    return false;
+#endif
+  }
+
+  constexpr bool operator==(const huge_page_allocator &) const noexcept
+  {
+    return true;
+  }
+
+  constexpr bool operator!=(const huge_page_allocator &) const noexcept
+  {
+    return false;
+  }
+
+private:
+  static constexpr tenno::size mapped_size(tenno::size n) noexcept
+  {
+    return (n * sizeof(T) + huge_page_size - 1) & ~(huge_page_size - 1);
+  }
+};
+
+} // namespace tenno
@@ -0,0 +1,291 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <concepts> // std::same_as
+#include <cstdio>   // std::fprintf
+#include <memory>   // std::allocator_traits
+#include <tenno/memory.hpp>
+#include <tenno/types.hpp>
+
+namespace tenno
+{
+
+/**
+ * @brief A snapshot of the counters of a tenno::instrumented_allocator
+ */
+struct allocation_stats
+{
+  tenno::size allocations;       // calls to allocate
+  tenno::size deallocations;     // calls to deallocate
+  tenno::size bytes_allocated;   // total bytes requested
+  tenno::size bytes_in_use;      // bytes allocated and not freed
+  tenno::size peak_bytes_in_use; // maximum of bytes_in_use
+  tenno::size reallocations;     // capacity changes of a live buffer
+  tenno::size bytes_moved;       // bytes relocated by reallocations
+  tenno::size peak_capacity;     // largest capacity in elements
+  tenno::size peak_size;         // largest size in elements at a
+                                 // capacity change
+  tenno::size growth_capacity;   // sum of the new capacities of
+                                 // every capacity change
+  tenno::size growth_size;       // sum of the sizes at every
+                                 // capacity change
+
+  /**
+   * @brief Get how much larger the capacity is than the size at a
+   * capacity change, averaged over the changes weighted by capacity,
+   * 1.0 means no memory was reserved in excess
+   *
+   * Capacity and size are paired per growth event, so the peaks of two
+   * different containers of the same Tag do not mix.
+   */
+  double capacity_ratio() const noexcept
+  {
+    return (growth_size == 0)
+             ? 0.0
+             : (double) growth_capacity / (double) growth_size;
+  }
+
+  /**
+   * @brief Print the counters on one line, prefixed by name
+   */
+  void print(const char *name, FILE *out = stdout) const
+  {
+    std::fprintf(out,
+                 "%s: %zu allocations, %zu deallocations, %zu reallocations, "
+                 "%zu bytes moved, %zu bytes peak, capacity/size %.2f\n",
+                 name, allocations, deallocations, reallocations, bytes_moved,
+                 peak_bytes_in_use, this->capacity_ratio());
+  }
+};
+
+/**
+ * @brief The counters shared by all the instrumented allocators with
+ * the same Tag
+ *
+ * Counters are updated atomically, so instrumented containers can live
+ * on any thread.
+ */
+template <class Tag> struct allocation_counters
+{
+  static inline tenno::size allocations = 0;
+  static inline tenno::size deallocations = 0;
+  static inline tenno::size bytes_allocated = 0;
+  static inline tenno::size bytes_in_use = 0;
+  static inline tenno::size peak_bytes_in_use = 0;
+  static inline tenno::size reallocations = 0;
+  static inline tenno::size bytes_moved = 0;
+  static inline tenno::size peak_capacity = 0;
+  static inline tenno::size peak_size = 0;
+  static inline tenno::size growth_capacity = 0;
+  static inline tenno::size growth_size = 0;
+
+  static void add(tenno::size &counter, tenno::size value) noexcept
+  {
+    __atomic_fetch_add(&counter, value, __ATOMIC_RELAXED);
+  }
+
+  static void update_max(tenno::size &peak, tenno::size value) noexcept
+  {
+    tenno::size current = __atomic_load_n(&peak, __ATOMIC_RELAXED);
+    while (current < value
+           && !__atomic_compare_exchange_n(&peak, &current, value, true,
+                                           __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+  }
+
+  static allocation_stats snapshot() noexcept
+  {
+    return allocation_stats{
+      __atomic_load_n(&allocations, __ATOMIC_RELAXED),
+      __atomic_load_n(&deallocations, __ATOMIC_RELAXED),
+      __atomic_load_n(&bytes_allocated, __ATOMIC_RELAXED),
+      __atomic_load_n(&bytes_in_use, __ATOMIC_RELAXED),
+      __atomic_load_n(&peak_bytes_in_use, __ATOMIC_RELAXED),
+      __atomic_load_n(&reallocations, __ATOMIC_RELAXED),
+      __atomic_load_n(&bytes_moved, __ATOMIC_RELAXED),
+      __atomic_load_n(&peak_capacity, __ATOMIC_RELAXED),
+      __atomic_load_n(&peak_size, __ATOMIC_RELAXED),
+      __atomic_load_n(&growth_capacity, __ATOMIC_RELAXED),
+      __atomic_load_n(&growth_size, __ATOMIC_RELAXED),
+    };
+  }
+
+  static void reset() noexcept
+  {
+    tenno::size *all[] = {&allocations,     &deallocations,
+                          &bytes_allocated, &bytes_in_use,
+                          &peak_bytes_in_use, &reallocations,
+                          &bytes_moved,     &peak_capacity,
+                          &peak_size,       &growth_capacity,
+                          &growth_size};
+    for (tenno::size *counter : all)
+    {
+      __atomic_store_n(counter, 0, __ATOMIC_RELAXED);
+    }
+  }
+};
+
+/**
+ * @brief An allocator that counts what goes through it
+ *
+ * Wraps Alloc and records allocations, deallocations and bytes in use.
+ * Containers that report their capacity changes, like tenno::vector,
+ * also record reallocations, the bytes they moved and the peak
+ * capacity against the size. The counters are grouped by Tag: the
+ * default groups them by element type, a dedicated tag type per call
+ * site tells apart the vectors of the same type.
+ *
+ * # Example
+ * ```cpp
+ * struct parser_tokens {};
+ * tenno::vector<int, tenno::instrumented_allocator<int, parser_tokens>> v;
+ * // ...
+ * auto stats = tenno::instrumented_allocator<int, parser_tokens>::snapshot();
+ * stats.print("parser tokens");
+ * ```
+ *
+ * @tparam T The type of the objects to allocate
+ * @tparam Tag The type that selects the counters
+ * @tparam Alloc The allocator that provides the memory
+ */
+template <class T, class Tag = T, class Alloc = tenno::allocator<T>>
+struct instrumented_allocator
+{
+  using value_type = T;
+  using pointer = T *;
+  using const_pointer = const T *;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = tenno::size;
+  using counters = tenno::allocation_counters<Tag>;
+
+  template <class U> struct rebind
+  {
+    using other = instrumented_allocator<
+      U, Tag, typename std::allocator_traits<Alloc>::template rebind_alloc<U>>;
+  };
+
+  template <class U, class, class> friend struct instrumented_allocator;
+
+  instrumented_allocator() = default;
+
+  explicit instrumented_allocator(const Alloc &alloc) : _alloc(alloc)
+  {
+  }
+
+  template <class U, class UAlloc>
+  instrumented_allocator(const instrumented_allocator<U, Tag, UAlloc> &other)
+      : _alloc(other._alloc)
+  {
+  }
+
+  T *allocate(tenno::size n)
+  {
+    T *p = _alloc.allocate(n);
+    counters::add(counters::allocations, 1);
+    counters::add(counters::bytes_allocated, n * sizeof(T));
+    tenno::size in_use =
+      __atomic_add_fetch(&counters::bytes_in_use, n * sizeof(T),
+                         __ATOMIC_RELAXED);
+    counters::update_max(counters::peak_bytes_in_use, in_use);
+    return p;
+  }
+
+  void deallocate(T *p, tenno::size n)
+  {
+    if (p == nullptr)
+    {
+      return;
+    }
+    _alloc.deallocate(p, n);
+    counters::add(counters::deallocations, 1);
+    __atomic_sub_fetch(&counters::bytes_in_use, n * sizeof(T),
+                       __ATOMIC_RELAXED);
+  }
+
+  /**
+   * @brief Resize a buffer in place, available if Alloc provides it
+   */
+  T *reallocate(T *p, tenno::size old_n, tenno::size new_n)
+    requires requires(Alloc &a) {
+      { a.reallocate(p, old_n, new_n) } -> std::same_as<T *>;
+    }
+  {
+    T *new_p = _alloc.reallocate(p, old_n, new_n);
+    if (new_p != nullptr)
+    {
+      // Only the difference is new memory, unsigned wrap around makes
+      // a shrink subtract
+      tenno::size delta = (new_n - old_n) * sizeof(T);
+      if (new_n > old_n)
+      {
+        counters::add(counters::bytes_allocated, delta);
+      }
+      tenno::size in_use =
+        __atomic_add_fetch(&counters::bytes_in_use, delta, __ATOMIC_RELAXED);
+      counters::update_max(counters::peak_bytes_in_use, in_use);
+    }
+    return new_p;
+  }
+
+  /**
+   * @brief Called by containers when the capacity of their buffer
+   * changes
+   *
+   * @param old_capacity The capacity before the change, 0 for the
+   * first allocation
+   * @param new_capacity The capacity after the change
+   * @param count The number of elements in the container
+   * @param moved The number of elements relocated to a new buffer, 0
+   * if the buffer was resized in place
+   */
+  void record_growth(tenno::size old_capacity, tenno::size new_capacity,
+                     tenno::size count, tenno::size moved) noexcept
+  {
+    if (old_capacity != 0)
+    {
+      counters::add(counters::reallocations, 1);
+      counters::add(counters::bytes_moved, moved * sizeof(T));
+    }
+    counters::update_max(counters::peak_capacity, new_capacity);
+    counters::update_max(counters::peak_size, count);
+    counters::add(counters::growth_capacity, new_capacity);
+    counters::add(counters::growth_size, count);
+  }
+
+  /**
+   * @brief Get the counters of Tag
+   */
+  static allocation_stats snapshot() noexcept
+  {
+    return counters::snapshot();
+  }
+
+  /**
+   * @brief Set the counters of Tag to zero
+   */
+  static void reset() noexcept
+  {
+    counters::reset();
+  }
+
+  bool operator==(const instrumented_allocator &other) const noexcept
+  {
+    return _alloc == other._alloc;
+  }
+
+  bool operator!=(const instrumented_allocator &other) const noexcept
+  {
+    return !(*this == other);
+  }
+
+private:
+  Alloc _alloc;
+};
+
+} // namespace tenno
@@ -0,0 +1,317 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <tenno/memory.hpp>
+#include <tenno/utility.hpp>
+#include <type_traits>
+#include <utility> // std::forward
+
+namespace tenno
+{
+
+/**
+ * @brief Reference count policy updating the count with atomic
+ * instructions, objects can be shared between threads
+ */
+struct thread_safe_counter
+{
+  static void increment(long &count) noexcept
+  {
+    __atomic_fetch_add(&count, 1, __ATOMIC_RELAXED);
+  }
+
+  /**
+   * @brief Decrement the count and return the new value
+   */
+  static long decrement(long &count) noexcept
+  {
+    return __atomic_sub_fetch(&count, 1, __ATOMIC_ACQ_REL);
+  }
+
+  static long load(const long &count) noexcept
+  {
+    return __atomic_load_n(&count, __ATOMIC_ACQUIRE);
+  }
+};
+
+/**
+ * @brief Reference count policy updating the count with plain
+ * instructions, all the references must live on one thread
+ */
+struct thread_unsafe_counter
+{
+  static void increment(long &count) noexcept
+  {
+    count++;
+  }
+
+  static long decrement(long &count) noexcept
+  {
+    return --count;
+  }
+
+  static long load(const long &count) noexcept
+  {
+    return count;
+  }
+};
+
+/**
+ * @brief A base class that embeds a reference count in the object
+ *
+ * Derive from intrusive_ref_counter to make a type usable with
+ * tenno::intrusive_ptr. The object is deleted as Derived when the
+ * last reference goes away. Copying an object does not copy its
+ * count, the copy starts with no references.
+ *
+ * # Example
+ * ```cpp
+ * struct node : tenno::intrusive_ref_counter<node>
+ * {
+ *   int value;
+ * };
+ * tenno::intrusive_ptr<node> n(new node());
+ * ```
+ *
+ * @tparam Derived The type deriving from this class
+ * @tparam Policy tenno::thread_safe_counter or
+ * tenno::thread_unsafe_counter
+ */
+template <class Derived, class Policy = tenno::thread_safe_counter>
+class intrusive_ref_counter
+{
+public:
+  constexpr intrusive_ref_counter() noexcept : _ref_count(0)
+  {
+  }
+
+  constexpr intrusive_ref_counter(const intrusive_ref_counter &) noexcept
+      : _ref_count(0)
+  {
+  }
+
+  intrusive_ref_counter &operator=(const intrusive_ref_counter &) noexcept
+  {
+    return *this;
+  }
+
+  /**
+   * @brief Get the number of intrusive_ptr referencing the object
+   */
+  long use_count() const noexcept
+  {
+    return Policy::load(this->_ref_count);
+  }
+
+  friend void intrusive_ptr_add_ref(const intrusive_ref_counter *p) noexcept
+  {
+    Policy::increment(p->_ref_count);
+  }
+
+  friend void intrusive_ptr_release(const intrusive_ref_counter *p) noexcept
+  {
+    if (Policy::decrement(p->_ref_count) == 0)
+    {
+      delete static_cast<const Derived *>(p);
+    }
+  }
+
+protected:
+  ~intrusive_ref_counter() = default;
+
+private:
+  mutable long _ref_count;
+};
+
+/**
+ * @brief A shared pointer to an object that holds its own reference
+ * count
+ *
+ * The pointer is a single word and there is no control block: copies
+ * call intrusive_ptr_add_ref and intrusive_ptr_release on the object,
+ * found by argument dependent lookup. Deriving from
+ * tenno::intrusive_ref_counter provides them.
+ *
+ * Since the count lives in the object, a raw pointer to an owned
+ * object can always be turned back into an intrusive_ptr.
+ *
+ * @tparam T The type of the object to point to
+ */
+template <class T> class intrusive_ptr
+{
+public:
+  using element_type = T;
+
+  template <class U> friend class intrusive_ptr;
+
+  constexpr intrusive_ptr() noexcept : _object(nullptr)
+  {
+  }
+
+  /**
+   * @brief Construct a new intrusive pointer to ptr
+   *
+   * @param ptr The object to point to
+   * @param add_ref Whether to take a new reference, false adopts a
+   * reference already counted in the object
+   */
+  intrusive_ptr(T *ptr, bool add_ref = true) noexcept : _object(ptr)
+  {
+    if (this->_object != nullptr && add_ref)
+      intrusive_ptr_add_ref(this->_object);
+  }
+
+  /**
+   * @brief Take the ownership of the object of a unique_ptr
+   */
+  template <class U>
+    requires std::is_convertible_v<U *, T *>
+  intrusive_ptr(tenno::unique_ptr<U> &&other) noexcept
+      : intrusive_ptr(other.release())
+  {
+  }
+
+  intrusive_ptr(const intrusive_ptr &other) noexcept
+      : intrusive_ptr(other._object)
+  {
+  }
+
+  intrusive_ptr(intrusive_ptr &&other) noexcept : _object(other._object)
+  {
+    other._object = nullptr;
+  }
+
+  template <class U>
+    requires std::is_convertible_v<U *, T *>
+  intrusive_ptr(const intrusive_ptr<U> &other) noexcept
+      : intrusive_ptr(other._object)
+  {
+  }
+
+  template <class U>
+    requires std::is_convertible_v<U *, T *>
+  intrusive_ptr(intrusive_ptr<U> &&other) noexcept : _object(other._object)
+  {
+    other._object = nullptr;
+  }
+
+  ~intrusive_ptr()
+  {
+    if (this->_object != nullptr)
+      intrusive_ptr_release(this->_object);
+  }
+
+  intrusive_ptr &operator=(const intrusive_ptr &other) noexcept
+  {
+    intrusive_ptr copy(other);
+    this->swap(copy);
+    return *this;
+  }
+
+  intrusive_ptr &operator=(intrusive_ptr &&other) noexcept
+  {
+    intrusive_ptr moved(tenno::move(other));
+    this->swap(moved);
+    return *this;
+  }
+
+  template <class U>
+  intrusive_ptr &operator=(const intrusive_ptr<U> &other) noexcept
+  {
+    intrusive_ptr copy(other);
+    this->swap(copy);
+    return *this;
+  }
+
+  intrusive_ptr &operator=(T *ptr) noexcept
+  {
+    intrusive_ptr copy(ptr);
+    this->swap(copy);
+    return *this;
+  }
+
+  /**
+   * @brief Release the reference and point to nothing
+   */
+  void reset() noexcept
+  {
+    intrusive_ptr().swap(*this);
+  }
+
+  /**
+   * @brief Release the reference and point to ptr
+   */
+  void reset(T *ptr, bool add_ref = true) noexcept
+  {
+    intrusive_ptr(ptr, add_ref).swap(*this);
+  }
+
+  /**
+   * @brief Give up the reference without releasing it
+   *
+   * @return T* The object, still counting the reference of this
+   * pointer
+   */
+  T *detach() noexcept
+  {
+    T *ptr        = this->_object;
+    this->_object = nullptr;
+    return ptr;
+  }
+
+  void swap(intrusive_ptr &other) noexcept
+  {
+    T *tmp        = this->_object;
+    this->_object = other._object;
+    other._object = tmp;
+  }
+
+  T *get() const noexcept
+  {
+    return this->_object;
+  }
+
+  T &operator*() const noexcept
+  {
+    return *this->_object;
+  }
+
+  T *operator->() const noexcept
+  {
+    return this->_object;
+  }
+
+  explicit operator bool() const noexcept
+  {
+    return this->_object != nullptr;
+  }
+
+  template <class U>
+  bool operator==(const intrusive_ptr<U> &other) const noexcept
+  {
+    return this->_object == other.get();
+  }
+
+  bool operator==(std::nullptr_t) const noexcept
+  {
+    return this->_object == nullptr;
+  }
+
+private:
+  T *_object;
+};
+
+/**
+ * @brief Create an object and an intrusive pointer to it
+ */
+template <class T, class... Args>
+tenno::intrusive_ptr<T> make_intrusive(Args &&...args)
+{
+  return tenno::intrusive_ptr<T>(new T(std::forward<Args>(args)...));
+}
+
+} // namespace tenno
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <compare>  // std::strong_ordering
+#include <cstddef>  // std::ptrdiff_t
+#include <iterator> // std::contiguous_iterator_tag
+#include <type_traits>
+
+namespace tenno
+{
+
+/**
+ * @brief An iterator over contiguous storage, backed by a raw pointer
+ *
+ * Models std::contiguous_iterator, so standard and tenno algorithms can
+ * use random access and bulk memory operations on the range, and
+ * a loop over it compiles to the same code as a loop over a pointer.
+ *
+ * @tparam T The type of the elements, const qualified for constant
+ * iterators
+ */
+template <class T> class contiguous_iterator
+{
+public:
+  using iterator_concept = std::contiguous_iterator_tag;
+  using iterator_category = std::random_access_iterator_tag;
+  using difference_type = std::ptrdiff_t;
+  using value_type = std::remove_cv_t<T>;
+  using element_type = T;
+  using pointer = T *;
+  using reference = T &;
+
+  constexpr contiguous_iterator() noexcept : _ptr(nullptr)
+  {
+  }
+
+  constexpr explicit contiguous_iterator(T *ptr) noexcept : _ptr(ptr)
+  {
+  }
+
+  // Conversion from iterator to const_iterator
+  template <class U>
+    requires std::is_convertible_v<U *, T *>
+  constexpr contiguous_iterator(const contiguous_iterator<U> &other) noexcept
+      : _ptr(other.operator->())
+  {
+  }
+
+  constexpr T &operator*() const noexcept
+  {
+    return *_ptr;
+  }
+
+  constexpr T *operator->() const noexcept
+  {
+    return _ptr;
+  }
+
+  constexpr T &operator[](difference_type n) const noexcept
+  {
+    return _ptr[n];
+  }
+
+  /**
+   * @brief Get the element pointed to by the iterator
+   */
+  constexpr T &get() const noexcept
+  {
+    return *_ptr;
+  }
+
+  constexpr contiguous_iterator &operator++() noexcept
+  {
+    ++_ptr;
+    return *this;
+  }
+
+  constexpr contiguous_iterator operator++(int) noexcept
+  {
+    contiguous_iterator _iterator = *this;
+    ++_ptr;
+    return _iterator;
+  }
+
+  constexpr contiguous_iterator &operator--() noexcept
+  {
+    --_ptr;
+    return *this;
+  }
+
+  constexpr contiguous_iterator operator--(int) noexcept
+  {
+    contiguous_iterator _iterator = *this;
+    --_ptr;
+    return _iterator;
+  }
+
+  constexpr contiguous_iterator &operator+=(difference_type n) noexcept
+  {
+    _ptr += n;
+    return *this;
+  }
+
+  constexpr contiguous_iterator &operator-=(difference_type n) noexcept
+  {
+    _ptr -= n;
+    return *this;
+  }
+
+  constexpr contiguous_iterator operator+(difference_type n) const noexcept
+  {
+    return contiguous_iterator(_ptr + n);
+  }
+
+  friend constexpr contiguous_iterator
+  operator+(difference_type n, const contiguous_iterator &it) noexcept
+  {
+    return contiguous_iterator(it._ptr + n);
+  }
+
+  constexpr contiguous_iterator operator-(difference_type n) const noexcept
+  {
+    return contiguous_iterator(_ptr - n);
+  }
+
+  template <class U>
+  constexpr difference_type
+  operator-(const contiguous_iterator<U> &other) const noexcept
+  {
+    return _ptr - other.operator->();
+  }
+
+  template <class U>
+  constexpr bool operator==(const contiguous_iterator<U> &other) const noexcept
+  {
+    return _ptr == other.operator->();
+  }
+
+  template <class U>
+  constexpr std::strong_ordering
+  operator<=>(const contiguous_iterator<U> &other) const noexcept
+  {
+    return _ptr <=> other.operator->();
+  }
+
+private:
+  T *_ptr;
+};
+
+} // namespace tenno
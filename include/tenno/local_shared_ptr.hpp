@@ -0,0 +1,621 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <memory> // std::construct_at, std::destroy_at
+#include <new>    // std::launder
+#include <tenno/algorithm.hpp>
+#include <tenno/memory.hpp>
+#include <tenno/types.hpp>
+#include <tenno/utility.hpp>
+#include <type_traits>
+#include <utility> // std::forward
+
+namespace tenno
+{
+
+template <class T> class local_weak_ptr;
+
+struct local_control_block;
+
+/**
+ * @brief The operations of a local control block that stores its
+ * object, see tenno::local_control_block_ops_of
+ */
+struct local_control_block_ops
+{
+  // Destroy the object stored in the block
+  void (*dispose)(local_control_block *cb) noexcept;
+  // Free the block
+  void (*destroy)(local_control_block *cb) noexcept;
+};
+
+template <class Block>
+inline constexpr local_control_block_ops local_control_block_ops_of = {
+  &Block::dispose,
+  &Block::destroy,
+};
+
+/**
+ * @brief The reference counts shared by local_shared_ptr and
+ * local_weak_ptr
+ *
+ * The counts are plain integers. A block made from a thread-safe
+ * shared pointer holds one strong reference on the control block that
+ * owns the object, which is released when the last local_shared_ptr
+ * goes away.
+ *
+ * A block made by make_local_shared stores the object itself and has
+ * no thread-safe block until the object escapes, see
+ * tenno::local_escape_block. From then on the escape block owns the
+ * object and the memory of the local block.
+ */
+struct local_control_block
+{
+  // Null if owner owns the object and the block was allocated with new
+  const local_control_block_ops *ops;
+  long                           num_ptrs      = 1;
+  long                           num_weak_ptrs = 1;
+  control_block_base            *owner;
+
+  explicit local_control_block(control_block_base *owner_block) noexcept
+      : ops(nullptr), owner(owner_block)
+  {
+  }
+
+  explicit local_control_block(
+    const local_control_block_ops *block_ops) noexcept
+      : ops(block_ops), owner(nullptr)
+  {
+  }
+
+  void add_ref() noexcept
+  {
+    this->num_ptrs++;
+  }
+
+  void release() noexcept
+  {
+    if (--this->num_ptrs == 0)
+    {
+      if (this->owner)
+      {
+        this->owner->release();
+      }
+      else
+      {
+        this->ops->dispose(this);
+      }
+      this->weak_release();
+    }
+  }
+
+  void add_weak_ref() noexcept
+  {
+    this->num_weak_ptrs++;
+  }
+
+  void weak_release() noexcept
+  {
+    if (--this->num_weak_ptrs == 0)
+    {
+      if (this->ops == nullptr)
+      {
+        delete this;
+      }
+      else if (this->owner)
+      {
+        // The escape block frees this block once no thread-safe
+        // pointer is left
+        this->owner->weak_release();
+      }
+      else
+      {
+        this->ops->destroy(this);
+      }
+    }
+  }
+
+  /**
+   * @brief Get the thread-safe block that owns the object, creating
+   * it if the object is stored in this block
+   */
+  control_block_base *escape();
+};
+
+/**
+ * @brief The thread-safe control block of an object stored in a
+ * local control block
+ *
+ * Created the first time the object escapes to a tenno::shared_ptr.
+ * The local pointers together hold one strong reference on it, and
+ * the local block holds one weak reference until its own weak count
+ * drops to zero. The object is destroyed with the last strong
+ * reference, the local block is freed with the last weak one, on
+ * whichever thread drops them.
+ */
+struct local_escape_block : control_block_base
+{
+  // The object lives in the local block
+  static constexpr bool fixed_object = true;
+
+  local_control_block *local;
+
+  explicit local_escape_block(local_control_block *local_block) noexcept
+      : control_block_base(&tenno::control_block_ops_of<local_escape_block>),
+        local(local_block)
+  {
+    // The weak reference of the local block
+    this->num_weak_ptrs = 2;
+  }
+
+  static void dispose(control_block_base *base) noexcept
+  {
+    local_control_block *cb = static_cast<local_escape_block *>(base)->local;
+    cb->ops->dispose(cb);
+  }
+
+  static void destroy(control_block_base *base) noexcept
+  {
+    auto *cb = static_cast<local_escape_block *>(base);
+    cb->local->ops->destroy(cb->local);
+    delete cb;
+  }
+};
+
+inline control_block_base *local_control_block::escape()
+{
+  if (this->owner == nullptr)
+  {
+    this->owner = new local_escape_block(this);
+  }
+  return this->owner;
+}
+
+/**
+ * @brief A local control block that stores the object inline
+ *
+ * Used by make_local_shared: the object and the local counts live in
+ * a single allocation.
+ *
+ * @tparam T The type of the object
+ */
+template <class T> struct local_inplace_block : local_control_block
+{
+  alignas(T) unsigned char storage[sizeof(T)];
+
+  template <class... Args>
+  explicit local_inplace_block(Args &&...args)
+      : local_control_block(
+          &tenno::local_control_block_ops_of<local_inplace_block>)
+  {
+    std::construct_at(reinterpret_cast<T *>(this->storage),
+                      std::forward<Args>(args)...);
+  }
+
+  T *get_object() noexcept
+  {
+    return std::launder(reinterpret_cast<T *>(this->storage));
+  }
+
+  static void dispose(local_control_block *base) noexcept
+  {
+    std::destroy_at(static_cast<local_inplace_block *>(base)->get_object());
+  }
+
+  static void destroy(local_control_block *base) noexcept
+  {
+    delete static_cast<local_inplace_block *>(base);
+  }
+};
+
+/**
+ * @brief A shared pointer whose reference count is not thread-safe
+ *
+ * local_shared_ptr has the same interface as tenno::shared_ptr, but
+ * copies and destructions update a plain integer instead of an atomic
+ * one. All the copies of a local_shared_ptr, and the local_weak_ptr
+ * made from them, must be used by a single thread.
+ *
+ * When an object has to escape its thread, a local_shared_ptr
+ * converts to a tenno::shared_ptr that shares the ownership of the
+ * same object. Only the conversion touches the atomic count. Objects
+ * made by make_local_shared get their thread-safe control block at
+ * the first conversion, so those that never escape cost a single
+ * allocation and no atomic instruction.
+ *
+ * # Example
+ * ```cpp
+ * auto node = tenno::make_local_shared<node_t>(42);
+ * auto copy = node; // no atomic instruction
+ * tenno::shared_ptr<node_t> escaped = node;
+ * ```
+ *
+ * @tparam T The type of the object to point to
+ */
+template <class T> class local_shared_ptr
+{
+public:
+  /**
+   * @brief The type of the object to point to
+   */
+  using element_type = T;
+
+  template <class Y> friend class local_shared_ptr;
+  friend class tenno::local_weak_ptr<T>;
+  template <class Y, class... Args>
+  friend local_shared_ptr<Y> make_local_shared(Args &&...args);
+
+  /**
+   * @brief Default constructor
+   */
+  constexpr local_shared_ptr() noexcept
+      : _object(nullptr), _control_block(nullptr)
+  {
+  }
+
+  /**
+   * @brief Construct a new local shared pointer owning ptr
+   */
+  explicit local_shared_ptr(T *ptr)
+      : local_shared_ptr(tenno::shared_ptr<T>(ptr))
+  {
+  }
+
+  /**
+   * @brief Construct a new local shared pointer owning ptr, deleted
+   * with deleter
+   */
+  template <class Deleter>
+  local_shared_ptr(T *ptr, Deleter deleter)
+      : local_shared_ptr(tenno::shared_ptr<T, Deleter>(ptr, deleter))
+  {
+  }
+
+  /**
+   * @brief Share the ownership of a thread-safe shared pointer
+   *
+   * The local pointers together hold a single reference on sp.
+   */
+  template <class U, class D, class A>
+  explicit local_shared_ptr(tenno::shared_ptr<U, D, A> sp)
+      : _object(sp._object), _control_block(nullptr)
+  {
+    if (sp._control_block)
+    {
+      this->_control_block = new local_control_block(sp._control_block);
+      sp._object           = nullptr;
+      sp._control_block    = nullptr;
+    }
+  }
+
+  local_shared_ptr(const local_shared_ptr &other) noexcept
+      : _object(other._object), _control_block(other._control_block)
+  {
+    if (this->_control_block)
+      this->_control_block->add_ref();
+  }
+
+  local_shared_ptr(local_shared_ptr &&other) noexcept
+      : _object(other._object), _control_block(other._control_block)
+  {
+    other._object        = nullptr;
+    other._control_block = nullptr;
+  }
+
+  /**
+   * @brief Conversion constructor
+   */
+  template <class U>
+  local_shared_ptr(const local_shared_ptr<U> &other) noexcept
+      : _object(other._object), _control_block(other._control_block)
+  {
+    if (this->_control_block)
+      this->_control_block->add_ref();
+  }
+
+  /**
+   * @brief Aliasing constructor
+   */
+  template <class U>
+  local_shared_ptr(const local_shared_ptr<U> &other, T *object) noexcept
+      : _object(object), _control_block(other._control_block)
+  {
+    if (this->_control_block)
+      this->_control_block->add_ref();
+  }
+
+  template <class U>
+  local_shared_ptr(local_shared_ptr<U> &&other) noexcept
+      : _object(other._object), _control_block(other._control_block)
+  {
+    other._object        = nullptr;
+    other._control_block = nullptr;
+  }
+
+  ~local_shared_ptr()
+  {
+    this->reset();
+  }
+
+  local_shared_ptr &operator=(const local_shared_ptr &other) noexcept
+  {
+    local_shared_ptr copy(other);
+    this->swap(copy);
+    return *this;
+  }
+
+  local_shared_ptr &operator=(local_shared_ptr &&other) noexcept
+  {
+    local_shared_ptr moved(tenno::move(other));
+    this->swap(moved);
+    return *this;
+  }
+
+  template <class U>
+  local_shared_ptr &operator=(const local_shared_ptr<U> &other) noexcept
+  {
+    local_shared_ptr copy(other);
+    this->swap(copy);
+    return *this;
+  }
+
+  template <class U>
+  local_shared_ptr &operator=(local_shared_ptr<U> &&other) noexcept
+  {
+    local_shared_ptr moved(tenno::move(other));
+    this->swap(moved);
+    return *this;
+  }
+
+  /**
+   * @brief Get a thread-safe shared pointer to the same object
+   *
+   * The returned pointer shares the ownership with this one and can
+   * be handed to other threads. The first conversion of an object made
+   * by make_local_shared allocates its thread-safe control block.
+   */
+  template <class U>
+    requires std::is_convertible_v<T *, U *>
+  operator tenno::shared_ptr<U>() const
+  {
+    tenno::shared_ptr<U> sp;
+    if (this->_control_block)
+    {
+      control_block_base *owner = this->_control_block->escape();
+      owner->add_ref();
+      sp._object        = this->_object;
+      sp._control_block = owner;
+    }
+    return sp;
+  }
+
+  /**
+   * @brief Reset the local shared pointer
+   */
+  void reset() noexcept
+  {
+    if (!this->_control_block)
+      return;
+
+    this->_control_block->release();
+
+    this->_object        = nullptr;
+    this->_control_block = nullptr;
+  }
+
+  /**
+   * @brief Swap the local shared pointer with another one
+   */
+  void swap(local_shared_ptr &other) noexcept
+  {
+    tenno::swap(this->_object, other._object);
+    tenno::swap(this->_control_block, other._control_block);
+  }
+
+  /**
+   * @brief Get the object pointed to by the local shared pointer
+   */
+  T *get() const noexcept
+  {
+    return this->_object;
+  }
+
+  T &operator*() const noexcept
+  {
+    return *this->_object;
+  }
+
+  T *operator->() const noexcept
+  {
+    return this->_object;
+  }
+
+  auto &operator[](tenno::size index) const noexcept
+  {
+    return (*this->_object)[index];
+  }
+
+  /**
+   * @brief Get the number of local shared pointers pointing to the
+   * object
+   *
+   * Thread-safe shared pointers made from this one are not counted.
+   */
+  long use_count() const noexcept
+  {
+    if (!this->_control_block)
+      return 0;
+    return this->_control_block->num_ptrs;
+  }
+
+  explicit operator bool() const noexcept
+  {
+    return this->_object != nullptr;
+  }
+
+  template <class U>
+  bool owner_before(const local_shared_ptr<U> &other) const noexcept
+  {
+    return this->_control_block < other._control_block;
+  }
+
+  template <class U>
+  bool owner_equal(const local_shared_ptr<U> &other) const noexcept
+  {
+    return this->_control_block == other._control_block;
+  }
+
+private:
+  T                   *_object;
+  local_control_block *_control_block;
+};
+
+/**
+ * @brief A weak pointer to an object owned by local_shared_ptr
+ *
+ * Like local_shared_ptr, it must not be shared between threads.
+ *
+ * @tparam T The type of the object to point to
+ */
+template <class T> class local_weak_ptr
+{
+public:
+  /**
+   * @brief The type of the object to point to
+   */
+  using element_type = T;
+
+  constexpr local_weak_ptr() noexcept
+      : _object(nullptr), _control_block(nullptr)
+  {
+  }
+
+  local_weak_ptr(const local_weak_ptr &r) noexcept
+      : _object(r._object), _control_block(r._control_block)
+  {
+    if (this->_control_block)
+      this->_control_block->add_weak_ref();
+  }
+
+  local_weak_ptr(local_weak_ptr &&r) noexcept
+      : _object(r._object), _control_block(r._control_block)
+  {
+    r._object        = nullptr;
+    r._control_block = nullptr;
+  }
+
+  local_weak_ptr(const tenno::local_shared_ptr<T> &r) noexcept
+      : _object(r._object), _control_block(r._control_block)
+  {
+    if (this->_control_block)
+      this->_control_block->add_weak_ref();
+  }
+
+  ~local_weak_ptr()
+  {
+    this->reset();
+  }
+
+  local_weak_ptr &operator=(const local_weak_ptr &r) noexcept
+  {
+    local_weak_ptr copy(r);
+    this->swap(copy);
+    return *this;
+  }
+
+  local_weak_ptr &operator=(local_weak_ptr &&r) noexcept
+  {
+    local_weak_ptr moved(tenno::move(r));
+    this->swap(moved);
+    return *this;
+  }
+
+  local_weak_ptr &operator=(const tenno::local_shared_ptr<T> &r) noexcept
+  {
+    local_weak_ptr copy(r);
+    this->swap(copy);
+    return *this;
+  }
+
+  void reset() noexcept
+  {
+    if (this->_control_block)
+      this->_control_block->weak_release();
+
+    this->_object        = nullptr;
+    this->_control_block = nullptr;
+  }
+
+  void swap(local_weak_ptr &r) noexcept
+  {
+    tenno::swap(this->_object, r._object);
+    tenno::swap(this->_control_block, r._control_block);
+  }
+
+  long use_count() const noexcept
+  {
+    if (!this->_control_block)
+      return 0;
+    return this->_control_block->num_ptrs;
+  }
+
+  bool expired() const noexcept
+  {
+    return this->use_count() == 0;
+  }
+
+  /**
+   * @brief Get a local shared pointer to the object, empty if the
+   * object was destroyed
+   */
+  tenno::local_shared_ptr<T> lock() const noexcept
+  {
+    tenno::local_shared_ptr<T> sp;
+    if (this->expired())
+      return sp;
+
+    this->_control_block->add_ref();
+    sp._object        = this->_object;
+    sp._control_block = this->_control_block;
+    return sp;
+  }
+
+  template <class U>
+  bool owner_before(const local_weak_ptr<U> &other) const noexcept
+  {
+    return this->_control_block < other._control_block;
+  }
+
+  template <class U>
+  bool owner_before(const tenno::local_shared_ptr<U> &other) const noexcept
+  {
+    return this->_control_block < other._control_block;
+  }
+
+private:
+  T                   *_object;
+  local_control_block *_control_block;
+};
+
+/**
+ * @brief Create a local shared pointer with the given arguments
+ *
+ * The object is allocated together with its local counts. The
+ * thread-safe control block is only made if the object escapes to a
+ * tenno::shared_ptr.
+ */
+template <class T, class... Args>
+local_shared_ptr<T> make_local_shared(Args &&...args)
+{
+  auto *cb = new local_inplace_block<T>(std::forward<Args>(args)...);
+  local_shared_ptr<T> sp;
+  sp._object        = cb->get_object();
+  sp._control_block = cb;
+  return sp;
+}
+
+} // namespace tenno
@@ -5,10 +5,17 @@
 
 #pragma once
 
-#include <tenno/mutex.hpp>
+#include <cstdio>   // std::fprintf
+#include <cstdlib>  // std::abort
+#include <cstring>  // std::memcpy
+#include <iterator> // std::contiguous_iterator
+#include <memory>   // std::to_address
+#include <new>      // placement new, std::align_val_t
+#include <tenno/type_traits.hpp>
 #include <tenno/types.hpp>
 #include <tenno/utility.hpp>
 #include <type_traits>
+#include <utility> // std::move_if_noexcept
 
 namespace tenno
 {
@@ -28,6 +35,16 @@ struct custom_allocator
 };
 */
 
+/**
+ * @brief The default allocator
+ *
+ * Types aligned beyond __STDCPP_DEFAULT_NEW_ALIGNMENT__, such as SIMD
+ * vectors or structures padded to a cache line, get memory from the
+ * aligned ::operator new, so every object in the buffer is correctly
+ * aligned.
+ *
+ * @tparam T The type of the objects to allocate
+ */
 template <class T> struct allocator
 {
   using value_type = T;
@@ -37,19 +54,49 @@ template <class T> struct allocator
   using const_referemce = const T &;
   using size_type = tenno::size;
 
-  allocator() noexcept = default;
+  /**
+   * @brief Whether T needs the aligned ::operator new
+   */
+  static constexpr bool is_over_aligned =
+    alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+  constexpr allocator() noexcept = default;
   
-  template <class U> allocator(const allocator<U> &) noexcept
+  template <class U> constexpr allocator(const allocator<U> &) noexcept
   {
   }
 
-  T *allocate(tenno::size n)
+  // During constant evaluation the memory comes from std::allocator,
+  // the only allocator the compiler can track
+  constexpr T *allocate(tenno::size n)
   {
+    if (std::is_constant_evaluated())
+    {
+      return std::allocator<T>().allocate(n);
+    }
+    if constexpr (is_over_aligned)
+    {
+      return (T *) ::operator new(n * sizeof(T),
+                                  std::align_val_t(alignof(T)));
+    }
     return (T *) ::operator new(n * sizeof(T));
   }
 
-  void deallocate(T *p, tenno::size n)
+  constexpr void deallocate(T *p, tenno::size n)
   {
+    if (std::is_constant_evaluated())
+    {
+      if (p != nullptr)
+      {
+        std::allocator<T>().deallocate(p, n);
+      }
+      return;
+    }
+    if constexpr (is_over_aligned)
+    {
+      ::operator delete(p, n * sizeof(T), std::align_val_t(alignof(T)));
+      return;
+    }
     ::operator delete(p, n * sizeof(T));
   }
 
@@ -64,13 +111,206 @@ template <class T> struct allocator
   }
 };
 
+/**
+ * @brief An allocator returning memory aligned to at least Align bytes
+ *
+ * Use it to give a container a buffer suitable for aligned SIMD loads
+ * even when T itself is not over-aligned, for example a
+ * tenno::vector<float> processed with 64 byte AVX-512 loads, or to put
+ * every buffer on its own cache lines.
+ *
+ * # Example
+ * ```cpp
+ * tenno::vector<float, tenno::aligned_allocator<float, 64>> v(1024);
+ * // v.data() is aligned to 64 bytes
+ * ```
+ *
+ * @tparam T The type of the objects to allocate
+ * @tparam Align The alignment of the buffers, a power of two
+ */
+template <class T, tenno::size Align = 64> struct aligned_allocator
+{
+  static_assert(Align != 0 && (Align & (Align - 1)) == 0,
+                "Align must be a power of two");
+
+  using value_type = T;
+  using pointer = T *;
+  using const_pointer = const T *;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = tenno::size;
+
+  /**
+   * @brief The alignment of the buffers, Align or alignof(T) if larger
+   */
+  static constexpr tenno::size alignment =
+    Align > alignof(T) ? Align : alignof(T);
+
+  template <class U> struct rebind
+  {
+    using other = aligned_allocator<U, Align>;
+  };
+
+  constexpr aligned_allocator() noexcept = default;
+
+  template <class U>
+  constexpr aligned_allocator(const aligned_allocator<U, Align> &) noexcept
+  {
+  }
+
+  T *allocate(tenno::size n)
+  {
+    return (T *) ::operator new(n * sizeof(T), std::align_val_t(alignment));
+  }
+
+  void deallocate(T *p, tenno::size n) noexcept
+  {
+    ::operator delete(p, n * sizeof(T), std::align_val_t(alignment));
+  }
+
+  constexpr bool operator==(const aligned_allocator &) const noexcept
+  {
+    return true;
+  }
+
+  constexpr bool operator!=(const aligned_allocator &) const noexcept
+  {
+    return false;
+  }
+};
+
+/**
+ * @brief Relocate count objects from first into the uninitialized
+ * storage starting at d_first
+ *
+ * After the call the objects in [first, first + count) are destroyed
+ * and [d_first, d_first + count) holds their values. The two ranges
+ * must not overlap. Trivially relocatable types are copied with a
+ * single memcpy, other types are moved and destroyed one by one, as
+ * is everything during constant evaluation.
+ *
+ * If the move constructor of T can throw, the objects are copied when
+ * T is copyable, like std::move_if_noexcept, and the sources are only
+ * destroyed once every object is built. On an exception the objects
+ * built so far are destroyed and the sources are left in place, so a
+ * failed relocation does not lose elements.
+ *
+ * @tparam T The type of the objects to relocate
+ * @param first Pointer to the first object to relocate
+ * @param count The number of objects to relocate
+ * @param d_first Pointer to the destination storage
+ * @return T* Pointer past the last relocated object in the destination
+ */
+template <class T>
+constexpr T *uninitialized_relocate_n(T *first, tenno::size count,
+                                      T *d_first)
+  noexcept(tenno::is_trivially_relocatable_v<T>
+           || std::is_nothrow_move_constructible_v<T>)
+{
+  if constexpr (tenno::is_trivially_relocatable_v<T>)
+  {
+    if (!std::is_constant_evaluated())
+    {
+      if (count != 0)
+      {
+        std::memcpy(static_cast<void *>(d_first),
+                    static_cast<const void *>(first), count * sizeof(T));
+      }
+      return d_first + count;
+    }
+  }
+  // Relocatable types only get here during constant evaluation
+  if constexpr (tenno::is_trivially_relocatable_v<T>
+                || std::is_nothrow_move_constructible_v<T>)
+  {
+    for (tenno::size i = 0; i < count; ++i)
+    {
+      std::construct_at(&d_first[i], tenno::move(first[i]));
+      std::destroy_at(&first[i]);
+    }
+  }
+  else
+  {
+    tenno::size i = 0;
+    try
+    {
+      for (; i < count; ++i)
+      {
+        std::construct_at(&d_first[i], std::move_if_noexcept(first[i]));
+      }
+    }
+    catch (...)
+    {
+      std::destroy_n(d_first, i);
+      throw;
+    }
+    std::destroy_n(first, count);
+  }
+  return d_first + count;
+}
+
+/**
+ * @brief Copy count elements starting at first into the uninitialized
+ * storage starting at d_first
+ *
+ * If first is a contiguous iterator over T and T is trivially copyable
+ * the elements are copied with a single memcpy, except during
+ * constant evaluation. If a copy throws, the objects already
+ * constructed are destroyed before the exception is rethrown.
+ *
+ * @tparam InputIt The type of the source iterator
+ * @tparam T The type of the objects to construct
+ * @param first Iterator to the first element to copy
+ * @param count The number of elements to copy
+ * @param d_first Pointer to the destination storage
+ * @return T* Pointer past the last constructed object
+ */
+template <class InputIt, class T>
+constexpr T *uninitialized_copy_n(InputIt first, tenno::size count,
+                                  T *d_first)
+{
+  if constexpr (std::contiguous_iterator<InputIt>
+                && std::is_same_v<std::iter_value_t<InputIt>, T>
+                && std::is_trivially_copyable_v<T>)
+  {
+    if (!std::is_constant_evaluated())
+    {
+      if (count != 0)
+      {
+        std::memcpy(static_cast<void *>(d_first),
+                    static_cast<const void *>(std::to_address(first)),
+                    count * sizeof(T));
+      }
+      return d_first + count;
+    }
+  }
+  tenno::size i = 0;
+  try
+  {
+    for (; i < count; ++i, ++first)
+    {
+      std::construct_at(&d_first[i], *first);
+    }
+  }
+  catch (...)
+  {
+    std::destroy_n(d_first, i);
+    throw;
+  }
+  return d_first + count;
+}
+
 template <typename T> struct default_delete
 {
   default_delete() noexcept = default;
   
   void operator()(T *ptr) const noexcept
   {
-    delete ptr;
+    // make_shared<T[N]>(n) allocates with new[]
+    if constexpr (std::is_array<T>::value)
+      delete[] ptr;
+    else
+      delete ptr;
   }
   
   template <typename U> void operator()(U *ptr) const noexcept
@@ -79,24 +319,264 @@ template <typename T> struct default_delete
   }
 };
 
+/**
+ * @brief Deleter of arrays allocated with new[]
+ */
+template <typename T> struct default_delete<T[]>
+{
+  default_delete() noexcept = default;
+
+  void operator()(T *ptr) const noexcept
+  {
+    delete[] ptr;
+  }
+
+  /**
+   * @brief shared_ptr<T[]> points to the whole array
+   */
+  void operator()(T (*ptr)[]) const noexcept
+  {
+    T *first = *ptr;
+    delete[] first;
+  }
+};
+
+/**
+ * @brief Tag that asks a factory to default initialize the object
+ *
+ * Passed to tenno::allocate_shared as the only argument, the object is
+ * created with `new T` instead of `new T()`, so trivial types are left
+ * uninitialized. Used by the for_overwrite factories.
+ */
+struct default_init_t
+{
+  explicit default_init_t() = default;
+};
+
+inline constexpr default_init_t default_init{};
+
 template <class T> class weak_ptr;
+template <class T> class local_shared_ptr;
+template <typename T> class atomic;
 
+struct control_block_base;
+
+/**
+ * @brief The operations of a control block that depend on its type
+ *
+ * Every control block type has one constant table, so a block carries
+ * a single pointer to it and the table is only read when the object
+ * or the block is destroyed.
+ */
+struct control_block_ops
+{
+  // Destroy the object, called when the last shared reference goes
+  void (*dispose)(control_block_base *cb) noexcept;
+  // Free the block, called when the last weak reference goes
+  void (*destroy)(control_block_base *cb) noexcept;
+  // Whether dispose destroys an object tied to the block, such as one
+  // stored inside it, instead of the one pointed to by object
+  bool fixed_object;
+};
+
+/**
+ * @brief The operations table of the control block type Block, which
+ * provides them as static dispose and destroy functions
+ */
+template <class Block>
+inline constexpr control_block_ops control_block_ops_of = {
+  &Block::dispose,
+  &Block::destroy,
+  requires { requires Block::fixed_object; },
+};
+
+/**
+ * @brief The reference counts shared by shared_ptr and weak_ptr
+ *
+ * The counts are updated with atomic instructions, no lock is taken.
+ * All the shared pointers together hold one weak reference, which is
+ * released when the last of them is destroyed. This way the control
+ * block is freed exactly once, by whoever drops the weak count to
+ * zero.
+ */
 struct control_block_base
 {
-  long num_ptrs         = 0;
-  long num_weak_ptrs    = 0;
-  tenno::mutex cb_mutex = {};
+  const control_block_ops *ops;
+  long                     num_ptrs      = 1;
+  long                     num_weak_ptrs = 1;
+  // The owned object, shared pointers keep their own copy of it
+  void                    *object        = nullptr;
+
+  explicit control_block_base(const control_block_ops *block_ops) noexcept
+      : ops(block_ops)
+  {
+  }
+
+  // Free the stored object
+  void dispose_object() noexcept
+  {
+    this->ops->dispose(this);
+  }
 
   // Deallocate this control block
   // Only call this when num_ptrs == 0 AND num_weak_ptrs == 0
-  virtual void deallocate()     = 0;
-  // Free the stored object
-  virtual void dispose_object() = 0;
+  void deallocate() noexcept
+  {
+    this->ops->destroy(this);
+  }
 
-  virtual void set_ptr(void* ptr) = 0;
-  virtual void* get_ptr() = 0;
-  
-  virtual ~control_block_base() = default;
+  void set_ptr(void *ptr) noexcept
+  {
+    this->object = ptr;
+  }
+
+  void *get_ptr() const noexcept
+  {
+    return this->object;
+  }
+
+  // Whether the object can be swapped with the one of another block,
+  // the block then disposes of whatever object points to
+  static bool can_swap_objects(const control_block_base *a,
+                               const control_block_base *b) noexcept
+  {
+    return a != nullptr && b != nullptr && !a->ops->fixed_object
+           && !b->ops->fixed_object;
+  }
+
+  // A new reference can only be made from an existing one, so nothing
+  // needs to be ordered with the increment
+  void add_ref() noexcept
+  {
+    __atomic_fetch_add(&this->num_ptrs, 1, __ATOMIC_RELAXED);
+  }
+
+  void add_refs(long count) noexcept
+  {
+    __atomic_fetch_add(&this->num_ptrs, count, __ATOMIC_RELAXED);
+  }
+
+  // Take a strong reference only if the object is still alive
+  bool add_ref_lock() noexcept
+  {
+    long count = __atomic_load_n(&this->num_ptrs, __ATOMIC_RELAXED);
+    while (count != 0)
+    {
+      if (__atomic_compare_exchange_n(&this->num_ptrs, &count, count + 1,
+                                      true, __ATOMIC_ACQ_REL,
+                                      __ATOMIC_RELAXED))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // The acq_rel decrement makes every write to the object happen
+  // before the object is destroyed
+  void release() noexcept
+  {
+    if (__atomic_fetch_sub(&this->num_ptrs, 1, __ATOMIC_ACQ_REL) == 1)
+    {
+      this->dispose_object();
+      this->weak_release();
+    }
+  }
+
+  void add_weak_ref() noexcept
+  {
+    __atomic_fetch_add(&this->num_weak_ptrs, 1, __ATOMIC_RELAXED);
+  }
+
+  void weak_release() noexcept
+  {
+    if (__atomic_fetch_sub(&this->num_weak_ptrs, 1, __ATOMIC_ACQ_REL) == 1)
+    {
+      this->deallocate();
+    }
+  }
+
+  long use_count() const noexcept
+  {
+    return __atomic_load_n(&this->num_ptrs, __ATOMIC_ACQUIRE);
+  }
+};
+
+/**
+ * @brief A control block that stores the object inline
+ *
+ * Used by make_shared and allocate_shared: the object and the
+ * reference counts live in a single allocation made through Alloc,
+ * rebound to the block type.
+ *
+ * @tparam T The type of the object
+ * @tparam Alloc The allocator used for the block
+ */
+template <class T, class Alloc>
+struct inplace_control_block : control_block_base
+{
+  // The object lives in storage, it can not be handed to another block
+  static constexpr bool fixed_object = true;
+
+  using block_allocator = typename std::allocator_traits<
+    Alloc>::template rebind_alloc<inplace_control_block>;
+
+  [[no_unique_address]] Alloc allocator;
+  alignas(T) unsigned char storage[sizeof(T)];
+
+  template <class... Args>
+  inplace_control_block(const Alloc &alloc, Args &&...args)
+      : control_block_base(&tenno::control_block_ops_of<inplace_control_block>),
+        allocator(alloc)
+  {
+    this->object = std::construct_at(reinterpret_cast<T *>(this->storage),
+                                     std::forward<Args>(args)...);
+  }
+
+  inplace_control_block(const Alloc &alloc, tenno::default_init_t)
+      : control_block_base(&tenno::control_block_ops_of<inplace_control_block>),
+        allocator(alloc)
+  {
+    ::new (static_cast<void *>(this->storage)) T;
+    this->object = this->get_object();
+  }
+
+  /**
+   * @brief Allocate a block and construct the object inside it
+   */
+  template <class... Args>
+  static inplace_control_block *create(const Alloc &alloc, Args &&...args)
+  {
+    block_allocator block_alloc(alloc);
+    inplace_control_block *cb = block_alloc.allocate(1);
+    try
+    {
+      return std::construct_at(cb, alloc, std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      block_alloc.deallocate(cb, 1);
+      throw;
+    }
+  }
+
+  T *get_object() noexcept
+  {
+    return std::launder(reinterpret_cast<T *>(this->storage));
+  }
+
+  static void dispose(control_block_base *base) noexcept
+  {
+    std::destroy_at(static_cast<inplace_control_block *>(base)->get_object());
+  }
+
+  static void destroy(control_block_base *base) noexcept
+  {
+    auto *cb = static_cast<inplace_control_block *>(base);
+    block_allocator block_alloc(cb->allocator);
+    std::destroy_at(cb);
+    block_alloc.deallocate(cb, 1);
+  }
 };
 
 /**
@@ -115,62 +595,67 @@ public:
    */
   using element_type = T;
 
+  struct control_block;
+
+  /**
+   * @brief The allocator of the control block, Alloc rebound to it
+   */
+  using block_allocator = typename std::allocator_traits<
+    Alloc>::template rebind_alloc<control_block>;
+
   struct control_block : control_block_base
   {
-    T            *object;
-    Alloc         allocator;
-    Deleter       deleter;
+    // Stateless deleters and allocators take no space in the block
+    [[no_unique_address]] tenno::compressed_pair<Deleter, Alloc>
+      deleter_alloc;
 
-    control_block() = default;
+    control_block() noexcept
+        : control_block_base(&tenno::control_block_ops_of<control_block>)
+    {
+    }
 
-    control_block(T* obj) : object(obj)
+    control_block(T* obj, const Deleter &del, const Alloc &alloc) noexcept
+        : control_block_base(&tenno::control_block_ops_of<control_block>),
+          deleter_alloc(del, alloc)
     {
-      this->num_ptrs     = 1;
-      this->num_num_ptrs = 0;
+      this->object = obj;
     }
     
     control_block(T&& obj)
+        : control_block_base(&tenno::control_block_ops_of<control_block>)
     {
       void* raw_mem   = tenno::allocator<T>().allocate(1);
       T* new_object   = new (raw_mem) T(tenno::move(obj));
       
       this->object = new_object;
-      this->num_ptrs = 1;
-      this->num_num_ptrs = 0;
     }
     
-    void dispose_object() override
+    // Only the thread that drops the last shared reference gets here
+    static void dispose(control_block_base *base) noexcept
     {
-      T* delete_me = nullptr;
+      auto *cb     = static_cast<control_block *>(base);
+      T* delete_me = static_cast<T*>(cb->object);
+      cb->object   = nullptr;
+      if (delete_me)
       {
-        tenno::lock_guard<tenno::mutex> lock(cb_mutex);
-        if (!this->object) return;
-        delete_me = this->object;
-        this->object = nullptr;
+        cb->deleter_alloc.first()(delete_me);
       }
-      this->deleter(delete_me);
     }
 
-    void deallocate() override
+    static void destroy(control_block_base *base) noexcept
     {
-      this->~control_block();
-      operator delete(this); 
-    }
-
-    void set_ptr(void* ptr) override
-    {
-      this->object = static_cast<T*>(ptr);
-    }
-
-    void* get_ptr() override
-    {
-      return static_cast<void*>(this->object);
+      auto *cb = static_cast<control_block *>(base);
+      block_allocator block_alloc(cb->deleter_alloc.second());
+      std::destroy_at(cb);
+      block_alloc.deallocate(cb, 1);
     }
     
   };
 
   friend control_block;
   friend class tenno::weak_ptr<T>;
+  template <class Y> friend class tenno::local_shared_ptr;
+  template <typename Y> friend class tenno::atomic;
   template <class Y, class... Args>
   friend typename std::enable_if<!std::is_array<Y>::value, shared_ptr<Y>>::type
   make_shared(Args &&...args) noexcept;
@@ -179,6 +664,8 @@ public:
   template <class Y>
   friend typename std::enable_if<std::is_array<Y>::value, shared_ptr<Y>>::type
   make_shared(tenno::size n) noexcept;
+  template <class Y, class A, class... Args>
+  friend shared_ptr<Y> allocate_shared(const A &alloc, Args &&...args) noexcept;
   // Make sure that all versions of shared_ptr are friends with each
   // other
   template <typename U, typename D, typename A> friend class shared_ptr;
@@ -196,20 +683,8 @@ public:
    *
    * @param ptr The object to point to
    */
-  shared_ptr(T *ptr)
+  shared_ptr(T *ptr) : shared_ptr(ptr, Deleter(), Alloc())
   {
-    size_t         size_in_ts = (sizeof(control_block) + sizeof(T) - 1) / sizeof(T);
-    void*          raw_mem    = tenno::allocator<T>().allocate(size_in_ts);
-    control_block* cb         = new (raw_mem) control_block();
-    
-    cb->object           = ptr;
-    cb->num_ptrs         = 1;
-    cb->num_weak_ptrs    = 0;
-    cb->allocator        = tenno::allocator<T>();
-    cb->deleter          = tenno::default_delete<T>();
-    cb->cb_mutex         = tenno::mutex();
-    this->_object        = cb->object;
-    this->_control_block = cb;
   }
 
   /**
@@ -219,16 +694,11 @@ public:
    */
   shared_ptr(T&& obj)
   {
-    size_t         size_in_ts = (sizeof(control_block) + sizeof(T) - 1) / sizeof(T);
-    void*          raw_mem    = tenno::allocator<T>().allocate(size_in_ts);
-    control_block* cb         = new (raw_mem) control_block(tenno::move(obj));
+    block_allocator block_alloc;
+    control_block  *cb = std::construct_at(block_alloc.allocate(1),
+                                           tenno::move(obj));
 
-    cb->num_ptrs         = 1;
-    cb->num_weak_ptrs    = 0;
-    cb->allocator        = tenno::allocator<T>();
-    cb->deleter          = tenno::default_delete<T>();
-    cb->cb_mutex         = tenno::mutex();
-    this->_object        = cb->object;
+    this->_object        = static_cast<T*>(cb->object);
     this->_control_block = cb;
   }
 
@@ -239,20 +709,8 @@ public:
    * @param ptr The object to point to
    * @param deleter The deleter to use to delete the object
    */
-  shared_ptr(T *ptr, Deleter deleter)
+  shared_ptr(T *ptr, Deleter deleter) : shared_ptr(ptr, deleter, Alloc())
   {
-    size_t         size_in_ts = (sizeof(control_block) + sizeof(T) - 1) / sizeof(T);
-    void*          raw_mem    = tenno::allocator<T>().allocate(size_in_ts);
-    control_block* cb         = new (raw_mem) control_block();
-    
-    cb->object           = ptr;
-    cb->num_ptrs         = 1;
-    cb->num_weak_ptrs    = 0;
-    cb->allocator        = tenno::allocator<T>();
-    cb->deleter          = deleter;
-    cb->cb_mutex         = tenno::mutex();
-    this->_object       = cb->object;
-    this->_control_block = cb;
   }
 
   /**
@@ -260,21 +718,16 @@ public:
    *
    * @param ptr The object to point to
    * @param deleter The deleter to use to delete the object
-   * @param allocator The allocator to use to allocate the control block
+   * @param alloc The allocator of the control block, rebound to
+   * block_allocator
    */
   shared_ptr(T *ptr, Deleter deleter, Alloc alloc)
   {
-    size_t         size_in_ts = (sizeof(control_block) + sizeof(T) - 1) / sizeof(T);
-    void*          raw_mem    = alloc.allocate(size_in_ts);
-    control_block* cb         = new (raw_mem) control_block();
-    
-    cb->object           = ptr;
-    cb->num_ptrs         = 1;
-    cb->num_weak_ptrs    = 0;
-    cb->allocator        = alloc;
-    cb->deleter          = deleter;
-    cb->cb_mutex         = tenno::mutex();
-    this->_object       = cb->object;
+    block_allocator block_alloc(alloc);
+    control_block  *cb = std::construct_at(block_alloc.allocate(1), ptr,
+                                           deleter, alloc);
+
+    this->_object        = ptr;
     this->_control_block = cb;
   }
 
@@ -285,13 +738,10 @@ public:
    */
   shared_ptr(const shared_ptr &other) noexcept
       : _object(other._object),
-        _control_block(other._control_block),
-        do_cache(other.do_cache)
+        _control_block(other._control_block)
   {
-    if (!this->_control_block) return;
-    
-    tenno::lock_guard<tenno::mutex> lock(this->_control_block->cb_mutex);
-    this->_control_block->num_ptrs++;
+    if (this->_control_block)
+      this->_control_block->add_ref();
   }
 
   /**
@@ -301,8 +751,7 @@ public:
    */
   shared_ptr(shared_ptr &&other) noexcept
       : _object(other._object),
-        _control_block(other._control_block),
-        do_cache(other.do_cache)
+        _control_block(other._control_block)
   {
     other._object       = nullptr;
     other._control_block = nullptr;
@@ -315,11 +764,10 @@ public:
   template <typename U>
   shared_ptr(const shared_ptr<U>& other) noexcept 
     : _object(other._object),
-      _control_block(other._control_block),
-      do_cache(other.do_cache)
+      _control_block(other._control_block)
   {
     if (this->_control_block)
-      this->_control_block->num_ptrs++;
+      this->_control_block->add_ref();
   }
 
   /**
@@ -328,11 +776,10 @@ public:
   template <typename U>
   shared_ptr(const shared_ptr<U>& other, T* object) noexcept 
     : _object(object),
-      _control_block(other._control_block),
-      do_cache(other.do_cache)
+      _control_block(other._control_block)
   {
     if (this->_control_block)
-      this->_control_block->num_ptrs++;
+      this->_control_block->add_ref();
   }
   
   /**
@@ -341,8 +788,7 @@ public:
   template <typename U>
   shared_ptr(shared_ptr<U>&& other) noexcept 
     : _object(other._object),
-      _control_block(other._control_block),
-      do_cache(other.do_cache)
+      _control_block(other._control_block)
   {
     other._object       = nullptr;
     other._control_block = nullptr;
@@ -371,7 +817,6 @@ public:
     
     this->_object        = other._object;
     this->_control_block = other._control_block;
-    this->do_cache       = other.do_cache;
     
     other._object        = nullptr;
     other._control_block = nullptr;
@@ -386,17 +831,9 @@ public:
    */
   shared_ptr &operator=(const shared_ptr &other) noexcept
   {
-    this->reset();
-    
-    this->_object        = other._object;
-    this->_control_block = other._control_block;
-    this->do_cache       = other.do_cache;
-    
-    if (this->_control_block)
-    {
-      tenno::lock_guard<tenno::mutex> lock(this->_control_block->cb_mutex);
-      this->_control_block->num_ptrs++;
-    }
+    // Take the new reference first, so self assignment is safe
+    shared_ptr copy(other);
+    this->swap(copy);
     return *this;
   }
 
@@ -411,7 +848,6 @@ public:
 
     this->_object        = other._object; // This works if U* converts to T*
     this->_control_block = other._control_block;
-    this->do_cache       = other.do_cache;
     
     other._object        = nullptr;
     other._control_block = nullptr;
@@ -425,17 +861,8 @@ public:
   template<class Y>
   shared_ptr& operator=(const shared_ptr<Y>& other) noexcept
   {
-    this->reset();
-
-    this->_object        = other._object;
-    this->_control_block = other._control_block;
-    this->do_cache       = other.do_cache;
-    
-    if (this->_control_block)
-    {
-      tenno::lock_guard<tenno::mutex> lock(this->_control_block->cb_mutex);
-      this->_control_block->num_ptrs++;
-    }
+    shared_ptr copy(other);
+    this->swap(copy);
     return *this;
   }
 
@@ -447,29 +874,7 @@ public:
     if (!this->_control_block)
       return;
 
-    bool destroy_object        = false;
-    bool destroy_control_block = false;
-
-    {
-      tenno::lock_guard<tenno::mutex> lock(this->_control_block->cb_mutex);
-      this->_control_block->num_ptrs--;
-
-      if (this->_control_block->num_ptrs == 0)
-      {
-        destroy_object = true;
-        
-        if (this->_control_block->num_weak_ptrs == 0)
-        {
-          destroy_control_block = true;
-        }
-      }
-    }
-
-    if (destroy_object)
-      this->_control_block->dispose_object();
-
-    if (destroy_control_block)
-      this->_control_block->deallocate();
+    this->_control_block->release();
 
     this->_object       = nullptr;
     this->_control_block = nullptr;
@@ -484,15 +889,12 @@ public:
   {
     T                  *tmp_object        = this->_object;
     control_block_base *tmp_control_block = this->_control_block;
-    bool                tmp_do_cache      = this->do_cache;
 
     this->_object        = other._object;
     this->_control_block = other._control_block;
-    this->do_cache       = other.do_cache;
     
     other._object        = tmp_object;
     other._control_block = tmp_control_block;
-    other.do_cache       = tmp_do_cache;
   }
 
   /**
@@ -500,38 +902,48 @@ public:
    *
    * This function does not swap the reference counting of the object,
    * but it swaps the internal pointer to the object.
+   *
+   * @note Other copies of the pointers keep accessing the object they
+   * had, only the control blocks and these two pointers are updated.
+   *
+   * @return false, leaving both pointers untouched, if either is empty
+   * or its object lives in its control block, as with make_shared and
+   * allocate_shared
    */
-  void swap_ptr(shared_ptr &other) noexcept
+  bool swap_ptr(shared_ptr &other) noexcept
   {
+    if (!control_block_base::can_swap_objects(this->_control_block,
+                                              other._control_block))
+    {
+      return false;
+    }
     void *tmp_object = this->_control_block->get_ptr();
 
-    this->_object                = other._control_block->get_ptr();
-    this->_control_block->set_ptr(other->_control_block->get_ptr());
-
-    other._object                = tmp_object;
+    this->_control_block->set_ptr(other._control_block->get_ptr());
     other._control_block->set_ptr(tmp_object);
+
+    this->_object = static_cast<T*>(this->_control_block->get_ptr());
+    other._object = static_cast<T*>(other._control_block->get_ptr());
+    return true;
   }
 
   /**
-   * @brief Enable or disable pointer caching
-   *
-   * Of pointer caching is enabled, the shared pointer will hold
-   * a copy of a pointer to the T object directly. This makes it
-   * possible to access the pointer without dereferencing the
-   * inner control block, which improves performance.
+   * @brief Kept for compatibility, does nothing
    *
-   * You can disable this if you need the shared pointer to always
-   * reference only the pointer stored in the inner control block.
+   * The pointer always holds a copy of the pointer to the object, so
+   * accessing it never reads the control block.
    */
-  void set_cache(bool should_do_cache) noexcept
+  [[deprecated("the object pointer is always cached")]]
+  void set_cache(bool) noexcept
   {
-    this->do_cache = should_do_cache;
-    return;
   }
 
+  /**
+   * @brief Always true, see set_cache
+   */
   bool get_cache() const noexcept
   {
-    return this->do_cache;
+    return true;
   }
   
   /**
@@ -541,9 +953,7 @@ public:
    */
   T *get() const noexcept
   {
-    return (this->do_cache)
-      ? this->_object
-      : static_cast<T*>(this->_control_block->get_ptr());
+    return this->_object;
   }
 
   /**
@@ -553,9 +963,7 @@ public:
    */
   T &operator*() const noexcept
   {
-    return (this->do_cache)
-      ? *this->_object
-      : *static_cast<T*>(this->_control_block->get_ptr());
+    return *this->_object;
   }
 
   /**
@@ -565,9 +973,7 @@ public:
    */
   T *operator->() const noexcept
   {
-    return (this->do_cache)
-      ? this->_object
-      : static_cast<T*>(this->_control_block->get_ptr());
+    return this->_object;
   }
 
   /**
@@ -578,9 +984,7 @@ public:
    */
   auto &operator[](tenno::size index) const noexcept
   {
-    return (this->do_cache)
-      ? (*this->_object)[index]
-      : (*static_cast<T*>(this->_control_block->get_ptr()))[index];
+    return (*this->_object)[index];
   }
 
   /**
@@ -592,7 +996,7 @@ public:
   {
     if (!this->_control_block)
       return 0;
-    return this->_control_block->num_ptrs;
+    return this->_control_block->use_count();
   }
 
   /**
@@ -603,9 +1007,7 @@ public:
    */
   explicit operator bool() const noexcept
   {
-    return (this->do_cache)
-      ? this->_object != nullptr
-      : static_cast<T*>(this->_control_block->get_ptr()) != nullptr;
+    return this->_object != nullptr;
   }
 
   /**
@@ -642,11 +1044,6 @@ private:
   
   T                  *_object;
   control_block_base *_control_block;
-
-  // Wether to use _object or _control_block->object when accessing the
-  // object
-  bool do_cache = true;
-  
 };
 
 /**
@@ -684,17 +1081,12 @@ public:
     {
       this->_control_block    = nullptr;
       this->_object           = nullptr;
-      this->do_cache          = r.do_cache;
       return;
     }
 
     this->_control_block    = r._control_block;
     this->_object           = r._object;
-    this->do_cache          = r.do_cache;
-    
-    tenno::lock_guard<tenno::mutex> lock(r._control_block->cb_mutex);
-    this->_control_block->num_weak_ptrs++;
-
+    this->_control_block->add_weak_ref();
   }
 
   /**
@@ -713,7 +1105,6 @@ public:
 
     this->_control_block    = r._control_block;
     this->_object           = r._object;
-    this->do_cache          = r.do_cache;
     r._control_block        = nullptr;
     r._object               = nullptr;
   }
@@ -734,10 +1125,7 @@ public:
 
     this->_object           = r._object;
     this->_control_block    = r._control_block;
-    this->do_cache          = r.do_cache;
-    
-    tenno::lock_guard<tenno::mutex> lock(r._control_block->cb_mutex);
-    this->_control_block->num_weak_ptrs++;
+    this->_control_block->add_weak_ref();
   }
 
   /**
@@ -745,24 +1133,7 @@ public:
    */
   ~weak_ptr()
   {
-    if (!this->_control_block) return;
-
-    bool should_delete_block = false;
-    {
-      tenno::lock_guard<tenno::mutex> lock(this->_control_block->cb_mutex);
-      this->_control_block->num_weak_ptrs--;
-
-      if (this->_control_block->num_ptrs == 0 && 
-          this->_control_block->num_weak_ptrs == 0)
-      {
-        should_delete_block = true;
-      }
-    }
-
-    if (should_delete_block)
-    {
-      this->_control_block->deallocate();
-    }
+    this->reset();
   }
 
   /**
@@ -773,22 +1144,8 @@ public:
    */
   weak_ptr &operator=(const weak_ptr &r) noexcept
   {
-    if (this == &r) return *this;
-    
-    if (!r._control_block)
-    {
-      this->_control_block = nullptr;
-      this->_object           = nullptr;
-      return *this;
-    }
-    
-    this->_control_block    = r._control_block;
-    this->_object           = r._object;
-    this->do_cache          = r.do_cache;
-    
-    tenno::lock_guard<tenno::mutex> lock(r._control_block->cb_mutex);
-    this->_control_block->num_weak_ptrs++;
-    
+    weak_ptr copy(r);
+    this->swap(copy);
     return *this;
   }
 
@@ -800,20 +1157,8 @@ public:
    */
   weak_ptr &operator=(const shared_ptr<T> &r) noexcept
   {
-    if (!r._control_block)
-    {
-      this->_control_block = nullptr;
-      this->_object           = nullptr;
-      return *this;
-    }
-
-    this->_object           = r._object;
-    this->_control_block    = r._control_block;
-    this->do_cache          = r.do_cache;
-    
-    tenno::lock_guard<tenno::mutex> lock(r._control_block->cb_mutex);
-    this->_control_block->num_weak_ptrs++;
-    
+    weak_ptr copy(r);
+    this->swap(copy);
     return *this;
   }
 
@@ -825,16 +1170,16 @@ public:
    */
   weak_ptr &operator=(weak_ptr &&r) noexcept
   {
+    if (this == &r) return *this;
+
+    this->reset();
     if (!r._control_block)
     {
-      this->_control_block = nullptr;
-      this->_object           = nullptr;
       return *this;
     }
 
     this->_control_block  = r._control_block;
     this->_object         = r._object;
-    this->do_cache        = r.do_cache;
     
     r._control_block      = nullptr;
     r._object             = nullptr;
@@ -847,17 +1192,8 @@ public:
    */
   void reset() noexcept
   {
-    bool should_deallocate = false;
     if (this->_control_block)
-    {
-      tenno::lock_guard<tenno::mutex> lock(this->_control_block->cb_mutex);
-      this->_control_block->num_weak_ptrs--;
-      if (this->_control_block->num_ptrs == 0
-          && this->_control_block->num_weak_ptrs == 0)
-        should_deallocate = true;
-    }
-    if (should_deallocate)
-      this->_control_block->deallocate();
+      this->_control_block->weak_release();
 
     this->_control_block    = nullptr;
     this->_object           = nullptr;
@@ -872,15 +1208,12 @@ public:
   {
     auto tmp_cb          = this->_control_block;
     auto tmp_object      = this->_object;
-    auto tmp_do_cache    = this->do_cache;
     
     this->_control_block = r._control_block;
     this->_object        = r._object;
-    this->do_cache       = r.do_cache;
     
     r._control_block     = tmp_cb;
     r._object            = tmp_object;
-    r.do_cache           = tmp_do_cache;
   }
 
   /**
@@ -888,16 +1221,25 @@ public:
    *
    * This function does not swap the reference counting of the object,
    * but it swaps the internal pointer to the object.
+   *
+   * @return false, leaving both pointers untouched, see
+   * shared_ptr::swap_ptr
    */
-  void swap_ptr(weak_ptr &other) noexcept
+  bool swap_ptr(weak_ptr &other) noexcept
   {
+    if (!control_block_base::can_swap_objects(this->_control_block,
+                                              other._control_block))
+    {
+      return false;
+    }
     void *tmp_object = this->_control_block->get_ptr();
 
-    this->_object                = other._control_block->get_ptr();
     this->_control_block->set_ptr(other._control_block->get_ptr());
-
-    other._object                = tmp_object;
     other._control_block->set_ptr(tmp_object);
+
+    this->_object = static_cast<T*>(this->_control_block->get_ptr());
+    other._object = static_cast<T*>(other._control_block->get_ptr());
+    return true;
   }
 
   /**
@@ -905,36 +1247,44 @@ public:
    *
    * This function does not swap the reference counting of the object,
    * but it swaps the internal pointer to the object.
+   *
+   * @return false, leaving both pointers untouched, see
+   * shared_ptr::swap_ptr
    */
-  void swap_ptr(shared_ptr<T> &other) noexcept
+  bool swap_ptr(shared_ptr<T> &other) noexcept
   {
+    if (!control_block_base::can_swap_objects(this->_control_block,
+                                              other._control_block))
+    {
+      return false;
+    }
     void *tmp_object = this->_control_block->get_ptr();
     this->_control_block->set_ptr(other._control_block->get_ptr());
     
     other._control_block->set_ptr(tmp_object);
+
+    this->_object = static_cast<T*>(this->_control_block->get_ptr());
     other._object = static_cast<T*>(tmp_object);
+    return true;
   }
   
   /**
-   * @brief Enable or disable pointer caching
+   * @brief Kept for compatibility, does nothing
    *
-   * Of pointer caching is enabled, the shared pointer will hold
-   * a copy of a pointer to the T object directly. This makes it
-   * possible to access the pointer without dereferencing the
-   * inner control block, which improves performance.
-   *
-   * You can disable this if you need the shared pointer to always
-   * reference only the pointer stored in the inner control block.
+   * The pointer always holds a copy of the pointer to the object, so
+   * accessing it never reads the control block.
    */
-  void set_cache(bool should_do_cache) noexcept
+  [[deprecated("the object pointer is always cached")]]
+  void set_cache(bool) noexcept
   {
-    this->do_cache = should_do_cache;
-    return;
   }
 
+  /**
+   * @brief Always true, see set_cache
+   */
   bool get_cache() const noexcept
   {
-    return this->do_cache;
+    return true;
   }
   
   /**
@@ -945,7 +1295,7 @@ public:
   long use_count() const noexcept
   {
     if (this->_control_block)
-      return this->_control_block->num_ptrs;
+      return this->_control_block->use_count();
     return 0;
   }
 
@@ -959,7 +1309,7 @@ public:
   {
     if (!this->_control_block)
       return true;
-    return this->_control_block->num_ptrs == 0;
+    return this->_control_block->use_count() == 0;
   }
 
   /**
@@ -969,14 +1319,15 @@ public:
    */
   tenno::shared_ptr<T> lock() const noexcept
   {
-    if (!this->_control_block || this->_control_block->num_ptrs == 0)
-      return nullptr;
+    auto sp = tenno::shared_ptr<T>();
+
+    // The object may be destroyed concurrently, the count is only
+    // incremented while it is not zero
+    if (!this->_control_block || !this->_control_block->add_ref_lock())
+      return sp;
 
-    auto sp           = tenno::shared_ptr<T>();
     sp._object        = this->_object;
     sp._control_block = this->_control_block;
-    sp.do_cache       = this->do_cache;
-    sp._control_block->num_ptrs++;
     return sp;
   }
 
@@ -1030,11 +1381,6 @@ private:
 
   element_type         *_object;
   control_block_base   *_control_block;
-
-  // Wether to use _ptr or _control_block->object when accessing the
-  // object
-  bool do_cache = true;
-  
 };
 
 /**
@@ -1052,7 +1398,7 @@ public:
   /**
    * @brief Construct a new empty unique_ptr object
    */
-  constexpr unique_ptr() : _value(nullptr)
+  constexpr unique_ptr() : _storage(nullptr, Deleter())
   {
   }
 
@@ -1061,8 +1407,8 @@ public:
    *
    * @param ptr The pointer to the object
    */
-  constexpr unique_ptr(T *ptr, Deleter deleter = tenno::default_delete<T>())
-      : _value(ptr), _deleter(deleter)
+  constexpr unique_ptr(T *ptr, Deleter deleter = Deleter())
+      : _storage(ptr, tenno::move(deleter))
   {
   }
 
@@ -1073,9 +1419,8 @@ public:
    * @param other The other unique_ptr object to move
    */
   constexpr unique_ptr(unique_ptr &&other) noexcept
+      : _storage(other.release(), tenno::move(other.get_deleter()))
   {
-    this->reset(other.release());
-    this->_deleter = other.get_deleter();
   }
 
   /**
@@ -1086,8 +1431,8 @@ public:
 #endif
     ~unique_ptr()
   {
-    if (this->_value != nullptr)
-      this->_deleter(this->_value);
+    if (this->_storage.first() != nullptr)
+      this->_storage.second()(this->_storage.first());
   }
 
   constexpr unique_ptr &operator=(const unique_ptr &other) = delete;
@@ -1100,7 +1445,7 @@ public:
   constexpr unique_ptr &operator=(unique_ptr &&other) noexcept
   {
     this->reset(other.release());
-    this->_deleter = other.get_deleter();
+    this->_storage.second() = tenno::move(other.get_deleter());
     return *this;
   }
 
@@ -1111,11 +1456,8 @@ public:
    */
   constexpr pointer release() noexcept
   {
-    if (!this->_value)
-      return nullptr;
-
-    pointer ptr = _value;
-    this->_value = nullptr;
+    pointer ptr = this->_storage.first();
+    this->_storage.first() = nullptr;
     return ptr;
   }
 
@@ -1126,9 +1468,10 @@ public:
    */
   constexpr void reset(pointer ptr = pointer()) noexcept
   {
-    if (this->_value)
-      this->_deleter(this->_value);
-    this->_value = ptr;
+    pointer old = this->_storage.first();
+    this->_storage.first() = ptr;
+    if (old)
+      this->_storage.second()(old);
   }
 
   /**
@@ -1138,12 +1481,7 @@ public:
    */
   void swap(unique_ptr &other) noexcept
   {
-    T tmp_val = *other.get();
-    Deleter del_tmp = other.get_deleter();
-    *other.get() = *this->get();
-    other.get_deleter() = this->get_deleter();
-    *this->_value = tmp_val;
-    this->_deleter = del_tmp;
+    this->_storage.swap(other._storage);
   }
 
   /**
@@ -1153,7 +1491,7 @@ public:
    */
   constexpr pointer get() const noexcept
   {
-    return this->_value;
+    return this->_storage.first();
   }
 
   /**
@@ -1161,9 +1499,14 @@ public:
    *
    * @return deleter_type The deleter of the object
    */
-  deleter_type &get_deleter()
+  deleter_type &get_deleter() noexcept
+  {
+    return this->_storage.second();
+  }
+
+  const deleter_type &get_deleter() const noexcept
   {
-    return this->_deleter;
+    return this->_storage.second();
   }
 
   /**
@@ -1172,34 +1515,183 @@ public:
    */
   explicit operator bool() const noexcept
   {
-    return this->_value != nullptr;
+    return this->_storage.first() != nullptr;
   }
 
   /**
    * @brief Dereference operator
    * @return T& The reference to the object
    */
-  T &operator*() noexcept
+  T &operator*() const noexcept
   {
-    return *this->_value;
+    return *this->_storage.first();
   }
 
   /**
-   * @brief Dereference operator
-   * @return T& The reference to the object
+   * @brief Member access operator
+   * @return pointer The pointer to the object
    */
-  T &operator->() noexcept
+  pointer operator->() const noexcept
   {
-    return this->_value;
+    return this->_storage.first();
   }
 
 private:
-  
-  pointer _value = nullptr;
-  deleter_type _deleter;
-  
+
+  // A stateless deleter takes no space, unique_ptr<T> is pointer-sized
+  tenno::compressed_pair<pointer, deleter_type> _storage;
+};
+
+/**
+ * @brief A unique pointer to an array allocated with new[]
+ *
+ * The elements are reached with operator[], there is no operator* or
+ * operator->. The default deleter calls delete[].
+ *
+ * @tparam T The type of the elements
+ */
+template <class T, class Deleter> class unique_ptr<T[], Deleter>
+{
+public:
+  using pointer      = T *;
+  using element_type = T;
+  using deleter_type = Deleter;
+
+  /**
+   * @brief Construct a new empty unique_ptr object
+   */
+  constexpr unique_ptr() : _storage(nullptr, Deleter())
+  {
+  }
+
+  /**
+   * @brief Construct a new unique_ptr object owning the array ptr
+   *
+   * @param ptr The pointer to the first element
+   */
+  constexpr explicit unique_ptr(T *ptr, Deleter deleter = Deleter())
+      : _storage(ptr, tenno::move(deleter))
+  {
+  }
+
+  constexpr unique_ptr(const unique_ptr &other) = delete;
+
+  constexpr unique_ptr(unique_ptr &&other) noexcept
+      : _storage(other.release(), tenno::move(other.get_deleter()))
+  {
+  }
+
+#if __cplusplus >= 202002L // C++20
+  constexpr
+#endif
+    ~unique_ptr()
+  {
+    if (this->_storage.first() != nullptr)
+      this->_storage.second()(this->_storage.first());
+  }
+
+  constexpr unique_ptr &operator=(const unique_ptr &other) = delete;
+
+  constexpr unique_ptr &operator=(unique_ptr &&other) noexcept
+  {
+    this->reset(other.release());
+    this->_storage.second() = tenno::move(other.get_deleter());
+    return *this;
+  }
+
+  /**
+   * @brief Release the array from the unique_ptr object
+   *
+   * @return pointer The pointer to the first element
+   */
+  constexpr pointer release() noexcept
+  {
+    pointer ptr = this->_storage.first();
+    this->_storage.first() = nullptr;
+    return ptr;
+  }
+
+  /**
+   * @brief Delete the array and own ptr instead
+   *
+   * @param ptr The pointer to the first element of the new array
+   */
+  constexpr void reset(pointer ptr = pointer()) noexcept
+  {
+    pointer old = this->_storage.first();
+    this->_storage.first() = ptr;
+    if (old)
+      this->_storage.second()(old);
+  }
+
+  void swap(unique_ptr &other) noexcept
+  {
+    this->_storage.swap(other._storage);
+  }
+
+  constexpr pointer get() const noexcept
+  {
+    return this->_storage.first();
+  }
+
+  deleter_type &get_deleter() noexcept
+  {
+    return this->_storage.second();
+  }
+
+  const deleter_type &get_deleter() const noexcept
+  {
+    return this->_storage.second();
+  }
+
+  explicit operator bool() const noexcept
+  {
+    return this->_storage.first() != nullptr;
+  }
+
+  /**
+   * @brief Array access operator
+   *
+   * @param index The index of the element to access
+   * @return T& The element at the given index
+   */
+  T &operator[](tenno::size index) const noexcept
+  {
+    return this->_storage.first()[index];
+  }
+
+private:
+
+  tenno::compressed_pair<pointer, deleter_type> _storage;
 };
 
+/**
+ * @brief Create a shared pointer with the given arguments and allocator
+ *
+ * The object is constructed inside the control block, so a single
+ * allocation is made through alloc and accessing the object costs no
+ * extra indirection.
+ *
+ * @tparam T The type of the object to create
+ * @tparam Alloc The type of the allocator to use
+ * @tparam Args The type of the arguments to pass to the constructor
+ * @param alloc The allocator to use
+ * @param args The arguments to pass to the constructor
+ * @return shared_ptr<T> The shared pointer to the object
+ */
+template <class T, class Alloc, class... Args>
+shared_ptr<T> allocate_shared(const Alloc &alloc, Args &&...args) noexcept
+{
+  using cb_t = tenno::inplace_control_block<
+    T, typename std::allocator_traits<Alloc>::template rebind_alloc<T>>;
+  cb_t *cb = cb_t::create(alloc, std::forward<Args>(args)...);
+
+  tenno::shared_ptr<T> sp;
+  sp._object        = cb->get_object();
+  sp._control_block = cb;
+  return sp;
+}
+
 /**
  * @brief Create a shared pointer with the given arguments
  *
@@ -1208,139 +1700,90 @@ private:
  * @param args The arguments to pass to the constructor
  * @return shared_ptr<T> The shared pointer to the object
  *
- * @note Make shared takes care of the allocation of the object, while the
- * shared pointer takes care of the allocation and deallocation of the
- * internal control block, as well as the deallocation of the object.
- * @note The object must accept variadic arguments in the constructor
+ * @note The object and the control block are allocated together, see
+ * tenno::allocate_shared.
  */
 template <class T, class... Args>
 typename std::enable_if<!std::is_array<T>::value, shared_ptr<T>>::type
 make_shared(Args &&...args) noexcept
 {
-  using cb_t = typename tenno::shared_ptr<T>::control_block;
-  tenno::shared_ptr<T> sp;
-  T *t = new T(args...);
-
-  size_t         size_in_ts = (sizeof(cb_t) + sizeof(T) - 1) / sizeof(T);
-  void*          raw_mem    = tenno::allocator<T>().allocate(size_in_ts);
-  cb_t* cb                  = new (raw_mem) cb_t();
-    
-  cb->object        = t;
-  cb->num_ptrs      = 1;
-  cb->num_weak_ptrs = 0;
-  cb->allocator     = tenno::allocator<T>();
-  cb->deleter       = tenno::default_delete<T>();
-  cb->cb_mutex      = tenno::mutex();
-  sp._object        = t;
-  sp._control_block = cb;
-  return tenno::move(sp);
+  return tenno::allocate_shared<T>(tenno::allocator<T>(),
+                                   std::forward<Args>(args)...);
 }
 
+/**
+ * @brief Create a shared pointer to an array
+ *
+ * `make_shared<T[]>(n)` allocates n value initialized elements,
+ * reached with operator[]. `make_shared<T[N]>(n)` allocates n arrays
+ * of N elements.
+ */
 template <class T>
 typename std::enable_if<std::is_array<T>::value, shared_ptr<T>>::type
 make_shared(tenno::size n) noexcept
 {
-  using cb_t = typename tenno::shared_ptr<T>::control_block;
-  tenno::shared_ptr<T> sp;
-  T *t = new T[n];
-
-  size_t         size_in_ts = (sizeof(cb_t) + sizeof(T) - 1) / sizeof(T);
-  void*          raw_mem    = tenno::allocator<T>().allocate(size_in_ts);
-  cb_t* cb                  = new (raw_mem) cb_t();
-
-  cb->object        = t;
-  cb->num_ptrs      = 1;
-  cb->num_weak_ptrs = 0;
-  cb->allocator     = tenno::allocator<T>();
-  cb->deleter       = tenno::default_delete<T>();
-  cb->cb_mutex      = tenno::mutex();
-  sp._object        = t;
-  sp._control_block = cb;
-  return tenno::move(sp);
+  if constexpr (std::extent<T>::value == 0)
+  {
+    using elem = typename std::remove_extent<T>::type;
+    return tenno::shared_ptr<T>(reinterpret_cast<T *>(new elem[n]()));
+  }
+  else
+  {
+    using cb_t = typename tenno::shared_ptr<T>::control_block;
+    tenno::shared_ptr<T> sp;
+    T *t = new T[n];
+
+    typename tenno::shared_ptr<T>::block_allocator block_alloc;
+    cb_t *cb = std::construct_at(block_alloc.allocate(1), t,
+                                 tenno::default_delete<T>(),
+                                 tenno::allocator<T>());
+    sp._object        = t;
+    sp._control_block = cb;
+    return tenno::move(sp);
+  }
 }
 
 /**
- * @brief Default initialize a shared pointer
+ * @brief Create a shared pointer to a default initialized object
  *
- * @tparam T The type of the object to create
- * @return shared_ptr<T> The shared pointer to the object
+ * Unlike make_shared<T>(), trivial types are not zeroed, for buffers
+ * that are written right away. The object lives in the control block.
  */
-template <class T> shared_ptr<T> make_shared() noexcept
+template <class T>
+typename std::enable_if<!std::is_unbounded_array<T>::value,
+                        shared_ptr<T>>::type
+make_shared_for_overwrite()
 {
-  using cb_t = typename tenno::shared_ptr<T>::control_block;
-  tenno::shared_ptr<T> sp;
-  T *t = new T();
-
-  size_t         size_in_ts = (sizeof(cb_t) + sizeof(T) - 1) / sizeof(T);
-  void*          raw_mem    = tenno::allocator<T>().allocate(size_in_ts);
-  cb_t* cb                  = new (raw_mem) cb_t();
-
-  cb->object        = t;
-  cb->num_ptrs      = 1;
-  cb->num_weak_ptrs = 0;
-  cb->allocator     = tenno::allocator<T>();
-  cb->deleter       = tenno::default_delete<T>();
-  cb->cb_mutex      = tenno::mutex();
-  sp._object        = t;
-  sp._control_block = cb;
-  return tenno::move(sp);
+  return tenno::allocate_shared<T>(tenno::allocator<T>(), tenno::default_init);
 }
 
-template <class T> shared_ptr<T> make_shared(T&& val) noexcept
+/**
+ * @brief Create a shared pointer to an array of n default initialized
+ * elements
+ */
+template <class T>
+typename std::enable_if<std::is_unbounded_array<T>::value,
+                        shared_ptr<T>>::type
+make_shared_for_overwrite(tenno::size n)
 {
-  using cb_t = typename tenno::shared_ptr<T>::control_block;
-  tenno::shared_ptr<T> sp;
-  T *t = new T(tenno::move(val));
-
-  size_t         size_in_ts = (sizeof(cb_t) + sizeof(T) - 1) / sizeof(T);
-  void*          raw_mem    = tenno::allocator<T>().allocate(size_in_ts);
-  cb_t* cb                  = new (raw_mem) cb_t();
-
-  cb->object        = t;
-  cb->num_ptrs      = 1;
-  cb->num_weak_ptrs = 0;
-  cb->allocator     = tenno::allocator<T>();
-  cb->deleter       = tenno::default_delete<T>();
-  cb->cb_mutex      = tenno::mutex();
-  sp._object        = t;
-  sp._control_block = cb;
-  return tenno::move(sp);
+  using elem = typename std::remove_extent<T>::type;
+  return tenno::shared_ptr<T>(reinterpret_cast<T *>(new elem[n]));
 }
 
 /**
- * @brief Create a shared pointer with the given arguments and allocator
+ * @brief Default initialize a shared pointer
  *
  * @tparam T The type of the object to create
- * @tparam Alloc The type of the allocator to use
- * @tparam Args The type of the arguments to pass to the constructor
- * @param alloc The allocator to use
- * @param args The arguments to pass to the constructor
  * @return shared_ptr<T> The shared pointer to the object
  */
-template <class T, class Alloc, class... Args>
-// typename std::enable_if<!std::is_array<T>::value, shared_ptr<T>>::type
-typename tenno::shared_ptr<T> allocate_shared(Alloc &alloc,
-                                              Args &&...args) noexcept
+template <class T> shared_ptr<T> make_shared() noexcept
 {
-  void* raw_mem = alloc.allocate(1);
-  T *t = new (raw_mem) T(args...);
-  return tenno::shared_ptr<T>(t);
+  return tenno::allocate_shared<T>(tenno::allocator<T>());
 }
 
-/**
- * @brief Default initialize a shared pointer with the given allocator
- *
- * @tparam T The type of the object to create
- * @tparam Alloc The type of the allocator to use
- * @param alloc The allocator to use
- * @return shared_ptr<T> The shared pointer to the object
- */
-template <class T, class Alloc>
-shared_ptr<T> allocate_shared(Alloc &alloc) noexcept
+template <class T> shared_ptr<T> make_shared(T&& val) noexcept
 {
-  void* raw_mem = alloc.allocate(1);
-  T *t = new (raw_mem) T();
-  return tenno::shared_ptr<T>(t);
+  return tenno::allocate_shared<T>(tenno::allocator<T>(), tenno::move(val));
 }
 
 /*
@@ -1354,11 +1797,8 @@ allocate_shared(Alloc &alloc, tenno::size n) noexcept
     auto *cb =
         new tenno::shared_ptr<T, tenno::default_delete<elem>>::control_block();
     cb->object = t;
-    cb->num_ptrs = 1;
-    cb->num_weak_ptrs = 0;
     cb->allocator = alloc;
     cb->deleter = tenno::default_delete<elem>();
-    cb->cb_mutex = tenno::mutex();
 
     auto sp = tenno::shared_ptr<T, tenno::default_delete<elem>>();
     sp._object = t;
@@ -1377,10 +1817,429 @@ allocate_shared(Alloc &alloc, tenno::size n) noexcept
  * @note The object must accept variadic arguments in the constructor
  */
 template <class T, class... Args>
-constexpr unique_ptr<T> make_unique(Args &&...args)
+constexpr typename std::enable_if<!std::is_array<T>::value,
+                                  unique_ptr<T>>::type
+make_unique(Args &&...args)
 {
-  T *t = new T(args...);
+  T *t = new T(std::forward<Args>(args)...);
   return tenno::unique_ptr<T>(t);
 }
 
+/**
+ * @brief Create a unique pointer to an array of n value initialized
+ * elements
+ *
+ * @tparam T An array of unknown bound, like `int[]`
+ */
+template <class T>
+constexpr typename std::enable_if<std::is_unbounded_array<T>::value,
+                                  unique_ptr<T>>::type
+make_unique(tenno::size n)
+{
+  using elem = typename std::remove_extent<T>::type;
+  return tenno::unique_ptr<T>(new elem[n]());
+}
+
+/**
+ * @brief Create a unique pointer to a default initialized object
+ *
+ * Trivial types are left uninitialized, which saves zeroing memory
+ * that is overwritten right away.
+ */
+template <class T>
+constexpr typename std::enable_if<!std::is_array<T>::value,
+                                  unique_ptr<T>>::type
+make_unique_for_overwrite()
+{
+  return tenno::unique_ptr<T>(new T);
+}
+
+/**
+ * @brief Create a unique pointer to an array of n default initialized
+ * elements
+ *
+ * # Example
+ * ```cpp
+ * auto buf = tenno::make_unique_for_overwrite<char[]>(4 << 20);
+ * read(fd, buf.get(), 4 << 20);
+ * ```
+ */
+template <class T>
+constexpr typename std::enable_if<std::is_unbounded_array<T>::value,
+                                  unique_ptr<T>>::type
+make_unique_for_overwrite(tenno::size n)
+{
+  using elem = typename std::remove_extent<T>::type;
+  return tenno::unique_ptr<T>(new elem[n]);
+}
+
+/**
+ * @brief A deleter that destroys the object and gives its memory back
+ * to an allocator
+ *
+ * A stateless allocator makes the deleter empty, so the unique_ptr
+ * holding it stays pointer-sized.
+ *
+ * @tparam Alloc The allocator the object was allocated with
+ */
+template <class Alloc> struct allocator_delete
+{
+  using value_type = typename std::allocator_traits<Alloc>::value_type;
+
+  allocator_delete() = default;
+
+  explicit allocator_delete(const Alloc &a) : alloc(a)
+  {
+  }
+
+  void operator()(value_type *ptr) noexcept
+  {
+    std::destroy_at(ptr);
+    this->alloc.deallocate(ptr, 1);
+  }
+
+  [[no_unique_address]] Alloc alloc;
+};
+
+/**
+ * @brief Create a unique pointer to an object allocated with alloc
+ *
+ * # Example
+ * ```cpp
+ * auto p = tenno::allocate_unique<node>(tenno::slab_allocator<node>(), 42);
+ * ```
+ *
+ * @tparam T The type of the object to create
+ * @param alloc The allocator, rebound to T
+ * @param args The arguments to pass to the constructor
+ */
+template <class T, class Alloc, class... Args>
+auto allocate_unique(const Alloc &alloc, Args &&...args)
+{
+  using alloc_t =
+    typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+  alloc_t a(alloc);
+  T *ptr = a.allocate(1);
+  try
+  {
+    std::construct_at(ptr, std::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    a.deallocate(ptr, 1);
+    throw;
+  }
+  return tenno::unique_ptr<T, allocator_delete<alloc_t>>(
+    ptr, allocator_delete<alloc_t>(a));
+}
+
+/**
+ * @brief A control block that shares the ownership of an aliased
+ * shared pointer
+ *
+ * tenno::atomic stores a single control block pointer, so a shared
+ * pointer whose object is not the one of its control block is wrapped
+ * in one of these. The block owns a copy of the pointer and gives
+ * back its object.
+ */
+template <class T, class Deleter, class Alloc>
+struct aliased_control_block : control_block_base
+{
+  // Disposing releases ptr, whatever object points to
+  static constexpr bool fixed_object = true;
+
+  tenno::shared_ptr<T, Deleter, Alloc> ptr;
+
+  explicit aliased_control_block(tenno::shared_ptr<T, Deleter, Alloc> &&sp)
+      : control_block_base(&tenno::control_block_ops_of<aliased_control_block>),
+        ptr(tenno::move(sp))
+  {
+    this->object = this->ptr.get();
+  }
+
+  static void dispose(control_block_base *base) noexcept
+  {
+    static_cast<aliased_control_block *>(base)->ptr.reset();
+  }
+
+  static void destroy(control_block_base *base) noexcept
+  {
+    delete static_cast<aliased_control_block *>(base);
+  }
+};
+
+/**
+ * @brief The number of significant bits of a user space address
+ * assumed by the lock-free structures that pack a tag or a count in
+ * the high bits of a pointer
+ *
+ * x86-64 with 4-level paging and AArch64 map user space below 2^48.
+ * With 5-level paging (LA57) addresses can reach 2^57, but Linux only
+ * returns them to programs that pass mmap a hint above 2^47, which
+ * the allocators used here never do. tenno::check_packed_pointer
+ * aborts rather than silently corrupting such a pointer.
+ */
+inline constexpr int packed_pointer_bits = 48;
+
+/**
+ * @brief Abort if p does not fit in tenno::packed_pointer_bits bits
+ *
+ * A template, so that only the users of pointer packing require 64 bit
+ * pointers.
+ */
+template <class T> inline void check_packed_pointer(const T *p) noexcept
+{
+  static_assert(sizeof(p) == sizeof(unsigned long) && sizeof(p) == 8,
+                "pointer packing needs 64 bit pointers");
+  if (__builtin_expect(((unsigned long) p >> packed_pointer_bits) != 0, 0))
+  {
+    std::fprintf(stderr,
+                 "tenno: pointer %p does not fit in %d bits, 5-level "
+                 "paging addresses can not be packed\n",
+                 static_cast<const void *>(p), packed_pointer_bits);
+    std::abort();
+  }
+}
+
+/**
+ * @brief Lock-free atomic shared pointer
+ *
+ * The shared pointer is stored as a single word: the control block
+ * pointer in the low 48 bits and a local reference count in the high
+ * 16 bits (split reference count). A reader increments the local count
+ * together with reading the pointer, so the control block cannot be
+ * freed under it, then takes a reference on the control block and
+ * gives the local one back. A writer that replaces the pointer moves
+ * the local references left on the old word into the control block.
+ * No lock is taken on either side.
+ *
+ * At most 65535 loads may be in flight on the same atomic at once.
+ * Control blocks must live below 2^48, see
+ * tenno::packed_pointer_bits.
+ *
+ * # Example
+ * ```cpp
+ * tenno::atomic<tenno::shared_ptr<config>> current(
+ *   tenno::make_shared<config>());
+ * // readers
+ * auto snapshot = current.load();
+ * // writer
+ * current.store(tenno::make_shared<config>(new_settings));
+ * ```
+ *
+ * @tparam T The type of the object to point to
+ */
+template <class T, class Deleter, class Alloc>
+class atomic<tenno::shared_ptr<T, Deleter, Alloc>>
+{
+public:
+  using value_type = tenno::shared_ptr<T, Deleter, Alloc>;
+  const bool is_always_lock_free = true;
+
+  atomic() noexcept : _word(0)
+  {
+  }
+
+  atomic(value_type desired) noexcept : _word(pack(tenno::move(desired)))
+  {
+  }
+
+  ~atomic() noexcept
+  {
+    unsigned long old = this->_word;
+    drop(old, true);
+  }
+
+  atomic(const atomic &) = delete;
+  atomic &operator=(const atomic &) = delete;
+  atomic &operator=(const atomic &) volatile = delete;
+
+  inline bool is_lock_free() const noexcept
+  {
+    return this->is_always_lock_free;
+  }
+
+  /**
+   * @brief Get a shared pointer to the stored object
+   */
+  value_type load() noexcept
+  {
+    unsigned long word =
+      __atomic_add_fetch(&this->_word, one_local, __ATOMIC_ACQUIRE);
+    control_block_base *cb = block(word);
+    if (cb != nullptr)
+    {
+      cb->add_ref();
+    }
+
+    // Give the local reference back. If the word was replaced in the
+    // meantime, the writer already moved it into the control block.
+    unsigned long current = __atomic_load_n(&this->_word, __ATOMIC_RELAXED);
+    while (block(current) == cb && (current >> pointer_bits) != 0)
+    {
+      if (__atomic_compare_exchange_n(&this->_word, &current,
+                                      current - one_local, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+      {
+        return make(cb);
+      }
+    }
+    if (cb != nullptr)
+    {
+      cb->release();
+    }
+    return make(cb);
+  }
+
+  operator value_type() noexcept
+  {
+    return this->load();
+  }
+
+  inline void store(value_type desired) noexcept
+  {
+    unsigned long old = __atomic_exchange_n(
+      &this->_word, pack(tenno::move(desired)), __ATOMIC_ACQ_REL);
+    drop(old, true);
+  }
+
+  /**
+   * @brief Store desired and return the previous shared pointer
+   */
+  inline value_type exchange(value_type desired) noexcept
+  {
+    unsigned long old = __atomic_exchange_n(
+      &this->_word, pack(tenno::move(desired)), __ATOMIC_ACQ_REL);
+    drop(old, false);
+    return make(block(old));
+  }
+
+  /**
+   * @brief Store desired if the stored pointer shares the object and
+   * ownership of expected, otherwise load the stored pointer in
+   * expected
+   *
+   * @return true if desired was stored, false otherwise
+   */
+  inline bool compare_exchange_strong(value_type &expected,
+                                      value_type desired) noexcept
+  {
+    unsigned long current = __atomic_load_n(&this->_word, __ATOMIC_ACQUIRE);
+    while (true)
+    {
+      if (!same(block(current), expected))
+      {
+        value_type loaded = this->load();
+        if (loaded._control_block == expected._control_block
+            && loaded._object == expected._object)
+        {
+          current = __atomic_load_n(&this->_word, __ATOMIC_ACQUIRE);
+          continue;
+        }
+        expected = tenno::move(loaded);
+        return false;
+      }
+
+      unsigned long replacement = pack_block(desired);
+      if (__atomic_compare_exchange_n(&this->_word, &current, replacement,
+                                      false, __ATOMIC_ACQ_REL,
+                                      __ATOMIC_ACQUIRE))
+      {
+        // The atomic now owns the reference of desired
+        desired._object        = nullptr;
+        desired._control_block = nullptr;
+        drop(current, true);
+        return true;
+      }
+      // Only the local count changed, or another writer got in first
+    }
+  }
+
+  inline bool compare_exchange_weak(value_type &expected,
+                                    value_type desired) noexcept
+  {
+    return this->compare_exchange_strong(expected, tenno::move(desired));
+  }
+
+private:
+  static constexpr int pointer_bits = tenno::packed_pointer_bits;
+  static constexpr unsigned long pointer_mask = (1UL << pointer_bits) - 1;
+  static constexpr unsigned long one_local = 1UL << pointer_bits;
+
+  unsigned long _word;
+
+  static control_block_base *block(unsigned long word) noexcept
+  {
+    return (control_block_base *) (word & pointer_mask);
+  }
+
+  // Whether the stored block is the one expected would load
+  static bool same(control_block_base *cb, const value_type &expected) noexcept
+  {
+    if (cb != expected._control_block)
+    {
+      return false;
+    }
+    return cb == nullptr
+           || static_cast<void *>(expected._object) == cb->get_ptr();
+  }
+
+  // Build a shared pointer from a control block reference
+  static value_type make(control_block_base *cb) noexcept
+  {
+    value_type sp;
+    if (cb != nullptr)
+    {
+      sp._control_block = cb;
+      sp._object        = static_cast<T *>(cb->get_ptr());
+    }
+    return sp;
+  }
+
+  // Turn the reference held by sp into a word, wrapping aliased
+  // pointers in their own control block
+  static unsigned long pack(value_type &&sp) noexcept
+  {
+    unsigned long word = pack_block(sp);
+    sp._object         = nullptr;
+    sp._control_block  = nullptr;
+    return word;
+  }
+
+  // Get the word for sp, without taking its reference
+  static unsigned long pack_block(value_type &sp) noexcept
+  {
+    control_block_base *cb = sp._control_block;
+    if (cb != nullptr && static_cast<void *>(sp._object) != cb->get_ptr())
+    {
+      cb = new tenno::aliased_control_block<T, Deleter, Alloc>(
+        tenno::move(sp));
+      sp._object        = static_cast<T *>(cb->get_ptr());
+      sp._control_block = cb;
+    }
+    tenno::check_packed_pointer(cb);
+    return (unsigned long) cb;
+  }
+
+  // Move the local references of a replaced word into its control
+  // block, then drop the reference of the atomic if requested
+  static void drop(unsigned long word, bool release) noexcept
+  {
+    control_block_base *cb = block(word);
+    if (cb == nullptr)
+    {
+      return;
+    }
+    long locals = (long) (word >> pointer_bits);
+    if (locals != 0)
+    {
+      cb->add_refs(locals);
+    }
+    if (release)
+    {
+      cb->release();
+    }
+  }
+};
+
 } // namespace tenno
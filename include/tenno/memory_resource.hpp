@@ -0,0 +1,655 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <cstddef> // std::max_align_t
+#include <new>     // std::bad_alloc, std::align_val_t
+#include <tenno/instrumented_allocator.hpp>
+#include <tenno/mutex.hpp>
+#include <tenno/small_vector.hpp>
+#include <tenno/types.hpp>
+#include <tenno/vector.hpp>
+
+namespace tenno
+{
+
+/**
+ * @brief An interface to a source of memory chosen at runtime
+ *
+ * Resources implement do_allocate, do_deallocate and do_is_equal. The
+ * public functions forward to them. Statistics are opt-in: after
+ * enable_stats() they also count the requests, so every resource of a
+ * chain reports what went through it. Otherwise a request costs only
+ * the virtual call.
+ */
+class memory_resource
+{
+public:
+  static constexpr tenno::size max_align = alignof(std::max_align_t);
+
+  memory_resource() = default;
+  memory_resource(const memory_resource &) = default;
+  memory_resource &operator=(const memory_resource &) = default;
+  virtual ~memory_resource() = default;
+
+  /**
+   * @brief Get bytes of memory aligned to align
+   */
+  void *allocate(tenno::size bytes, tenno::size align = max_align)
+  {
+    void *p = this->do_allocate(bytes, align);
+    if (__builtin_expect(this->stats_enabled(), 0))
+    {
+      this->record_allocation(bytes);
+    }
+    return p;
+  }
+
+  /**
+   * @brief Give back memory returned by allocate with the same bytes
+   * and align
+   */
+  void deallocate(void *p, tenno::size bytes, tenno::size align = max_align)
+  {
+    this->do_deallocate(p, bytes, align);
+    if (__builtin_expect(this->stats_enabled(), 0))
+    {
+      this->record_deallocation(bytes);
+    }
+  }
+
+  /**
+   * @brief Check whether memory allocated by other can be freed by
+   * this resource
+   */
+  bool is_equal(const memory_resource &other) const noexcept
+  {
+    return this == &other || this->do_is_equal(other);
+  }
+
+  /**
+   * @brief Start or stop counting the requests made to this resource
+   *
+   * Meant to be called before the first request, memory allocated
+   * while the counters are off is not in bytes_in_use.
+   */
+  void enable_stats(bool enabled = true) noexcept
+  {
+    __atomic_store_n(&this->_stats_enabled, enabled, __ATOMIC_RELAXED);
+  }
+
+  bool stats_enabled() const noexcept
+  {
+    return __atomic_load_n(&this->_stats_enabled, __ATOMIC_RELAXED);
+  }
+
+  /**
+   * @brief Get the counters of the requests made to this resource
+   * while statistics were enabled
+   */
+  tenno::allocation_stats stats() const noexcept
+  {
+    tenno::allocation_stats s{};
+    s.allocations =
+      __atomic_load_n(&this->_stats.allocations, __ATOMIC_RELAXED);
+    s.deallocations =
+      __atomic_load_n(&this->_stats.deallocations, __ATOMIC_RELAXED);
+    s.bytes_allocated =
+      __atomic_load_n(&this->_stats.bytes_allocated, __ATOMIC_RELAXED);
+    s.bytes_in_use =
+      __atomic_load_n(&this->_stats.bytes_in_use, __ATOMIC_RELAXED);
+    s.peak_bytes_in_use =
+      __atomic_load_n(&this->_stats.peak_bytes_in_use, __ATOMIC_RELAXED);
+    return s;
+  }
+
+protected:
+  virtual void *do_allocate(tenno::size bytes, tenno::size align) = 0;
+  virtual void  do_deallocate(void *p, tenno::size bytes,
+                              tenno::size align) = 0;
+  virtual bool  do_is_equal(const memory_resource &other) const noexcept = 0;
+
+private:
+  void record_allocation(tenno::size bytes) noexcept
+  {
+    __atomic_fetch_add(&this->_stats.allocations, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&this->_stats.bytes_allocated, bytes,
+                       __ATOMIC_RELAXED);
+    tenno::size in_use = __atomic_add_fetch(&this->_stats.bytes_in_use,
+                                            bytes, __ATOMIC_RELAXED);
+    tenno::allocation_counters<void>::update_max(
+      this->_stats.peak_bytes_in_use, in_use);
+  }
+
+  void record_deallocation(tenno::size bytes) noexcept
+  {
+    __atomic_fetch_add(&this->_stats.deallocations, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&this->_stats.bytes_in_use, bytes, __ATOMIC_RELAXED);
+  }
+
+  tenno::allocation_stats _stats{};
+  bool _stats_enabled = false;
+};
+
+inline bool operator==(const memory_resource &a,
+                       const memory_resource &b) noexcept
+{
+  return a.is_equal(b);
+}
+
+namespace pmr
+{
+
+using tenno::memory_resource;
+
+/**
+ * @brief A resource that uses the global operator new and delete
+ */
+class new_delete_resource_t final : public memory_resource
+{
+protected:
+  void *do_allocate(tenno::size bytes, tenno::size align) override
+  {
+    return ::operator new(bytes, std::align_val_t(align));
+  }
+
+  void do_deallocate(void *p, tenno::size bytes, tenno::size align) override
+  {
+    ::operator delete(p, bytes, std::align_val_t(align));
+  }
+
+  bool do_is_equal(const memory_resource &other) const noexcept override
+  {
+    return dynamic_cast<const new_delete_resource_t *>(&other) != nullptr;
+  }
+};
+
+/**
+ * @brief A resource that fails every allocation
+ *
+ * Useful as the upstream of a resource that must never reach the
+ * heap, such as a monotonic_buffer_resource over a stack buffer.
+ */
+class null_memory_resource_t final : public memory_resource
+{
+protected:
+  void *do_allocate(tenno::size, tenno::size) override
+  {
+    throw std::bad_alloc();
+  }
+
+  void do_deallocate(void *, tenno::size, tenno::size) override
+  {
+  }
+
+  bool do_is_equal(const memory_resource &other) const noexcept override
+  {
+    return this == &other;
+  }
+};
+
+/**
+ * @brief Get the resource that uses operator new and delete
+ */
+inline memory_resource *new_delete_resource() noexcept
+{
+  static new_delete_resource_t resource;
+  return &resource;
+}
+
+/**
+ * @brief Get the resource that fails every allocation
+ */
+inline memory_resource *null_memory_resource() noexcept
+{
+  static null_memory_resource_t resource;
+  return &resource;
+}
+
+namespace detail
+{
+inline memory_resource *&default_resource() noexcept
+{
+  static memory_resource *resource = tenno::pmr::new_delete_resource();
+  return resource;
+}
+} // namespace detail
+
+/**
+ * @brief Get the resource used by default constructed
+ * polymorphic allocators
+ */
+inline memory_resource *get_default_resource() noexcept
+{
+  return __atomic_load_n(&detail::default_resource(), __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Set the resource used by default constructed polymorphic
+ * allocators, nullptr restores new_delete_resource()
+ *
+ * @return memory_resource* The previous default resource
+ */
+inline memory_resource *set_default_resource(memory_resource *r) noexcept
+{
+  if (r == nullptr)
+  {
+    r = tenno::pmr::new_delete_resource();
+  }
+  return __atomic_exchange_n(&detail::default_resource(), r,
+                             __ATOMIC_ACQ_REL);
+}
+
+/**
+ * @brief A resource that hands out memory by moving a pointer forward
+ * and frees it all at once
+ *
+ * Blocks are requested from the upstream resource, each twice as
+ * large as the previous one, after an optional initial buffer.
+ * deallocate does nothing, release() gives every block back to the
+ * upstream. Not thread-safe.
+ */
+class monotonic_buffer_resource : public memory_resource
+{
+public:
+  static constexpr tenno::size default_block_size = 1024;
+
+  explicit monotonic_buffer_resource(
+    memory_resource *upstream = get_default_resource()) noexcept
+      : monotonic_buffer_resource(default_block_size, upstream)
+  {
+  }
+
+  monotonic_buffer_resource(
+    tenno::size initial_size,
+    memory_resource *upstream = get_default_resource()) noexcept
+      : _upstream(upstream), _blocks(nullptr), _cursor(nullptr),
+        _end(nullptr), _buffer(nullptr), _buffer_size(0),
+        _first_size(initial_size != 0 ? initial_size : default_block_size),
+        _next_size(_first_size)
+  {
+  }
+
+  monotonic_buffer_resource(
+    void *buffer, tenno::size bytes,
+    memory_resource *upstream = get_default_resource()) noexcept
+      : _upstream(upstream), _blocks(nullptr),
+        _cursor(static_cast<char *>(buffer)),
+        _end(static_cast<char *>(buffer) + bytes),
+        _buffer(static_cast<char *>(buffer)), _buffer_size(bytes),
+        _first_size(bytes != 0 ? 2 * bytes : default_block_size),
+        _next_size(_first_size)
+  {
+  }
+
+  monotonic_buffer_resource(const monotonic_buffer_resource &) = delete;
+  monotonic_buffer_resource &
+  operator=(const monotonic_buffer_resource &) = delete;
+
+  ~monotonic_buffer_resource() override
+  {
+    this->release();
+  }
+
+  /**
+   * @brief Give every block back to the upstream and start again from
+   * the initial buffer
+   */
+  void release() noexcept
+  {
+    while (this->_blocks != nullptr)
+    {
+      block_header *prev = this->_blocks->prev;
+      this->_upstream->deallocate(this->_blocks, this->_blocks->size,
+                                  max_align);
+      this->_blocks = prev;
+    }
+    this->_cursor    = this->_buffer;
+    this->_end       = this->_buffer + this->_buffer_size;
+    this->_next_size = this->_first_size;
+  }
+
+  memory_resource *upstream_resource() const noexcept
+  {
+    return this->_upstream;
+  }
+
+protected:
+  void *do_allocate(tenno::size bytes, tenno::size align) override
+  {
+    char *p = align_up(this->_cursor, align);
+    if (p == nullptr || p > this->_end
+        || bytes > (tenno::size) (this->_end - p))
+    {
+      tenno::size needed     = sizeof(block_header) + bytes + align;
+      tenno::size block_size = this->_next_size;
+      while (block_size < needed)
+      {
+        block_size *= 2;
+      }
+      auto *block = static_cast<block_header *>(
+        this->_upstream->allocate(block_size, max_align));
+      block->prev   = this->_blocks;
+      block->size   = block_size;
+      this->_blocks = block;
+
+      this->_cursor    = reinterpret_cast<char *>(block + 1);
+      this->_end       = reinterpret_cast<char *>(block) + block_size;
+      this->_next_size = block_size * 2;
+      p                = align_up(this->_cursor, align);
+    }
+    this->_cursor = p + bytes;
+    return p;
+  }
+
+  void do_deallocate(void *, tenno::size, tenno::size) override
+  {
+  }
+
+  bool do_is_equal(const memory_resource &other) const noexcept override
+  {
+    return this == &other;
+  }
+
+private:
+  struct block_header
+  {
+    block_header *prev;
+    tenno::size   size;
+  };
+
+  static char *align_up(char *p, tenno::size align) noexcept
+  {
+    if (p == nullptr)
+    {
+      return nullptr;
+    }
+    tenno::size addr = (tenno::size) p;
+    return p + (((addr + align - 1) & ~(align - 1)) - addr);
+  }
+
+  memory_resource *_upstream;
+  block_header    *_blocks;
+  char            *_cursor;
+  char            *_end;
+  char            *_buffer;
+  tenno::size      _buffer_size;
+  tenno::size      _first_size;
+  tenno::size      _next_size;
+};
+
+/**
+ * @brief A resource that keeps a free list per block size
+ *
+ * Requests up to max_block_size bytes are rounded up to a power of two
+ * and served from the free list of that size. Empty lists are refilled
+ * with a chunk from the upstream resource, twice as large as the
+ * previous chunk of the same size. Larger or over-aligned requests go
+ * straight to the upstream. Memory is only given back to the upstream
+ * by release() and by the destructor. Not thread-safe, see
+ * synchronized_pool_resource.
+ */
+class unsynchronized_pool_resource : public memory_resource
+{
+public:
+  static constexpr tenno::size min_block_size = 8;
+  static constexpr tenno::size max_block_size = 4096;
+
+  explicit unsynchronized_pool_resource(
+    memory_resource *upstream = get_default_resource()) noexcept
+      : _upstream(upstream), _chunks(nullptr), _pools{}
+  {
+  }
+
+  unsynchronized_pool_resource(const unsynchronized_pool_resource &) = delete;
+  unsynchronized_pool_resource &
+  operator=(const unsynchronized_pool_resource &) = delete;
+
+  ~unsynchronized_pool_resource() override
+  {
+    this->release();
+  }
+
+  /**
+   * @brief Give every chunk back to the upstream
+   *
+   * Every block served from the pools becomes invalid. Requests that
+   * went straight to the upstream are not affected.
+   */
+  void release() noexcept
+  {
+    while (this->_chunks != nullptr)
+    {
+      chunk_header *next = this->_chunks->next;
+      this->_upstream->deallocate(this->_chunks, this->_chunks->size,
+                                  max_align);
+      this->_chunks = next;
+    }
+    for (pool &p : this->_pools)
+    {
+      p = pool{};
+    }
+  }
+
+  memory_resource *upstream_resource() const noexcept
+  {
+    return this->_upstream;
+  }
+
+protected:
+  void *do_allocate(tenno::size bytes, tenno::size align) override
+  {
+    if (bytes > max_block_size || align > max_align)
+    {
+      return this->_upstream->allocate(bytes, align);
+    }
+    tenno::size index = pool_index(bytes > align ? bytes : align);
+    pool       &p     = this->_pools[index];
+    if (p.free == nullptr)
+    {
+      this->refill(p, min_block_size << index);
+    }
+    free_block *b = p.free;
+    p.free        = b->next;
+    return b;
+  }
+
+  void do_deallocate(void *ptr, tenno::size bytes, tenno::size align) override
+  {
+    if (bytes > max_block_size || align > max_align)
+    {
+      this->_upstream->deallocate(ptr, bytes, align);
+      return;
+    }
+    pool &p       = this->_pools[pool_index(bytes > align ? bytes : align)];
+    free_block *b = static_cast<free_block *>(ptr);
+    b->next       = p.free;
+    p.free        = b;
+  }
+
+  bool do_is_equal(const memory_resource &other) const noexcept override
+  {
+    return this == &other;
+  }
+
+private:
+  struct free_block
+  {
+    free_block *next;
+  };
+
+  // Keeps the blocks that follow it aligned to max_align
+  struct alignas(std::max_align_t) chunk_header
+  {
+    chunk_header *next;
+    tenno::size   size;
+  };
+
+  struct pool
+  {
+    free_block *free        = nullptr;
+    tenno::size next_blocks = 16;
+  };
+
+  static constexpr tenno::size num_pools = 10; // 8 to 4096 bytes
+
+  static tenno::size pool_index(tenno::size bytes) noexcept
+  {
+    tenno::size index = 0;
+    while ((min_block_size << index) < bytes)
+    {
+      index++;
+    }
+    return index;
+  }
+
+  void refill(pool &p, tenno::size block_size)
+  {
+    tenno::size blocks = p.next_blocks;
+    tenno::size bytes  = sizeof(chunk_header) + blocks * block_size;
+    auto *chunk =
+      static_cast<chunk_header *>(this->_upstream->allocate(bytes, max_align));
+    chunk->next   = this->_chunks;
+    chunk->size   = bytes;
+    this->_chunks = chunk;
+    if (p.next_blocks < 1024)
+    {
+      p.next_blocks *= 2;
+    }
+
+    char *first = reinterpret_cast<char *>(chunk + 1);
+    for (tenno::size i = blocks; i > 0; i--)
+    {
+      free_block *b = reinterpret_cast<free_block *>(first
+                                                     + (i - 1) * block_size);
+      b->next       = p.free;
+      p.free        = b;
+    }
+  }
+
+  memory_resource *_upstream;
+  chunk_header    *_chunks;
+  pool             _pools[num_pools];
+};
+
+/**
+ * @brief A pool resource that can be shared between threads
+ *
+ * Same as unsynchronized_pool_resource, with every request taken
+ * under a lock.
+ */
+class synchronized_pool_resource : public unsynchronized_pool_resource
+{
+public:
+  using unsynchronized_pool_resource::unsynchronized_pool_resource;
+
+  void release() noexcept
+  {
+    tenno::lock_guard<tenno::mutex> guard(this->_lock);
+    unsynchronized_pool_resource::release();
+  }
+
+protected:
+  void *do_allocate(tenno::size bytes, tenno::size align) override
+  {
+    tenno::lock_guard<tenno::mutex> guard(this->_lock);
+    return unsynchronized_pool_resource::do_allocate(bytes, align);
+  }
+
+  void do_deallocate(void *p, tenno::size bytes, tenno::size align) override
+  {
+    tenno::lock_guard<tenno::mutex> guard(this->_lock);
+    unsynchronized_pool_resource::do_deallocate(p, bytes, align);
+  }
+
+private:
+  tenno::mutex _lock;
+};
+
+/**
+ * @brief An allocator that forwards to a memory_resource
+ *
+ * Containers using polymorphic_allocator have the same type whatever
+ * resource they use, so the allocation strategy is picked at runtime.
+ * A default constructed allocator uses get_default_resource(). Copies
+ * of a container keep the resource of the original.
+ *
+ * # Example
+ * ```cpp
+ * tenno::pmr::monotonic_buffer_resource arena;
+ * tenno::pmr::vector<int> v{tenno::pmr::polymorphic_allocator<int>(&arena)};
+ * ```
+ *
+ * @tparam T The type of the objects to allocate
+ */
+template <class T> class polymorphic_allocator
+{
+public:
+  using value_type = T;
+  using pointer = T *;
+  using const_pointer = const T *;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = tenno::size;
+
+  polymorphic_allocator() noexcept : _resource(get_default_resource())
+  {
+  }
+
+  polymorphic_allocator(memory_resource *r) noexcept : _resource(r)
+  {
+  }
+
+  template <class U>
+  polymorphic_allocator(const polymorphic_allocator<U> &other) noexcept
+      : _resource(other.resource())
+  {
+  }
+
+  T *allocate(tenno::size n)
+  {
+    return static_cast<T *>(
+      this->_resource->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T *p, tenno::size n)
+  {
+    if (p == nullptr)
+    {
+      return;
+    }
+    this->_resource->deallocate(p, n * sizeof(T), alignof(T));
+  }
+
+  memory_resource *resource() const noexcept
+  {
+    return this->_resource;
+  }
+
+  template <class U>
+  bool operator==(const polymorphic_allocator<U> &other) const noexcept
+  {
+    return this->_resource->is_equal(*other.resource());
+  }
+
+  template <class U>
+  bool operator!=(const polymorphic_allocator<U> &other) const noexcept
+  {
+    return !(*this == other);
+  }
+
+private:
+  memory_resource *_resource;
+};
+
+template <class T> using vector = tenno::vector<T, polymorphic_allocator<T>>;
+
+template <class T, tenno::size N>
+using small_vector = tenno::small_vector<T, N, polymorphic_allocator<T>>;
+
+} // namespace pmr
+
+} // namespace tenno
@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <new> // std::bad_alloc
+#include <tenno/memory.hpp>
+#include <tenno/types.hpp>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace tenno
+{
+
+/**
+ * @brief An allocator that maps large buffers directly from the
+ * operating system
+ *
+ * Allocations of at least Threshold bytes are served by mmap, smaller
+ * ones by tenno::allocator. Mapped buffers can be grown in place with
+ * reallocate(), which uses mremap to move the pages instead of
+ * copying them. Containers use reallocate() automatically for
+ * trivially relocatable elements.
+ *
+ * On platforms without mmap every allocation goes through
+ * tenno::allocator and reallocate() always fails.
+ *
+ * @tparam T The type of the objects to allocate
+ * @tparam Threshold The minimum size in bytes of a mapped allocation
+ */
+template <class T, tenno::size Threshold = 1024 * 1024> struct mmap_allocator
+{
+  using value_type = T;
+  using pointer = T *;
+  using const_pointer = const T *;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = tenno::size;
+
+  template <class U> struct rebind
+  {
+    using other = mmap_allocator<U, Threshold>;
+  };
+
+  mmap_allocator() noexcept = default;
+
+  template <class U>
+  mmap_allocator(const mmap_allocator<U, Threshold> &) noexcept
+  {
+  }
+
+  T *allocate(tenno::size n)
+  {
+    if (!is_mapped(n))
+    {
+      return tenno::allocator<T>().allocate(n);
+    }
+
+#if defined(__linux__)
+    void *p = mmap(nullptr, mapped_size(n), PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+    {
+      throw std::bad_alloc();
+    }
+    return (T *) p;
+#else
+    return nullptr;
+#endif
+  }
+
+  void deallocate(T *p, tenno::size n)
+  {
+    if (p == nullptr)
+    {
+      return;
+    }
+    if (!is_mapped(n))
+    {
+      tenno::allocator<T>().deallocate(p, n);
+      return;
+    }
+
+#if defined(__linux__)
+    munmap(p, mapped_size(n));
+#endif
+  }
+
+  /**
+   * @brief Grow or shrink a mapped buffer, preserving its bytes
+   *
+   * The buffer may be moved to a different address, but its pages are
+   * remapped rather than copied. Only buffers that are mapped both
+   * before and after the call can be reallocated.
+   *
+   * @param p The buffer returned by allocate(old_n)
+   * @param old_n The number of objects p was allocated for
+   * @param new_n The new number of objects
+   * @return T* The new buffer, or nullptr if p could not be remapped.
+   * In that case p is left untouched.
+   */
+  T *reallocate(T *p, tenno::size old_n, tenno::size new_n) noexcept
+  {
+#if defined(__linux__)
+    if (p == nullptr || !is_mapped(old_n) || !is_mapped(new_n))
+    {
+      return nullptr;
+    }
+    void *new_p = mremap(p, mapped_size(old_n), mapped_size(new_n),
+                         MREMAP_MAYMOVE);
+    if (new_p == MAP_FAILED)
+    {
+      return nullptr;
+    }
+    return (T *) new_p;
+#else
+    (void) p;
+    (void) old_n;
+    (void) new_n;
+    return nullptr;
+#endif
+  }
+
+  /**
+   * @brief Check whether an allocation of n objects is backed by mmap
+   */
+  static constexpr bool is_mapped(tenno::size n) noexcept
+  {
+#if defined(__linux__)
+    return n * sizeof(T) >= Threshold;
+#else
+    (void) n;
+    return false;
+#endif
+  }
+
+  constexpr bool operator==(const mmap_allocator &) const noexcept
+  {
+    return true;
+  }
+
+  constexpr bool operator!=(const mmap_allocator &) const noexcept
+  {
+    return false;
+  }
+
+private:
+  static tenno::size mapped_size(tenno::size n) noexcept
+  {
+#if defined(__linux__)
+    tenno::size page = (tenno::size) sysconf(_SC_PAGESIZE);
+    return (n * sizeof(T) + page - 1) & ~(page - 1);
+#else
+    return n * sizeof(T);
+#endif
+  }
+};
+
+} // namespace tenno
@@ -0,0 +1,278 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <cstdio>  // std::fopen
+#include <cstdlib> // std::strtoul
+#include <new>     // std::bad_alloc
+#include <tenno/memory.hpp>
+#include <tenno/types.hpp>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace tenno
+{
+
+/**
+ * @brief How a tenno::numa_allocator places pages on NUMA nodes
+ */
+enum class numa_policy
+{
+  local = 0,  // allocate on the node of the thread that first touches it
+  bind,       // allocate only on the nodes in the mask
+  interleave, // spread the pages round-robin over the nodes in the mask
+  preferred,  // allocate on the first node of the mask, fall back to others
+};
+
+/**
+ * @brief A set of NUMA nodes
+ */
+struct numa_node_list
+{
+  tenno::size   count; // the number of nodes in the list
+  unsigned long mask;  // bit i is set if node i is in the list, i < 64
+};
+
+/**
+ * @brief Parse a list of node ranges in the format of sysfs, such as
+ * "0-3,6"
+ */
+inline numa_node_list parse_numa_node_list(const char *list) noexcept
+{
+  numa_node_list nodes = {0, 0};
+  const char *cur = list;
+  char       *end = nullptr;
+  while (*cur >= '0' && *cur <= '9')
+  {
+    unsigned long first = std::strtoul(cur, &end, 10);
+    unsigned long last  = first;
+    cur                 = end;
+    if (*cur == '-')
+    {
+      last = std::strtoul(cur + 1, &end, 10);
+      cur  = end;
+    }
+    nodes.count += last - first + 1;
+    for (unsigned long node = first;
+         node <= last && node < sizeof(nodes.mask) * 8; ++node)
+    {
+      nodes.mask |= 1UL << node;
+    }
+    if (*cur == ',')
+    {
+      ++cur;
+    }
+  }
+  return nodes;
+}
+
+/**
+ * @brief Get the online NUMA nodes of the machine
+ *
+ * Read once from /sys/devices/system/node/online. When the machine is
+ * not NUMA or the information is not available, node 0 is the only
+ * node.
+ */
+inline const numa_node_list &numa_online_nodes() noexcept
+{
+  static const numa_node_list nodes = []() noexcept
+  {
+    numa_node_list online = {0, 0};
+#if defined(__linux__)
+    FILE *f = std::fopen("/sys/devices/system/node/online", "r");
+    if (f != nullptr)
+    {
+      char line[256];
+      if (std::fgets(line, sizeof(line), f) != nullptr)
+      {
+        online = tenno::parse_numa_node_list(line);
+      }
+      std::fclose(f);
+    }
+#endif
+    if (online.count == 0)
+    {
+      online = {1, 1};
+    }
+    return online;
+  }();
+  return nodes;
+}
+
+/**
+ * @brief Get the number of NUMA nodes of the machine
+ *
+ * @return tenno::size The number of online nodes, 1 if the machine
+ * is not NUMA or the information is not available
+ */
+inline tenno::size numa_node_count() noexcept
+{
+  return tenno::numa_online_nodes().count;
+}
+
+/**
+ * @brief An allocator that places memory on NUMA nodes by policy
+ *
+ * Every allocation is mapped with mmap and bound with the mbind
+ * system call, so the placement does not depend on which thread
+ * touches the memory first. Nodes are selected with a bit mask, where
+ * bit i selects node i. When the kernel has no NUMA support the pages
+ * keep the default placement.
+ *
+ * # Example
+ * ```cpp
+ * // Spread a large table over all the nodes
+ * tenno::numa_allocator<long> alloc(tenno::numa_policy::interleave);
+ * tenno::vector<long, tenno::numa_allocator<long>> table(alloc);
+ * ```
+ *
+ * @tparam T The type of the objects to allocate
+ */
+template <class T> struct numa_allocator
+{
+  using value_type = T;
+  using pointer = T *;
+  using const_pointer = const T *;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = tenno::size;
+
+  template <class U> friend struct numa_allocator;
+
+  /**
+   * @brief Mask selecting every node
+   */
+  static constexpr unsigned long all_nodes = ~0UL;
+
+  /**
+   * @brief Construct an allocator that interleaves over all nodes
+   */
+  numa_allocator() noexcept
+      : _policy(tenno::numa_policy::interleave), _nodemask(all_nodes)
+  {
+  }
+
+  explicit numa_allocator(tenno::numa_policy policy,
+                          unsigned long nodemask = all_nodes) noexcept
+      : _policy(policy), _nodemask(nodemask)
+  {
+  }
+
+  template <class U>
+  numa_allocator(const numa_allocator<U> &other) noexcept
+      : _policy(other._policy), _nodemask(other._nodemask)
+  {
+  }
+
+  T *allocate(tenno::size n)
+  {
+#if defined(__linux__)
+    if (n == 0)
+    {
+      return nullptr;
+    }
+    tenno::size bytes = mapped_size(n);
+    void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+    {
+      throw std::bad_alloc();
+    }
+    this->bind(p, bytes);
+    return (T *) p;
+#else
+    return tenno::allocator<T>().allocate(n);
+#endif
+  }
+
+  void deallocate(T *p, tenno::size n)
+  {
+    if (p == nullptr)
+    {
+      return;
+    }
+#if defined(__linux__)
+    munmap(p, mapped_size(n));
+#else
+    tenno::allocator<T>().deallocate(p, n);
+#endif
+  }
+
+  tenno::numa_policy policy() const noexcept
+  {
+    return _policy;
+  }
+
+  unsigned long nodemask() const noexcept
+  {
+    return _nodemask;
+  }
+
+  constexpr bool operator==(const numa_allocator &other) const noexcept
+  {
+    return _policy == other._policy && _nodemask == other._nodemask;
+  }
+
+  constexpr bool operator!=(const numa_allocator &other) const noexcept
+  {
+    return !(*this == other);
+  }
+
+private:
+#if defined(__linux__)
+  static tenno::size mapped_size(tenno::size n) noexcept
+  {
+    tenno::size page = (tenno::size) sysconf(_SC_PAGESIZE);
+    return (n * sizeof(T) + page - 1) & ~(page - 1);
+  }
+
+  void bind(void *p, tenno::size bytes) const noexcept
+  {
+    // Values of MPOL_* from linux/mempolicy.h
+    int mode = 0;
+    switch (_policy)
+    {
+    case tenno::numa_policy::local:
+      return;
+    case tenno::numa_policy::bind:
+      mode = 2;
+      break;
+    case tenno::numa_policy::interleave:
+      mode = 3;
+      break;
+    case tenno::numa_policy::preferred:
+      mode = 1;
+      break;
+    }
+
+    // Only keep the nodes that are online, mbind rejects the others.
+    // Node ids can have holes, "0-3,6" has no node 4.
+    unsigned long mask = _nodemask & tenno::numa_online_nodes().mask;
+    if (mask == 0)
+    {
+      return;
+    }
+
+#if defined(SYS_mbind)
+    // Placement is a hint, a failure leaves the default policy
+    syscall(SYS_mbind, p, bytes, mode, &mask, sizeof(mask) * 8, 0);
+#else
+    (void) p;
+    (void) bytes;
+    (void) mode;
+#endif
+  }
+#endif
+
+  tenno::numa_policy _policy;
+  unsigned long _nodemask;
+};
+
+} // namespace tenno
@@ -0,0 +1,476 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <memory>  // std::construct_at, std::destroy_at
+#include <new>     // std::align_val_t, std::nothrow
+#include <tenno/memory.hpp>
+#include <tenno/types.hpp>
+#include <utility> // std::forward
+
+namespace tenno
+{
+
+template <class T> class object_pool;
+template <class T> struct object_pool_allocator;
+
+/**
+ * @brief A deleter that destroys the object and gives its memory back
+ * to tenno::object_pool<T>
+ */
+template <class T> struct object_pool_deleter
+{
+  constexpr object_pool_deleter() noexcept = default;
+
+  void operator()(T *ptr) const noexcept
+  {
+    std::destroy_at(ptr);
+    tenno::object_pool<T>::deallocate(ptr);
+  }
+};
+
+/**
+ * @brief A pool of objects of type T, cached per thread
+ *
+ * Free objects are kept in magazines, arrays of magazine_size
+ * pointers. Every thread holds two magazines, so allocations and
+ * deallocations on the same thread only move a pointer in and out of
+ * an array. When both magazines of a thread are full, one of them is
+ * pushed to the depot, and a thread with no objects left takes a full
+ * magazine from the depot. The depot is a lock-free stack shared by
+ * all the threads.
+ *
+ * The depot keeps at most high_water() free objects, the objects
+ * beyond that are given back to the system. trim() gives back all the
+ * objects in the depot.
+ *
+ * All the instances of object_pool<T> share the same objects, the
+ * class has no state.
+ *
+ * # Example
+ * ```cpp
+ * tenno::object_pool<message> pool;
+ * auto m  = pool.make_unique(42);
+ * auto sm = pool.make_shared(43);
+ * ```
+ *
+ * @tparam T The type of the objects to allocate
+ */
+template <class T> class object_pool
+{
+  struct magazine;
+
+public:
+  /**
+   * @brief The number of objects in a magazine
+   */
+  static constexpr tenno::size magazine_size = 32;
+  /**
+   * @brief The maximum number of free objects in the depot by default
+   */
+  static constexpr tenno::size default_high_water = 128 * magazine_size;
+
+  using deleter_type = tenno::object_pool_deleter<T>;
+  using unique_ptr   = tenno::unique_ptr<T, deleter_type>;
+  using shared_ptr =
+    tenno::shared_ptr<T, deleter_type, tenno::object_pool_allocator<T>>;
+
+  constexpr object_pool() noexcept = default;
+
+  /**
+   * @brief Get uninitialized memory for one T
+   */
+  static void *allocate()
+  {
+    thread_cache &c = cache();
+    if (c.loaded == nullptr || c.loaded->count == 0)
+    {
+      if (c.previous != nullptr && c.previous->count > 0)
+      {
+        magazine *tmp = c.loaded;
+        c.loaded      = c.previous;
+        c.previous    = tmp;
+      }
+      else
+      {
+        magazine *full = take_full();
+        if (full == nullptr)
+        {
+          return ::operator new(sizeof(T), std::align_val_t(alignof(T)));
+        }
+        if (c.previous != nullptr)
+        {
+          give_empty(c.previous);
+        }
+        c.previous = c.loaded;
+        c.loaded   = full;
+      }
+    }
+    return c.loaded->rounds[--c.loaded->count];
+  }
+
+  /**
+   * @brief Give back memory returned by allocate, from any thread
+   */
+  static void deallocate(void *p) noexcept
+  {
+    if (p == nullptr)
+    {
+      return;
+    }
+    thread_cache &c = cache();
+    if (c.loaded == nullptr || c.loaded->count == magazine_size)
+    {
+      if (c.previous != nullptr && c.previous->count < magazine_size)
+      {
+        magazine *tmp = c.loaded;
+        c.loaded      = c.previous;
+        c.previous    = tmp;
+      }
+      else
+      {
+        magazine *empty = take_empty();
+        if (empty == nullptr)
+        {
+          free_object(p);
+          return;
+        }
+        if (c.previous != nullptr)
+        {
+          give_full(c.previous);
+        }
+        c.previous = c.loaded;
+        c.loaded   = empty;
+      }
+    }
+    c.loaded->rounds[c.loaded->count++] = p;
+  }
+
+  /**
+   * @brief Construct a T in the pool
+   *
+   * @return unique_ptr The object, given back to the pool when the
+   * pointer is destroyed
+   */
+  template <class... Args> static unique_ptr make_unique(Args &&...args)
+  {
+    return unique_ptr(construct(std::forward<Args>(args)...), deleter_type());
+  }
+
+  /**
+   * @brief Construct a T in the pool and share it
+   *
+   * The control block comes from the pool of its own type through
+   * tenno::object_pool_allocator.
+   */
+  template <class... Args> static shared_ptr make_shared(Args &&...args)
+  {
+    T *obj = construct(std::forward<Args>(args)...);
+    try
+    {
+      return shared_ptr(obj, deleter_type(),
+                        tenno::object_pool_allocator<T>());
+    }
+    catch (...)
+    {
+      deleter_type()(obj);
+      throw;
+    }
+  }
+
+  /**
+   * @brief Set the maximum number of free objects kept in the depot
+   *
+   * The objects already in the depot are not trimmed, call trim() for
+   * that.
+   */
+  static void set_high_water(tenno::size objects) noexcept
+  {
+    __atomic_store_n(&depot().high_water, objects, __ATOMIC_RELAXED);
+  }
+
+  /**
+   * @brief Get the maximum number of free objects kept in the depot
+   */
+  static tenno::size high_water() noexcept
+  {
+    return __atomic_load_n(&depot().high_water, __ATOMIC_RELAXED);
+  }
+
+  /**
+   * @brief Get the number of free objects in the depot, not counting
+   * the ones cached by the threads
+   */
+  static tenno::size cached() noexcept
+  {
+    return __atomic_load_n(&depot().rounds, __ATOMIC_RELAXED);
+  }
+
+  /**
+   * @brief Give all the free objects in the depot back to the system
+   */
+  static void trim() noexcept
+  {
+    magazine *m;
+    while ((m = take_full()) != nullptr)
+    {
+      free_rounds(m);
+      give_empty(m);
+    }
+  }
+
+private:
+  struct magazine
+  {
+    magazine   *next  = nullptr;
+    tenno::size count = 0;
+    void       *rounds[magazine_size];
+  };
+
+  /**
+   * Treiber stack of magazines. The top is tagged with a counter in
+   * the high 16 bits, so a magazine popped and pushed again between
+   * the load and the compare-exchange of another thread does not go
+   * unnoticed. Magazines must live below 2^48, see
+   * tenno::packed_pointer_bits. Magazines are only freed with the
+   * depot, reading the next field of a popped magazine is always safe.
+   */
+  struct magazine_stack
+  {
+    static constexpr int pointer_bits = tenno::packed_pointer_bits;
+    static constexpr unsigned long pointer_mask = (1UL << pointer_bits) - 1;
+    static constexpr unsigned long one_tag      = 1UL << pointer_bits;
+
+    unsigned long top = 0;
+
+    static magazine *pointer(unsigned long word) noexcept
+    {
+      return (magazine *) (word & pointer_mask);
+    }
+
+    void push(magazine *m) noexcept
+    {
+      tenno::check_packed_pointer(m);
+      unsigned long old = __atomic_load_n(&this->top, __ATOMIC_RELAXED);
+      unsigned long desired;
+      do
+      {
+        __atomic_store_n(&m->next, pointer(old), __ATOMIC_RELAXED);
+        desired = ((old & ~pointer_mask) + one_tag)
+                  | (unsigned long) m;
+      } while (!__atomic_compare_exchange_n(&this->top, &old, desired, true,
+                                            __ATOMIC_RELEASE,
+                                            __ATOMIC_RELAXED));
+    }
+
+    magazine *pop() noexcept
+    {
+      unsigned long old = __atomic_load_n(&this->top, __ATOMIC_ACQUIRE);
+      unsigned long desired;
+      magazine *m;
+      do
+      {
+        m = pointer(old);
+        if (m == nullptr)
+        {
+          return nullptr;
+        }
+        magazine *next = __atomic_load_n(&m->next, __ATOMIC_RELAXED);
+        desired = ((old & ~pointer_mask) + one_tag)
+                  | (unsigned long) next;
+      } while (!__atomic_compare_exchange_n(&this->top, &old, desired, true,
+                                            __ATOMIC_ACQUIRE,
+                                            __ATOMIC_ACQUIRE));
+      return m;
+    }
+  };
+
+  struct depot_t
+  {
+    magazine_stack full;
+    magazine_stack empty;
+    tenno::size    rounds     = 0;
+    tenno::size    high_water = default_high_water;
+
+    ~depot_t()
+    {
+      magazine *m;
+      while ((m = this->full.pop()) != nullptr)
+      {
+        free_rounds(m);
+        delete m;
+      }
+      while ((m = this->empty.pop()) != nullptr)
+      {
+        delete m;
+      }
+    }
+  };
+
+  struct thread_cache
+  {
+    magazine *loaded   = nullptr;
+    magazine *previous = nullptr;
+
+    ~thread_cache()
+    {
+      if (this->loaded != nullptr)
+      {
+        give_full(this->loaded);
+      }
+      if (this->previous != nullptr)
+      {
+        give_full(this->previous);
+      }
+    }
+  };
+
+  static thread_cache &cache() noexcept
+  {
+    thread_local thread_cache c;
+    return c;
+  }
+
+  static depot_t &depot() noexcept
+  {
+    static depot_t d;
+    return d;
+  }
+
+  template <class... Args> static T *construct(Args &&...args)
+  {
+    void *p = allocate();
+    try
+    {
+      return std::construct_at(static_cast<T *>(p),
+                               std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      deallocate(p);
+      throw;
+    }
+  }
+
+  static void free_object(void *p) noexcept
+  {
+    ::operator delete(p, std::align_val_t(alignof(T)));
+  }
+
+  static void free_rounds(magazine *m) noexcept
+  {
+    for (tenno::size i = 0; i < m->count; i++)
+    {
+      free_object(m->rounds[i]);
+    }
+    m->count = 0;
+  }
+
+  static magazine *take_empty() noexcept
+  {
+    magazine *m = depot().empty.pop();
+    if (m == nullptr)
+    {
+      m = new (std::nothrow) magazine();
+    }
+    return m;
+  }
+
+  static void give_empty(magazine *m) noexcept
+  {
+    depot().empty.push(m);
+  }
+
+  static magazine *take_full() noexcept
+  {
+    depot_t &d  = depot();
+    magazine *m = d.full.pop();
+    if (m != nullptr)
+    {
+      __atomic_fetch_sub(&d.rounds, m->count, __ATOMIC_RELAXED);
+    }
+    return m;
+  }
+
+  // Partially filled magazines are accepted, the depot hands them out
+  // like full ones
+  static void give_full(magazine *m) noexcept
+  {
+    depot_t &d = depot();
+    if (m->count == 0)
+    {
+      give_empty(m);
+      return;
+    }
+    tenno::size held = __atomic_load_n(&d.rounds, __ATOMIC_RELAXED);
+    if (held + m->count > __atomic_load_n(&d.high_water, __ATOMIC_RELAXED))
+    {
+      free_rounds(m);
+      give_empty(m);
+      return;
+    }
+    __atomic_fetch_add(&d.rounds, m->count, __ATOMIC_RELAXED);
+    d.full.push(m);
+  }
+};
+
+/**
+ * @brief An allocator taking single objects from tenno::object_pool
+ *
+ * Used as the Alloc of tenno::shared_ptr, the control block is
+ * allocated from the pool of the control block type. Requests for
+ * more than one object go to tenno::allocator. The allocator has no
+ * state.
+ *
+ * @tparam T The type of the objects to allocate
+ */
+template <class T> struct object_pool_allocator
+{
+  using value_type = T;
+  using pointer = T *;
+  using const_pointer = const T *;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = tenno::size;
+
+  constexpr object_pool_allocator() noexcept = default;
+
+  template <class U>
+  constexpr object_pool_allocator(const object_pool_allocator<U> &) noexcept
+  {
+  }
+
+  T *allocate(tenno::size n)
+  {
+    if (n != 1)
+    {
+      return tenno::allocator<T>().allocate(n);
+    }
+    return static_cast<T *>(tenno::object_pool<T>::allocate());
+  }
+
+  void deallocate(T *p, tenno::size n) noexcept
+  {
+    if (n != 1)
+    {
+      tenno::allocator<T>().deallocate(p, n);
+      return;
+    }
+    tenno::object_pool<T>::deallocate(p);
+  }
+
+  constexpr bool operator==(const object_pool_allocator &) const noexcept
+  {
+    return true;
+  }
+
+  constexpr bool operator!=(const object_pool_allocator &) const noexcept
+  {
+    return false;
+  }
+};
+
+} // namespace tenno
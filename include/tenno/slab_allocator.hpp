@@ -0,0 +1,285 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <cstddef> // std::max_align_t
+#include <new>     // std::align_val_t
+#include <tenno/memory.hpp>
+#include <tenno/mutex.hpp>
+#include <tenno/types.hpp>
+
+namespace tenno
+{
+
+/**
+ * @brief A pool of blocks of the same size, cached per thread
+ *
+ * Every thread keeps a free list of blocks, so allocations and
+ * deallocations on the same thread take no lock. Blocks move between
+ * a thread and the global pool in batches of batch_size: a thread
+ * with an empty list takes a whole batch, and a thread that collects
+ * too many free blocks gives a batch back. The global pool carves new
+ * batches out of slabs of slab_bytes.
+ *
+ * Slabs are never returned to the system, the memory of the pool only
+ * grows up to the peak number of live blocks.
+ *
+ * @tparam BlockSize The size of the objects to allocate
+ * @tparam Align The alignment of the objects to allocate
+ */
+template <tenno::size BlockSize, tenno::size Align> class slab_pool
+{
+  struct free_block
+  {
+    free_block *next;
+    // Only used by the first block of a batch in the global pool
+    free_block *next_batch;
+    tenno::size batch_count;
+  };
+
+  static constexpr tenno::size round_up(tenno::size n, tenno::size to) noexcept
+  {
+    return (n + to - 1) / to * to;
+  }
+
+public:
+  /**
+   * @brief The alignment of the blocks
+   */
+  static constexpr tenno::size block_align =
+    Align > alignof(free_block) ? Align : alignof(free_block);
+  /**
+   * @brief The size of the blocks, at least BlockSize
+   */
+  static constexpr tenno::size block_size = round_up(
+    BlockSize > sizeof(free_block) ? BlockSize : sizeof(free_block),
+    block_align);
+  /**
+   * @brief The number of blocks moved at once between a thread and
+   * the global pool
+   */
+  static constexpr tenno::size batch_size = 32;
+  /**
+   * @brief The size of the memory requested from the system at once
+   */
+  static constexpr tenno::size slab_bytes =
+    block_size * batch_size * 8 > 64 * 1024 ? block_size * batch_size * 8
+                                            : 64 * 1024;
+
+  /**
+   * @brief Get a block of block_size bytes
+   */
+  static void *allocate()
+  {
+    thread_cache &c = cache();
+    if (c.head == nullptr)
+    {
+      c.head  = take_batch();
+      c.count = c.head->batch_count;
+    }
+    free_block *b = c.head;
+    c.head        = b->next;
+    c.count--;
+    return b;
+  }
+
+  /**
+   * @brief Give back a block returned by allocate, from any thread
+   */
+  static void deallocate(void *p) noexcept
+  {
+    thread_cache &c = cache();
+    free_block *b   = static_cast<free_block *>(p);
+    b->next         = c.head;
+    c.head          = b;
+    c.count++;
+
+    // Keep one batch to serve the next allocations, give the rest back
+    if (c.count >= 2 * batch_size)
+    {
+      free_block *last = c.head;
+      for (tenno::size i = 1; i < batch_size; i++)
+      {
+        last = last->next;
+      }
+      free_block *batch = c.head;
+      c.head            = last->next;
+      c.count          -= batch_size;
+      last->next        = nullptr;
+      give_batch(batch, batch_size);
+    }
+  }
+
+private:
+  struct thread_cache
+  {
+    free_block *head  = nullptr;
+    tenno::size count = 0;
+
+    ~thread_cache()
+    {
+      if (this->head != nullptr)
+      {
+        give_batch(this->head, this->count);
+      }
+    }
+  };
+
+  // The first block of every slab links to the previous slab
+  struct global_pool
+  {
+    tenno::mutex lock;
+    free_block  *batches = nullptr;
+    void        *slabs   = nullptr;
+    char        *cursor  = nullptr;
+    char        *end     = nullptr;
+  };
+
+  static thread_cache &cache() noexcept
+  {
+    thread_local thread_cache c;
+    return c;
+  }
+
+  static global_pool &global() noexcept
+  {
+    static global_pool pool;
+    return pool;
+  }
+
+  static void give_batch(free_block *batch, tenno::size count) noexcept
+  {
+    global_pool &g     = global();
+    batch->batch_count = count;
+    g.lock.lock();
+    batch->next_batch = g.batches;
+    g.batches         = batch;
+    g.lock.unlock();
+  }
+
+  static free_block *take_batch()
+  {
+    global_pool &g = global();
+    g.lock.lock();
+    free_block *batch = g.batches;
+    if (batch != nullptr)
+    {
+      g.batches = batch->next_batch;
+      g.lock.unlock();
+      return batch;
+    }
+
+    if (g.cursor == g.end)
+    {
+      char *slab;
+      try
+      {
+        slab = static_cast<char *>(
+          ::operator new(slab_bytes, std::align_val_t(block_align)));
+      }
+      catch (...)
+      {
+        g.lock.unlock();
+        throw;
+      }
+      *reinterpret_cast<void **>(slab) = g.slabs;
+      g.slabs                          = slab;
+      g.cursor                         = slab + block_size;
+      g.end = g.cursor + (slab_bytes - block_size) / block_size * block_size;
+    }
+
+    // Carve a batch, possibly shorter at the end of a slab
+    tenno::size count = 0;
+    free_block *head  = nullptr;
+    while (count < batch_size && g.cursor != g.end)
+    {
+      free_block *b = reinterpret_cast<free_block *>(g.cursor);
+      b->next       = head;
+      head          = b;
+      g.cursor     += block_size;
+      count++;
+    }
+    g.lock.unlock();
+    head->batch_count = count;
+    return head;
+  }
+};
+
+/**
+ * @brief An allocator for many objects of the same type allocated one
+ * at a time, such as the control blocks of shared pointers
+ *
+ * Single objects come from a tenno::slab_pool shared by all the types
+ * with the same size and alignment, larger requests go to
+ * tenno::allocator. The allocator has no state, any instance can free
+ * the memory of any other.
+ *
+ * # Example
+ * ```cpp
+ * // The object and the control block come from the pool
+ * auto sp = tenno::allocate_shared<node>(tenno::slab_allocator<node>(), 42);
+ *
+ * // Only the control block comes from the pool
+ * tenno::shared_ptr<node, tenno::default_delete<node>,
+ *                   tenno::slab_allocator<node>>
+ *   sp2(new node(42), tenno::default_delete<node>(),
+ *       tenno::slab_allocator<node>());
+ * ```
+ *
+ * @tparam T The type of the objects to allocate
+ */
+template <class T> struct slab_allocator
+{
+  using value_type = T;
+  using pointer = T *;
+  using const_pointer = const T *;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = tenno::size;
+  using pool = tenno::slab_pool<sizeof(T), alignof(T)>;
+
+  constexpr slab_allocator() noexcept = default;
+
+  template <class U>
+  constexpr slab_allocator(const slab_allocator<U> &) noexcept
+  {
+  }
+
+  T *allocate(tenno::size n)
+  {
+    if (n != 1)
+    {
+      return tenno::allocator<T>().allocate(n);
+    }
+    return static_cast<T *>(pool::allocate());
+  }
+
+  void deallocate(T *p, tenno::size n) noexcept
+  {
+    if (p == nullptr)
+    {
+      return;
+    }
+    if (n != 1)
+    {
+      tenno::allocator<T>().deallocate(p, n);
+      return;
+    }
+    pool::deallocate(p);
+  }
+
+  constexpr bool operator==(const slab_allocator &) const noexcept
+  {
+    return true;
+  }
+
+  constexpr bool operator!=(const slab_allocator &) const noexcept
+  {
+    return false;
+  }
+};
+
+} // namespace tenno
@@ -0,0 +1,520 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <initializer_list>
+#include <tenno/error.hpp>
+#include <tenno/expected.hpp>
+#include <tenno/functional.hpp>
+#include <tenno/growth_policy.hpp>
+#include <tenno/iterator.hpp>
+#include <tenno/memory.hpp>
+#include <tenno/type_traits.hpp>
+#include <tenno/types.hpp>
+#include <type_traits> // std::is_nothrow_move_constructible_v
+#include <utility>     // std::forward
+
+namespace tenno
+{
+
+/**
+ * @brief A vector that stores the first N elements inline
+ *
+ * small_vector behaves like tenno::vector, but as long as it holds at
+ * most N elements they live inside the object itself and no heap
+ * allocation is performed. Past N elements the storage spills to the
+ * heap through Allocator.
+ *
+ * @tparam T The type of the elements
+ * @tparam N The number of elements stored inline
+ * @tparam Allocator The allocator used once the storage spills to the
+ * heap
+ * @tparam GrowthPolicy How the capacity grows when the vector is full,
+ * see tenno/growth_policy.hpp
+ */
+template <class T, tenno::size N, class Allocator = tenno::allocator<T>,
+          class GrowthPolicy = tenno::growth_factor_2>
+class small_vector
+{
+  static_assert(N > 0, "small_vector needs at least one inline element");
+
+public:
+  using value_type = T;
+  using allocator_type = Allocator;
+  using growth_policy = GrowthPolicy;
+  using size_type = tenno::size;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using pointer = typename Allocator::pointer;
+  using const_pointer = typename Allocator::const_pointer;
+  using difference_type = std::ptrdiff_t;
+
+  /**
+   * @brief The number of elements stored without allocating
+   */
+  static constexpr size_type inline_capacity = N;
+
+  small_vector() : _size(0), _capacity(N), _data(inline_data()), _allocator()
+  {
+  }
+
+  explicit small_vector(const Allocator &alloc)
+      : _size(0), _capacity(N), _data(inline_data()), _allocator(alloc)
+  {
+  }
+
+  small_vector(size_type count, const T &value,
+               const Allocator &alloc = Allocator())
+      : small_vector(alloc)
+  {
+    this->reserve(count);
+    for (; _size < count; ++_size)
+    {
+      new (&_data[_size]) T(value);
+    }
+  }
+
+  explicit small_vector(size_type count, const Allocator &alloc = Allocator())
+      : small_vector(alloc)
+  {
+    this->reserve(count);
+    for (; _size < count; ++_size)
+    {
+      new (&_data[_size]) T();
+    }
+  }
+
+  // Copy constructor
+  small_vector(const small_vector &other) : small_vector(other._allocator)
+  {
+    this->reserve(other._size);
+    for (; _size < other._size; ++_size)
+    {
+      new (&_data[_size]) T(other._data[_size]);
+    }
+  }
+
+  // Move constructor
+  small_vector(small_vector &&other) noexcept(nothrow_relocatable)
+      : small_vector(tenno::move(other._allocator))
+  {
+    this->steal(other);
+  }
+
+  // Initializer list constructor
+  small_vector(std::initializer_list<T> init,
+               const Allocator &alloc = Allocator())
+      : small_vector(alloc)
+  {
+    this->reserve(init.size());
+    for (const auto &item : init)
+    {
+      new (&_data[_size]) T(item);
+      ++_size;
+    }
+  }
+
+  ~small_vector()
+  {
+    this->clear();
+    this->release_heap();
+  }
+
+  small_vector &operator=(const small_vector &other)
+  {
+    if (this != &other)
+    {
+      this->clear();
+      this->reserve(other._size);
+      for (; _size < other._size; ++_size)
+      {
+        new (&_data[_size]) T(other._data[_size]);
+      }
+    }
+    return *this;
+  }
+
+  small_vector &operator=(small_vector &&other) noexcept(nothrow_relocatable)
+  {
+    if (this != &other)
+    {
+      this->clear();
+      this->release_heap();
+      _allocator = tenno::move(other._allocator);
+      this->steal(other);
+    }
+    return *this;
+  }
+
+  small_vector &operator=(std::initializer_list<value_type> ilist)
+  {
+    this->clear();
+    this->reserve(ilist.size());
+    for (const auto &item : ilist)
+    {
+      new (&_data[_size]) T(item);
+      ++_size;
+    }
+    return *this;
+  }
+
+  allocator_type get_allocator() const
+  {
+    return this->_allocator;
+  }
+
+  expected<tenno::reference_wrapper<T>, tenno::error> at(size_type pos)
+  {
+    if (pos >= _size)
+    {
+      return tenno::unexpected(tenno::error::out_of_range);
+    }
+    return tenno::reference_wrapper<T>(_data[pos]);
+  }
+
+  // Unsafe!
+  T &operator[](size_type pos)
+  {
+    return _data[pos];
+  }
+
+  // Unsafe!
+  const T &operator[](size_type pos) const
+  {
+    return _data[pos];
+  }
+
+  expected<tenno::reference_wrapper<const T>, tenno::error> front() const
+  {
+    if (_size == 0)
+    {
+      return tenno::unexpected(tenno::error::empty);
+    }
+    return tenno::reference_wrapper<const T>(_data[0]);
+  }
+
+  expected<tenno::reference_wrapper<const T>, tenno::error> back() const
+  {
+    if (_size == 0)
+    {
+      return tenno::unexpected(tenno::error::empty);
+    }
+    return tenno::reference_wrapper<const T>(_data[_size - 1]);
+  }
+
+  tenno::expected<pointer, tenno::error> data() noexcept
+  {
+    return _data;
+  }
+
+  tenno::expected<const_pointer, tenno::error> data() const noexcept
+  {
+    return const_pointer(_data);
+  }
+
+  /**
+   * @brief A random access iterator over the data, backed by a pointer
+   */
+  using iterator = tenno::contiguous_iterator<T>;
+  using const_iterator = tenno::contiguous_iterator<const T>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  iterator begin() noexcept
+  {
+    return iterator(_data);
+  }
+
+  iterator end() noexcept
+  {
+    return iterator(_data + _size);
+  }
+
+  const_iterator begin() const noexcept
+  {
+    return const_iterator(_data);
+  }
+
+  const_iterator end() const noexcept
+  {
+    return const_iterator(_data + _size);
+  }
+
+  const_iterator cbegin() const noexcept
+  {
+    return this->begin();
+  }
+
+  const_iterator cend() const noexcept
+  {
+    return this->end();
+  }
+
+  reverse_iterator rbegin() noexcept
+  {
+    return reverse_iterator(this->end());
+  }
+
+  reverse_iterator rend() noexcept
+  {
+    return reverse_iterator(this->begin());
+  }
+
+  const_reverse_iterator rbegin() const noexcept
+  {
+    return const_reverse_iterator(this->end());
+  }
+
+  const_reverse_iterator rend() const noexcept
+  {
+    return const_reverse_iterator(this->begin());
+  }
+
+  bool empty() const noexcept
+  {
+    return _size == 0;
+  }
+
+  size_type size() const noexcept
+  {
+    return _size;
+  }
+
+  size_type max_size() const noexcept
+  {
+    return (tenno::size) -1;
+  }
+
+  size_type capacity() const noexcept
+  {
+    return _capacity;
+  }
+
+  /**
+   * @brief Check whether the elements are stored inline
+   *
+   * @return true If no heap memory is in use
+   * @return false If the storage spilled to the heap
+   */
+  bool is_inline() const noexcept
+  {
+    return _data == inline_data();
+  }
+
+  void reserve(size_type new_cap)
+  {
+    if (new_cap <= _capacity)
+    {
+      return;
+    }
+
+    pointer new_data = _allocator.allocate(new_cap);
+    try
+    {
+      tenno::uninitialized_relocate_n(_data, _size, new_data);
+    }
+    catch (...)
+    {
+      _allocator.deallocate(new_data, new_cap);
+      throw;
+    }
+    this->release_heap();
+
+    _data     = new_data;
+    _capacity = new_cap;
+  }
+
+  /**
+   * @brief Release unused heap memory
+   *
+   * If the elements fit in the inline storage they are moved back
+   * into it.
+   */
+  void shrink_to_fit()
+  {
+    if (this->is_inline() || _size == _capacity)
+    {
+      return;
+    }
+
+    pointer new_data = (_size <= N) ? inline_data()
+                                     : _allocator.allocate(_size);
+    try
+    {
+      tenno::uninitialized_relocate_n(_data, _size, new_data);
+    }
+    catch (...)
+    {
+      if (_size > N)
+      {
+        _allocator.deallocate(new_data, _size);
+      }
+      throw;
+    }
+    this->release_heap();
+
+    _data     = new_data;
+    _capacity = (_size <= N) ? N : _size;
+  }
+
+  void clear() noexcept
+  {
+    for (size_type i = 0; i < _size; ++i)
+    {
+      _data[i].~T();
+    }
+    this->_size = 0;
+  }
+
+  void push_back(const T &value)
+  {
+    if (_size == _capacity)
+    {
+      this->grow(_size + 1);
+    }
+    new (&_data[_size]) T(value);
+    _size++;
+  }
+
+  void push_back(T &&value)
+  {
+    if (_size == _capacity)
+    {
+      this->grow(_size + 1);
+    }
+    new (&_data[_size]) T(tenno::move(value));
+    _size++;
+  }
+
+  template <class... Args> reference emplace_back(Args &&...args)
+  {
+    if (_size == _capacity)
+    {
+      this->grow(_size + 1);
+    }
+    new (&_data[_size]) T(std::forward<Args>(args)...);
+    return _data[_size++];
+  }
+
+  void pop_back() noexcept
+  {
+    if (_size == 0)
+    {
+      return;
+    }
+
+    _data[_size - 1].~T();
+    _size--;
+  }
+
+  void resize(size_type count)
+  {
+    if (count < _size)
+    {
+      for (size_type i = count; i < _size; ++i)
+      {
+        _data[i].~T();
+      }
+    }
+    else if (count > _size)
+    {
+      this->reserve(count);
+      for (size_type i = _size; i < count; ++i)
+      {
+        new (&_data[i]) T();
+      }
+    }
+    _size = count;
+  }
+
+  void resize(size_type count, const value_type &value)
+  {
+    if (count < _size)
+    {
+      for (size_type i = count; i < _size; ++i)
+      {
+        _data[i].~T();
+      }
+    }
+    else if (count > _size)
+    {
+      this->reserve(count);
+      for (size_type i = _size; i < count; ++i)
+      {
+        new (&_data[i]) T(value);
+      }
+    }
+    _size = count;
+  }
+
+  void swap(small_vector &other) noexcept(nothrow_relocatable)
+  {
+    small_vector tmp(tenno::move(other));
+    other = tenno::move(*this);
+    *this = tenno::move(tmp);
+  }
+
+private:
+  // Inline elements are relocated when the vector is moved, which can
+  // only throw if T has a throwing move constructor
+  static constexpr bool nothrow_relocatable =
+    std::is_nothrow_move_constructible_v<T>
+    || tenno::is_trivially_relocatable_v<T>;
+
+  pointer inline_data() noexcept
+  {
+    return reinterpret_cast<pointer>(_inline);
+  }
+
+  const_pointer inline_data() const noexcept
+  {
+    return reinterpret_cast<const_pointer>(_inline);
+  }
+
+  void grow(size_type required)
+  {
+    this->reserve(GrowthPolicy::grow(_capacity, required, sizeof(T)));
+  }
+
+  // Free the heap storage, if any. The elements must have been
+  // destroyed or relocated already.
+  void release_heap() noexcept
+  {
+    if (!this->is_inline())
+    {
+      _allocator.deallocate(_data, _capacity);
+      _data     = inline_data();
+      _capacity = N;
+    }
+  }
+
+  // Take the elements of other, which is left empty and inline.
+  // This vector must be empty and inline.
+  void steal(small_vector &other) noexcept(nothrow_relocatable)
+  {
+    if (other.is_inline())
+    {
+      tenno::uninitialized_relocate_n(other._data, other._size, _data);
+    }
+    else
+    {
+      _data           = other._data;
+      _capacity       = other._capacity;
+      other._data     = other.inline_data();
+      other._capacity = N;
+    }
+    _size       = other._size;
+    other._size = 0;
+  }
+
+  size_type _size;
+  size_type _capacity;
+  pointer   _data;
+  Allocator _allocator;
+  alignas(T) unsigned char _inline[N * sizeof(T)];
+};
+
+} // namespace tenno
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <tenno/utility.hpp>
 #include <thread> // based on thread
 
 namespace tenno
@@ -0,0 +1,532 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <cstdio> // std::fprintf
+#include <memory> // std::allocator_traits
+#include <tenno/instrumented_allocator.hpp>
+#include <tenno/memory.hpp>
+#include <tenno/mutex.hpp>
+#include <tenno/types.hpp>
+#include <tenno/utility.hpp>
+
+namespace tenno
+{
+
+/**
+ * @brief The counters of a tenno::allocation_tracker at one point in
+ * time
+ */
+struct heap_profile
+{
+  /**
+   * @brief The number of size classes, class i counts the requests of
+   * up to 2^i bytes and more than 2^(i-1), the last one counts all the
+   * larger requests
+   */
+  static constexpr tenno::size size_classes = 32;
+
+  tenno::allocation_stats stats;
+  tenno::size             histogram[size_classes];
+
+  /**
+   * @brief Get the size class of a request of bytes
+   */
+  static constexpr tenno::size size_class(tenno::size bytes) noexcept
+  {
+    if (bytes <= 1)
+    {
+      return 0;
+    }
+    tenno::size c =
+      (tenno::size) (64 - __builtin_clzll((unsigned long long) bytes - 1));
+    return c < size_classes ? c : size_classes - 1;
+  }
+
+  /**
+   * @brief Print the counters, then one line per non empty size class
+   */
+  void print(const char *name, FILE *out = stdout) const
+  {
+    std::fprintf(out,
+                 "%s: %zu allocations, %zu deallocations, %zu bytes "
+                 "allocated, %zu bytes live, %zu bytes peak\n",
+                 name, stats.allocations, stats.deallocations,
+                 stats.bytes_allocated, stats.bytes_in_use,
+                 stats.peak_bytes_in_use);
+    for (tenno::size c = 0; c < size_classes; c++)
+    {
+      if (histogram[c] == 0)
+      {
+        continue;
+      }
+      if (c + 1 == size_classes)
+      {
+        std::fprintf(out, "  > %10zu bytes: %zu\n",
+                     (tenno::size) 1 << (c - 1), histogram[c]);
+      }
+      else
+      {
+        std::fprintf(out, "  <= %9zu bytes: %zu\n", (tenno::size) 1 << c,
+                     histogram[c]);
+      }
+    }
+  }
+};
+
+/**
+ * @brief Where a tenno::tracking_allocator records its allocations,
+ * typically one per subsystem
+ *
+ * The counters are split in shards. A thread owns a shard while it
+ * runs and updates it with plain loads and stores, without locked
+ * instructions and without sharing the cache line with other threads.
+ * When more than num_shards - 1 threads allocate, the remaining ones
+ * share the last shard and update it atomically. The shards are only
+ * added up when snapshot() or dump() is called.
+ *
+ * The peak of live bytes is updated when the live bytes of a shard
+ * grow by peak_granularity since the last check and at every
+ * snapshot, so it can miss a short peak by at most peak_granularity
+ * bytes per shard.
+ *
+ * Trackers register themselves in a global list, dump_all() prints the
+ * profile of every live tracker.
+ *
+ * # Example
+ * ```cpp
+ * static tenno::allocation_tracker parser_memory("parser");
+ * tenno::vector<token, tenno::tracking_allocator<token>> tokens(
+ *   tenno::tracking_allocator<token>(parser_memory));
+ * // ...
+ * parser_memory.dump();
+ * ```
+ */
+class allocation_tracker
+{
+public:
+  /**
+   * @brief The number of shards of the counters
+   */
+  static constexpr tenno::size num_shards = 16;
+  /**
+   * @brief The growth of the live bytes of a shard that triggers an
+   * update of the peak
+   */
+  static constexpr tenno::size peak_granularity = 64 * 1024;
+
+  explicit allocation_tracker(const char *name) noexcept
+      : _name(name), _peak(0), _next(nullptr), _prev(nullptr), _shards{}
+  {
+    registry &r = get_registry();
+    tenno::lock_guard<tenno::mutex> guard(r.lock);
+    this->_next = r.head;
+    if (r.head != nullptr)
+    {
+      r.head->_prev = this;
+    }
+    r.head = this;
+  }
+
+  allocation_tracker(const allocation_tracker &) = delete;
+  allocation_tracker &operator=(const allocation_tracker &) = delete;
+
+  ~allocation_tracker()
+  {
+    registry &r = get_registry();
+    tenno::lock_guard<tenno::mutex> guard(r.lock);
+    if (this->_prev != nullptr)
+    {
+      this->_prev->_next = this->_next;
+    }
+    else
+    {
+      r.head = this->_next;
+    }
+    if (this->_next != nullptr)
+    {
+      this->_next->_prev = this->_prev;
+    }
+  }
+
+  /**
+   * @brief The tracker used by default constructed tracking allocators
+   */
+  static allocation_tracker &global() noexcept
+  {
+    static allocation_tracker tracker("global");
+    return tracker;
+  }
+
+  const char *name() const noexcept
+  {
+    return this->_name;
+  }
+
+  void record_allocation(tenno::size bytes) noexcept
+  {
+    shard &s    = this->local_shard();
+    bool shared = this->is_shared(s);
+    add(s.allocations, 1, shared);
+    add(s.bytes_allocated, bytes, shared);
+    add(s.histogram[heap_profile::size_class(bytes)], 1, shared);
+    tenno::size live = add(s.live, bytes, shared);
+    if ((long) live >= 0 && live >= load(s.next_peak_check))
+    {
+      __atomic_store_n(&s.next_peak_check, live + peak_granularity,
+                       __ATOMIC_RELAXED);
+      this->update_peak();
+    }
+  }
+
+  void record_deallocation(tenno::size bytes) noexcept
+  {
+    shard &s    = this->local_shard();
+    bool shared = this->is_shared(s);
+    add(s.deallocations, 1, shared);
+    // Memory can be freed on another thread than the one that
+    // allocated it, the live bytes of a shard can go below zero. Only
+    // the sum of all the shards is meaningful.
+    tenno::size live = add(s.live, -bytes, shared);
+    if ((long) live >= 0
+        && live + peak_granularity < load(s.next_peak_check))
+    {
+      __atomic_store_n(&s.next_peak_check, live + peak_granularity,
+                       __ATOMIC_RELAXED);
+    }
+  }
+
+  void record_growth(tenno::size bytes_moved, tenno::size capacity,
+                     tenno::size count, bool reallocated) noexcept
+  {
+    shard &s    = this->local_shard();
+    bool shared = this->is_shared(s);
+    if (reallocated)
+    {
+      add(s.reallocations, 1, shared);
+      add(s.bytes_moved, bytes_moved, shared);
+    }
+    tenno::allocation_counters<void>::update_max(s.peak_capacity, capacity);
+    tenno::allocation_counters<void>::update_max(s.peak_size, count);
+    add(s.growth_capacity, capacity, shared);
+    add(s.growth_size, count, shared);
+  }
+
+  /**
+   * @brief Add up the shards
+   */
+  heap_profile snapshot() noexcept
+  {
+    this->update_peak();
+    heap_profile p{};
+    for (shard &s : this->_shards)
+    {
+      p.stats.allocations += load(s.allocations);
+      p.stats.deallocations += load(s.deallocations);
+      p.stats.bytes_allocated += load(s.bytes_allocated);
+      p.stats.bytes_in_use += load(s.live);
+      p.stats.reallocations += load(s.reallocations);
+      p.stats.bytes_moved += load(s.bytes_moved);
+      if (load(s.peak_capacity) > p.stats.peak_capacity)
+      {
+        p.stats.peak_capacity = load(s.peak_capacity);
+      }
+      if (load(s.peak_size) > p.stats.peak_size)
+      {
+        p.stats.peak_size = load(s.peak_size);
+      }
+      p.stats.growth_capacity += load(s.growth_capacity);
+      p.stats.growth_size += load(s.growth_size);
+      for (tenno::size c = 0; c < heap_profile::size_classes; c++)
+      {
+        p.histogram[c] += load(s.histogram[c]);
+      }
+    }
+    p.stats.peak_bytes_in_use = load(this->_peak);
+    return p;
+  }
+
+  /**
+   * @brief Print the profile of this tracker
+   */
+  void dump(FILE *out = stdout) noexcept
+  {
+    this->snapshot().print(this->_name, out);
+  }
+
+  /**
+   * @brief Print the profile of every live tracker
+   */
+  static void dump_all(FILE *out = stdout) noexcept
+  {
+    registry &r = get_registry();
+    tenno::lock_guard<tenno::mutex> guard(r.lock);
+    for (allocation_tracker *t = r.head; t != nullptr; t = t->_next)
+    {
+      t->dump(out);
+    }
+  }
+
+  /**
+   * @brief Set all the counters to zero
+   *
+   * Meant to be called while no thread allocates, a thread updating
+   * its shard at the same time can bring back the old value of a
+   * counter.
+   */
+  void reset() noexcept
+  {
+    for (shard &s : this->_shards)
+    {
+      tenno::size *all[] = {&s.allocations,   &s.deallocations,
+                            &s.bytes_allocated, &s.live,
+                            &s.reallocations, &s.bytes_moved,
+                            &s.peak_capacity, &s.peak_size,
+                            &s.growth_capacity, &s.growth_size,
+                            &s.next_peak_check};
+      for (tenno::size *counter : all)
+      {
+        __atomic_store_n(counter, 0, __ATOMIC_RELAXED);
+      }
+      for (tenno::size &h : s.histogram)
+      {
+        __atomic_store_n(&h, 0, __ATOMIC_RELAXED);
+      }
+    }
+    __atomic_store_n(&this->_peak, 0, __ATOMIC_RELAXED);
+  }
+
+private:
+  struct alignas(64) shard
+  {
+    tenno::size allocations;
+    tenno::size deallocations;
+    tenno::size bytes_allocated;
+    tenno::size live;
+    tenno::size reallocations;
+    tenno::size bytes_moved;
+    tenno::size peak_capacity;
+    tenno::size peak_size;
+    tenno::size growth_capacity;
+    tenno::size growth_size;
+    tenno::size next_peak_check;
+    tenno::size histogram[heap_profile::size_classes];
+  };
+
+  struct registry
+  {
+    tenno::mutex        lock;
+    allocation_tracker *head = nullptr;
+  };
+
+  static registry &get_registry() noexcept
+  {
+    static registry r;
+    return r;
+  }
+
+  // Only the owner of a shard writes to it, unless it is shared
+  static tenno::size add(tenno::size &counter, tenno::size value,
+                         bool shared) noexcept
+  {
+    if (shared)
+    {
+      return __atomic_add_fetch(&counter, value, __ATOMIC_RELAXED);
+    }
+    tenno::size updated = load(counter) + value;
+    __atomic_store_n(&counter, updated, __ATOMIC_RELAXED);
+    return updated;
+  }
+
+  static tenno::size load(const tenno::size &counter) noexcept
+  {
+    return __atomic_load_n(&counter, __ATOMIC_RELAXED);
+  }
+
+  // The index of the shard owned by the calling thread, the same in
+  // every tracker. Released when the thread exits.
+  struct shard_slot
+  {
+    tenno::size index;
+
+    shard_slot() noexcept
+    {
+      const tenno::size owned_mask =
+        ((tenno::size) 1 << (num_shards - 1)) - 1;
+      tenno::size used = __atomic_load_n(&owned_slots(), __ATOMIC_RELAXED);
+      for (;;)
+      {
+        tenno::size available = ~used & owned_mask;
+        if (available == 0)
+        {
+          this->index = num_shards - 1;
+          return;
+        }
+        tenno::size bit = available & -available;
+        if (__atomic_compare_exchange_n(&owned_slots(), &used, used | bit,
+                                        true, __ATOMIC_ACQUIRE,
+                                        __ATOMIC_RELAXED))
+        {
+          this->index = (tenno::size) __builtin_ctzll(bit);
+          return;
+        }
+      }
+    }
+
+    ~shard_slot()
+    {
+      if (this->index != num_shards - 1)
+      {
+        __atomic_fetch_and(&owned_slots(), ~((tenno::size) 1 << this->index),
+                           __ATOMIC_RELEASE);
+      }
+    }
+  };
+
+  static tenno::size &owned_slots() noexcept
+  {
+    static tenno::size slots = 0;
+    return slots;
+  }
+
+  shard &local_shard() noexcept
+  {
+    thread_local shard_slot slot;
+    return this->_shards[slot.index];
+  }
+
+  bool is_shared(const shard &s) const noexcept
+  {
+    return &s == &this->_shards[num_shards - 1];
+  }
+
+  void update_peak() noexcept
+  {
+    tenno::size live = 0;
+    for (shard &s : this->_shards)
+    {
+      live += load(s.live);
+    }
+    tenno::allocation_counters<void>::update_max(this->_peak, live);
+  }
+
+  const char         *_name;
+  tenno::size         _peak;
+  allocation_tracker *_next;
+  allocation_tracker *_prev;
+  shard               _shards[num_shards];
+};
+
+/**
+ * @brief An allocator that records every allocation in a
+ * tenno::allocation_tracker
+ *
+ * The memory comes from Upstream. Allocations are counted by number,
+ * bytes and size class, and the live and peak bytes are kept, so the
+ * heap of a subsystem can be profiled in production by giving its
+ * containers and pointers an allocator bound to its tracker.
+ *
+ * # Example
+ * ```cpp
+ * static tenno::allocation_tracker cache_memory("cache");
+ * tenno::tracking_allocator<entry> alloc(cache_memory);
+ * tenno::vector<entry, tenno::tracking_allocator<entry>> entries(alloc);
+ * auto sp = tenno::allocate_shared<entry>(alloc, 42);
+ * auto up = tenno::allocate_unique<entry>(alloc, 43);
+ * tenno::allocation_tracker::dump_all();
+ * ```
+ *
+ * @tparam T The type of the objects to allocate
+ * @tparam Upstream The allocator that provides the memory
+ */
+template <class T, class Upstream = tenno::allocator<T>>
+struct tracking_allocator
+{
+  using value_type = T;
+  using pointer = T *;
+  using const_pointer = const T *;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = tenno::size;
+
+  template <class U> struct rebind
+  {
+    using other = tracking_allocator<
+      U, typename std::allocator_traits<Upstream>::template rebind_alloc<U>>;
+  };
+
+  template <class U, class> friend struct tracking_allocator;
+
+  /**
+   * @brief Record in tenno::allocation_tracker::global()
+   */
+  tracking_allocator() noexcept
+      : _state(&tenno::allocation_tracker::global(), Upstream())
+  {
+  }
+
+  explicit tracking_allocator(tenno::allocation_tracker &tracker,
+                              const Upstream &upstream = Upstream())
+      : _state(&tracker, upstream)
+  {
+  }
+
+  template <class U, class UUpstream>
+  tracking_allocator(const tracking_allocator<U, UUpstream> &other)
+      : _state(other._state.first(), Upstream(other._state.second()))
+  {
+  }
+
+  T *allocate(tenno::size n)
+  {
+    T *p = this->_state.second().allocate(n);
+    this->_state.first()->record_allocation(n * sizeof(T));
+    return p;
+  }
+
+  void deallocate(T *p, tenno::size n)
+  {
+    if (p == nullptr)
+    {
+      return;
+    }
+    this->_state.second().deallocate(p, n);
+    this->_state.first()->record_deallocation(n * sizeof(T));
+  }
+
+  /**
+   * @brief Called by containers when the capacity of their buffer
+   * changes
+   */
+  void record_growth(tenno::size old_capacity, tenno::size new_capacity,
+                     tenno::size count, tenno::size moved) noexcept
+  {
+    this->_state.first()->record_growth(moved * sizeof(T), new_capacity,
+                                        count, old_capacity != 0);
+  }
+
+  tenno::allocation_tracker &tracker() const noexcept
+  {
+    return *this->_state.first();
+  }
+
+  bool operator==(const tracking_allocator &other) const noexcept
+  {
+    return this->_state.first() == other._state.first()
+           && this->_state.second() == other._state.second();
+  }
+
+  bool operator!=(const tracking_allocator &other) const noexcept
+  {
+    return !(*this == other);
+  }
+
+private:
+  // A stateless upstream takes no space
+  tenno::compressed_pair<tenno::allocation_tracker *, Upstream> _state;
+};
+
+} // namespace tenno
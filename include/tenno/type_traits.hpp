@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#pragma once
+
+#include <type_traits>
+
+namespace tenno
+{
+
+/**
+ * @brief Whether an object of type T can be relocated with a plain
+ * memcpy
+ *
+ * Relocating an object means move-constructing it into new storage and
+ * destroying the source. For trivially relocatable types this pair
+ * of operations is equivalent to copying the bytes, so containers can
+ * grow with a single memcpy and skip the destructor loop.
+ *
+ * Trivially copyable types are detected automatically. User types that
+ * do not hold pointers into themselves (for example a type owning a
+ * heap buffer) can opt in by specializing this trait:
+ *
+ * ```cpp
+ * template <> struct tenno::is_trivially_relocatable<my_type>
+ *   : std::true_type {};
+ * ```
+ *
+ * @tparam T The type to check
+ */
+template <class T>
+struct is_trivially_relocatable
+    : std::bool_constant<std::is_trivially_copyable<T>::value>
+{
+};
+
+template <class T>
+inline constexpr bool is_trivially_relocatable_v =
+  tenno::is_trivially_relocatable<T>::value;
+
+} // namespace tenno
@@ -5,7 +5,8 @@
 
 #pragma once
 
-#include <type_traits> // std::remove_reference_t
+#include <type_traits> // std::remove_reference_t, std::is_empty_v
+#include <utility>     // std::forward
 
 namespace tenno
 {
@@ -23,4 +24,127 @@ constexpr std::remove_reference_t<T> &&move(T &&t) noexcept
   return static_cast<typename std::remove_reference<T>::type &&>(t);
 }
 
+namespace detail
+{
+
+// One half of a compressed_pair. Empty types are inherited from, so
+// they take no space, the others are stored as a member. Index keeps
+// the two halves distinct when T1 and T2 are the same type.
+template <class T, int Index,
+          bool Empty = std::is_empty_v<T> && !std::is_final_v<T>>
+struct compressed_pair_element
+{
+  T value{};
+
+  constexpr compressed_pair_element() = default;
+
+  template <class U>
+  constexpr compressed_pair_element(U &&u) : value(std::forward<U>(u))
+  {
+  }
+
+  constexpr T &get() noexcept
+  {
+    return this->value;
+  }
+
+  constexpr const T &get() const noexcept
+  {
+    return this->value;
+  }
+};
+
+template <class T, int Index>
+struct compressed_pair_element<T, Index, true> : private T
+{
+  constexpr compressed_pair_element() = default;
+
+  template <class U>
+  constexpr compressed_pair_element(U &&u) : T(std::forward<U>(u))
+  {
+  }
+
+  constexpr T &get() noexcept
+  {
+    return *this;
+  }
+
+  constexpr const T &get() const noexcept
+  {
+    return *this;
+  }
+};
+
+} // namespace detail
+
+/**
+ * @brief A pair that takes no space for its empty members
+ *
+ * Stateless types such as default deleters and allocators are stored
+ * as empty base classes, so a compressed_pair<T *, default_delete<T>>
+ * has the size of a pointer. The members are accessed with first()
+ * and second().
+ *
+ * # Example
+ * ```cpp
+ * tenno::compressed_pair<int *, tenno::default_delete<int>> p(
+ *   new int(42), tenno::default_delete<int>());
+ * static_assert(sizeof(p) == sizeof(int *));
+ * p.second()(p.first());
+ * ```
+ *
+ * @tparam T1 The type of the first member
+ * @tparam T2 The type of the second member
+ */
+template <class T1, class T2>
+class compressed_pair : private detail::compressed_pair_element<T1, 0>,
+                        private detail::compressed_pair_element<T2, 1>
+{
+  using first_base  = detail::compressed_pair_element<T1, 0>;
+  using second_base = detail::compressed_pair_element<T2, 1>;
+
+public:
+  using first_type  = T1;
+  using second_type = T2;
+
+  constexpr compressed_pair() = default;
+
+  template <class U1, class U2>
+  constexpr compressed_pair(U1 &&first, U2 &&second)
+      : first_base(std::forward<U1>(first)),
+        second_base(std::forward<U2>(second))
+  {
+  }
+
+  constexpr T1 &first() noexcept
+  {
+    return first_base::get();
+  }
+
+  constexpr const T1 &first() const noexcept
+  {
+    return first_base::get();
+  }
+
+  constexpr T2 &second() noexcept
+  {
+    return second_base::get();
+  }
+
+  constexpr const T2 &second() const noexcept
+  {
+    return second_base::get();
+  }
+
+  constexpr void swap(compressed_pair &other) noexcept
+  {
+    T1 tmp_first   = tenno::move(this->first());
+    this->first()  = tenno::move(other.first());
+    other.first()  = tenno::move(tmp_first);
+    T2 tmp_second  = tenno::move(this->second());
+    this->second() = tenno::move(other.second());
+    other.second() = tenno::move(tmp_second);
+  }
+};
+
 } // namespace tenno
@@ -5,11 +5,17 @@
 
 #pragma once
 
+#include <concepts> // std::same_as
+#include <cstring> // std::memmove
 #include <initializer_list>
+#include <iterator> // std::distance
+#include <ranges>   // std::ranges::distance, std::ranges::subrange
 #include <tenno/algorithm.hpp>
 #include <tenno/error.hpp>
 #include <tenno/expected.hpp>
 #include <tenno/functional.hpp>
+#include <tenno/growth_policy.hpp>
+#include <tenno/iterator.hpp>
 #include <tenno/memory.hpp>
 #include <tenno/ranges.hpp>
 #include <tenno/types.hpp>
@@ -18,21 +24,36 @@
 namespace tenno
 {
 
-template <class T, class Allocator = tenno::allocator<T>> class vector
+/**
+ * @brief A dynamically sized contiguous container
+ *
+ * @tparam T The type of the elements
+ * @tparam Allocator The allocator used for the elements storage
+ * @tparam GrowthPolicy How the capacity grows when the vector is full,
+ * see tenno/growth_policy.hpp
+ */
+template <class T, class Allocator = tenno::allocator<T>,
+          class GrowthPolicy = tenno::growth_factor_2>
+class vector
 {
 public:
   using value_type = T;
   using allocator_type = Allocator;
+  using growth_policy = GrowthPolicy;
   using size_type = tenno::size;
   using reference = value_type &;
   using const_reference = const value_type &;
   using pointer = typename Allocator::pointer;
   using const_pointer = typename Allocator::const_pointer;
-  using difference_type = T;
+  using difference_type = std::ptrdiff_t;
 
   constexpr vector()
       : _size(0), _capacity(0), _data(nullptr),
-        _allocator(tenno::allocator<T>()) {};
+        _allocator(Allocator()) {};
+
+  explicit constexpr vector(const Allocator &alloc)
+      : _size(0), _capacity(0), _data(nullptr),
+        _allocator(alloc) {};
 
   explicit constexpr vector(size_type count,
                   const T &value, const Allocator &alloc = Allocator())
@@ -43,7 +64,7 @@ public:
     _data = _allocator.allocate(_capacity);
     for (; _size < count; ++_size)
     {
-      new (&_data[_size]) T(value);
+      std::construct_at(&_data[_size], value);
     }
   }
   explicit constexpr vector(size_type count, const Allocator &alloc = Allocator())
@@ -54,12 +75,17 @@ public:
     _data = _allocator.allocate(_capacity);
     for (; _size < count; ++_size)
     {
-      new (&_data[_size]) T();
+      std::construct_at(&_data[_size]);
     }
   }
 
   // Copy constructor
-  constexpr vector(const vector &other, const Allocator &alloc = Allocator())
+  constexpr vector(const vector &other)
+    : vector(other, other._allocator)
+  {
+  }
+
+  constexpr vector(const vector &other, const Allocator &alloc)
     : _size(0),
       _capacity(other._capacity),
       _allocator(alloc)
@@ -68,7 +94,7 @@ public:
     _data = _allocator.allocate(_capacity);
     for (; _size < other._size; ++_size)
     {
-      new (&_data[_size]) T(other._data[_size]);
+      std::construct_at(&_data[_size], other._data[_size]);
     }
   }
 
@@ -90,19 +116,19 @@ public:
   {
     _data = _allocator.allocate(_capacity);
     for (const auto& item : init) {
-      new (&_data[_size]) T(item);
+      std::construct_at(&_data[_size], item);
       ++_size;
     }
   }
 
-  ~vector()
+  constexpr ~vector()
   {
     if (_data == nullptr)
       return;
 
     for (size_type i = 0; i < _size; ++i)
     {
-      _data[i].~T();
+      std::destroy_at(&_data[i]);
     }
     _allocator.deallocate(_data, _capacity);
   }
@@ -151,13 +177,13 @@ public:
     _size = 0;
     for (const auto& item : ilist)
     {
-      new (&_data[_size]) T(item);
+      std::construct_at(&_data[_size], item);
       ++_size;
     }
     return *this;
   }
 
-  void assign(size_type count, const T &value)
+  constexpr void assign(size_type count, const T &value)
   {
     if (count > _capacity)
     {
@@ -177,12 +203,12 @@ public:
     _size = 0;
     for (size_type i = 0; i < count; ++i)
     {
-      new (&_data[_size]) T(value);
+      std::construct_at(&_data[_size], value);
       ++_size;
     }
   }
 
-  void assign(std::initializer_list<T> ilist)
+  constexpr void assign(std::initializer_list<T> ilist)
   {
     if (ilist.size() > _capacity)
     {
@@ -202,12 +228,12 @@ public:
     _size = 0;
     for (const auto& i : ilist)
     {
-      new (&_data[_size]) T(i);
+      std::construct_at(&_data[_size], i);
       ++_size;
     }
   }
 
-  void assign_range(const tenno::range<T> &r)
+  constexpr void assign_range(const tenno::range<T> &r)
   {
     if (r.size() > _capacity)
     {
@@ -227,17 +253,17 @@ public:
     _size = 0;
     for (const auto& i : r)
     {
-      new (&_data[_size]) T(i);
+      std::construct_at(&_data[_size], i);
       ++_size;
     }
   }
 
-  allocator_type get_allocator() const
+  constexpr allocator_type get_allocator() const
   {
     return this->_allocator;
   }
 
-  expected<tenno::reference_wrapper<T>, tenno::error> at(size_type pos)
+  constexpr expected<tenno::reference_wrapper<T>, tenno::error> at(size_type pos)
   {
     if (pos >= _size)
     {
@@ -247,18 +273,18 @@ public:
   }
 
   // Unsafe!
-  T& operator[](size_type pos)
+  constexpr T& operator[](size_type pos)
   {
     return _data[pos];
   }
 
   // Unsafe!
-  const T& operator[](size_type pos) const
+  constexpr const T& operator[](size_type pos) const
   {
     return _data[pos];
   }
 
-  expected<tenno::reference_wrapper<const T>, tenno::error> front() const
+  constexpr expected<tenno::reference_wrapper<const T>, tenno::error> front() const
   {
     if (_size == 0)
     {
@@ -271,7 +297,7 @@ public:
     return tenno::reference_wrapper<const T>(_data[0]);
   }
 
-  expected<tenno::reference_wrapper<const T>, tenno::error> back() const
+  constexpr expected<tenno::reference_wrapper<const T>, tenno::error> back() const
   {
     if (_size == 0)
     {
@@ -284,7 +310,7 @@ public:
     return tenno::reference_wrapper<const T>(_data[_size - 1]);
   }
 
-  tenno::expected<pointer, tenno::error> data() noexcept
+  constexpr tenno::expected<pointer, tenno::error> data() noexcept
   {
     if (_data == nullptr)
     {
@@ -293,7 +319,7 @@ public:
     return _data;
   }
 
-  tenno::expected<const_pointer, tenno::error> data() const noexcept
+  constexpr tenno::expected<const_pointer, tenno::error> data() const noexcept
   {
     if (_data == nullptr)
     {
@@ -303,78 +329,12 @@ public:
   }
 
   /**
-   * @brief An iterator to iterate over the data
+   * @brief A random access iterator over the data, backed by a pointer
    */
-  struct iterator
-  {
-    using iterator_category = std::forward_iterator_tag;
-    using difference_type = std::ptrdiff_t;
-    using value_type = T;
-    using pointer = T *;
-    using reference = T &;
-
-    tenno::size index;
-    tenno::vector<T, Allocator> &vec;
-
-    explicit iterator(tenno::vector<T, Allocator> &_vec,
-                      const tenno::size _index)
-        : index(_index), vec(_vec)
-    {
-    }
-
-    iterator &operator++() noexcept
-    {
-      index++;
-      return *this;
-    }
-
-    iterator operator++(int) noexcept
-    {
-      iterator _iterator = *this;
-      ++index;
-      return _iterator;
-    }
-
-    bool operator==(const iterator &other) const noexcept
-    {
-      return index == other.index;
-    }
-
-    bool operator!=(const iterator &other) const noexcept
-    {
-      return !(index == other.index);
-    }
-
-    T& operator*() noexcept
-    {
-      return vec[index];
-    }
-
-    T* operator->() noexcept
-    {
-      return &vec[index];
-    }
-
-    iterator operator-(iterator &other) const noexcept
-    {
-      return this->index - other;
-    }
-
-    iterator operator+(const size_type &other) const noexcept
-    {
-      return this->index + other;
-    }
-
-    operator tenno::size() const noexcept 
-    {
-      return this->index;
-    }
-
-    T& get() noexcept
-    {
-      return vec[index];
-    }
-  };
+  using iterator = tenno::contiguous_iterator<T>;
+  using const_iterator = tenno::contiguous_iterator<const T>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
   /**
    * @brief Get an iterator to the beginning of the data
@@ -387,9 +347,9 @@ public:
    * auto begin = vec.begin();
    * ```
    */
-  iterator begin() noexcept
+  constexpr iterator begin() noexcept
   {
-    return iterator(*this, tenno::size(0));
+    return iterator(_data);
   }
 
   /**
@@ -402,78 +362,11 @@ public:
    * tenno::for_each(vec.begin(), vec.end(), [](int& elem) { elem = 0; });
    * ```
    */
-  iterator end() noexcept
+  constexpr iterator end() noexcept
   {
-    return iterator(*this, this->_size);
+    return iterator(_data + _size);
   }
 
-  /**
-   * @brief An iterator to iterate over the data
-   */
-  struct const_iterator
-  {
-    using iterator_category = std::forward_iterator_tag;
-    using difference_type = std::ptrdiff_t;
-    using value_type = const T;
-    using pointer = const T *;
-    using reference = const T &;
-
-    tenno::size index;
-    const tenno::vector<T, Allocator> &vec;
-
-    const_iterator(const iterator& other) 
-      : index(other.index), vec(other.vec) {}
-    
-    explicit const_iterator(const tenno::vector<T, Allocator> &_vec,
-                            const tenno::size _index)
-        : index(_index), vec(_vec)
-    {
-    }
-
-    const_iterator &operator++() noexcept
-    {
-      index++;
-      return *this;
-    }
-
-    const_iterator operator++(int) noexcept
-    {
-      const_iterator _iterator = *this;
-      ++index;
-      return _iterator;
-    }
-
-    bool operator==(const const_iterator &other) const noexcept
-    {
-      return index == other.index;
-    }
-
-    bool operator!=(const const_iterator &other) const noexcept
-    {
-      return !(index == other.index);
-    }
-
-    const T& operator*() const noexcept
-    {
-      return vec[index];
-    }
-
-    T* operator->() const noexcept
-    {
-      return &vec[index];
-    }
-
-    size_type operator-(const_iterator &other) const noexcept
-    {
-      return other.index - this->index;
-    }
-    
-    const T& get() const noexcept
-    {
-      return vec[index];
-    }
-  };
-
   /**
    * @brief Get a const_iterator to the beginning of the data
    *
@@ -485,9 +378,9 @@ public:
    * auto begin = vec.begin();
    * ```
    */
-  const_iterator begin() const noexcept
+  constexpr const_iterator begin() const noexcept
   {
-    return const_iterator(*this, tenno::size(0));
+    return const_iterator(_data);
   }
 
   /**
@@ -500,69 +393,20 @@ public:
    * tenno::for_each(vec.begin(), vec.end(), [](int& elem) { elem = 0; });
    * ```
    */
-  const_iterator end() const noexcept
+  constexpr const_iterator end() const noexcept
   {
-    return const_iterator(*this, this->_size);
+    return const_iterator(_data + _size);
   }
 
-  /**
-   * @brief An reverse_iterator to iterate over the data
-   */
-  struct reverse_iterator
+  constexpr const_iterator cbegin() const noexcept
   {
-    using reverse_iterator_category = std::forward_iterator_tag;
-    using difference_type = std::ptrdiff_t;
-    using value_type = T;
-    using pointer = T *;
-    using reference = T &;
-
-    long long int index;
-    tenno::vector<T, Allocator> &vec;
-
-    explicit reverse_iterator(tenno::vector<T, Allocator> &_vec,
-                              const long long int _index)
-        : index(_index), vec(_vec)
-    {
-    }
-
-    reverse_iterator &operator++() noexcept
-    {
-      index--;
-      return *this;
-    }
-
-    reverse_iterator operator++(int) noexcept
-    {
-      reverse_iterator _iterator = *this;
-      --index;
-      return _iterator;
-    }
-
-    bool operator==(const reverse_iterator &other) const noexcept
-    {
-      return index == other.index;
-    }
-
-    bool operator!=(const reverse_iterator &other) const noexcept
-    {
-      return !(index == other.index);
-    }
-
-    T& operator*() noexcept
-    {
-      return vec[index];
-    }
-
-    T* operator->() noexcept
-    {
-      return &vec[index];
-    }
+    return this->begin();
+  }
 
-    T& get() noexcept
-    {
-      return vec[index];
-    }
-  };
+  constexpr const_iterator cend() const noexcept
+  {
+    return this->end();
+  }
 
   /**
    * @brief Get an reverse_iterator to the beginning of the data
@@ -575,9 +419,9 @@ public:
    * auto begin = vec.rbegin();
    * ```
    */
-  reverse_iterator rbegin() noexcept
+  constexpr reverse_iterator rbegin() noexcept
   {
-    return reverse_iterator(*this, _size - 1);
+    return reverse_iterator(this->end());
   }
 
   /**
@@ -590,143 +434,149 @@ public:
    * tenno::for_each(vec.rbegin(), vec.rend(), [](int& elem) { elem = 0; });
    * ```
    */
-  reverse_iterator rend() noexcept
+  constexpr reverse_iterator rend() noexcept
+  {
+    return reverse_iterator(this->begin());
+  }
+
+  constexpr const_reverse_iterator rbegin() const noexcept
   {
-    return reverse_iterator(*this, -1);
+    return const_reverse_iterator(this->end());
   }
 
-  bool empty() const noexcept
+  constexpr const_reverse_iterator rend() const noexcept
+  {
+    return const_reverse_iterator(this->begin());
+  }
+
+  constexpr bool empty() const noexcept
   {
     return _size == 0;
   }
 
-  size_type size() const noexcept
+  constexpr size_type size() const noexcept
   {
     return _size;
   }
 
-  size_type max_size() const noexcept
+  constexpr size_type max_size() const noexcept
   {
     return (tenno::size) -1;
   }
 
-  void reserve(size_type new_cap)
+  constexpr void reserve(size_type new_cap)
   {
     if (new_cap <= _capacity)
     {
       return;
     }
-    
-    pointer new_data = _allocator.allocate(new_cap);
 
-    // Move elements into the new memory
-    for (size_type i = 0; i < _size; ++i)
+    size_type old_capacity = _capacity;
+    if (this->try_reallocate(new_cap))
     {
-      new (&new_data[i]) T(std::move(_data[i]));
+      this->record_growth(old_capacity, 0);
+      return;
     }
     
-    // Explicitly destroy the old objects
-    for (size_type i = 0; i < _size; ++i)
-    {
-      _data[i].~T();
-    }
+    pointer new_data = _allocator.allocate(new_cap);
+
+    // Move elements into the new memory and destroy the old ones
+    this->relocate_into(new_data, new_cap);
     
     _allocator.deallocate(_data, _capacity);
     _data     = new_data;
     _capacity = new_cap;
+    this->record_growth(old_capacity, _size);
   }
 
-  size_type capacity() const noexcept
+  constexpr size_type capacity() const noexcept
   {
     return _capacity;
   }
 
-  void shrink_to_fit() noexcept
+  constexpr void shrink_to_fit()
   {
     if (_size == _capacity)
     {
       return;
     }
-    pointer new_data = _allocator.allocate(_size);
-    
-    // Move elements into the new memory
-    for (size_type i = 0; i < _size; ++i)
+    size_type old_capacity = _capacity;
+    if (_size != 0 && this->try_reallocate(_size))
     {
-      new (&new_data[i]) T(std::move(_data[i]));
+      this->record_growth(old_capacity, 0);
+      return;
     }
+    pointer new_data = _allocator.allocate(_size);
     
-    // Explicitly destroy the old objects
-    for (size_type i = 0; i < _size; ++i)
-    {
-      _data[i].~T();
-    }
+    // Move elements into the new memory and destroy the old ones
+    this->relocate_into(new_data, _size);
     
     _allocator.deallocate(_data, _capacity);
     
     _data = new_data;
     _capacity = _size;
+    this->record_growth(old_capacity, _size);
   }
 
-  void clear() noexcept
+  constexpr void clear() noexcept
   {
     for (size_type i = 0; i < _size; ++i)
     {
-      _data[i].~T();
+      std::destroy_at(&_data[i]);
     }
     this->_size = 0;
   }
 
-  constexpr void push_back(const T &value) noexcept
+  constexpr void push_back(const T &value)
   {
     if (_size == _capacity)
     {
-      reserve(_capacity == 0 ? 1 : _capacity * 2);
+      this->grow(_size + 1);
     }
     
-    new (&_data[_size]) T(value);
+    std::construct_at(&_data[_size], value);
     _size++;
   }
 
-  constexpr void push_back(T &&value) noexcept
+  constexpr void push_back(T &&value)
   {
     if (_size == _capacity)
     {
-      reserve(_capacity == 0 ? 1 : _capacity * 2);
+      this->grow(_size + 1);
     }
-    new (&_data[_size]) T(std::move(value)); 
+    std::construct_at(&_data[_size], std::move(value)); 
     _size++;
   }
 
-  template <class... Args> reference emplace_back(Args &&...args) noexcept
+  template <class... Args> constexpr reference emplace_back(Args &&...args)
   {
     if (_size >= _capacity)
     {
-      size_type new_cap = (_capacity == 0) ? 1 : _capacity * 2;
-      this->reserve(new_cap);
+      this->grow(_size + 1);
     }
 
-    new (&_data[_size]) T(std::forward<Args>(args)...);
+    std::construct_at(&_data[_size], std::forward<Args>(args)...);
     return _data[_size++];
   }
 
-  void pop_back() noexcept
+  constexpr void pop_back() noexcept
   {
     if (_size == 0)
     {
       return;
     }
 
-    _data[_size - 1].~T();
+    std::destroy_at(&_data[_size - 1]);
     _size--;
   }
 
-  void resize(size_type count) noexcept
+  constexpr void resize(size_type count)
   {
     if (count < _size)
     {
       for (size_type i = count; i < _size; ++i)
       {
-        _data[i].~T();
+        std::destroy_at(&_data[i]);
       }
     }
     else if (count > _size)
@@ -734,19 +584,19 @@ public:
       reserve(count);
       for (size_type i = _size; i < count; ++i)
       {
-        new (&_data[i]) T();
+        std::construct_at(&_data[i]);
       }
     }
     _size = count;
   }
 
-  void resize(size_type count, const value_type &value) noexcept
+  constexpr void resize(size_type count, const value_type &value)
   {
     if (count < _size)
     {
       for (size_type i = count; i < _size; ++i)
       {
-        _data[i].~T();
+        std::destroy_at(&_data[i]);
       }
     }
     else if (count > _size)
@@ -754,13 +604,13 @@ public:
       reserve(count);
       for (size_type i = _size; i < count; ++i)
       {
-        new (&_data[i]) T(value);
+        std::construct_at(&_data[i], value);
       }
     }
     _size = count;
   }
 
-  void swap(vector &other) noexcept
+  constexpr void swap(vector &other) noexcept
   {
     tenno::swap(_size, other._size);
     tenno::swap(_capacity, other._capacity);
@@ -769,23 +619,280 @@ public:
   }
 
   template<class InputIt>
-  iterator insert(const_iterator pos, InputIt first, InputIt last)
+  constexpr iterator insert(const_iterator pos, InputIt first, InputIt last)
   {
-    size_type insert_idx = pos.index;
-    size_type count = 0;
-    for (InputIt it = first; it != last; ++it)
+    if constexpr (std::forward_iterator<InputIt>)
     {
-      count++;
+      size_type insert_idx = (size_type) (pos - this->cbegin());
+      size_type count      = (size_type) std::distance(first, last);
+      return this->insert_n(insert_idx, first, count);
     }
+    else
+    {
+      // Single pass, the range can only be walked once
+      return this->insert_range(pos, std::ranges::subrange(first, last));
+    }
+  }
 
-    if (count == 0) return iterator(*this, insert_idx);
+  /**
+   * @brief Erase the element at pos
+   *
+   * @return iterator Iterator to the element after the erased one
+   */
+  constexpr iterator erase(const_iterator pos)
+  {
+    return this->erase(pos, pos + 1);
+  }
+
+  /**
+   * @brief Erase the elements in [first, last)
+   *
+   * The tail is shifted once. For trivially relocatable elements it is
+   * moved with a single memmove.
+   *
+   * @return iterator Iterator to the element after the erased ones
+   */
+  constexpr iterator erase(const_iterator first, const_iterator last)
+  {
+    size_type from  = (size_type) (first - this->cbegin());
+    size_type to    = (size_type) (last - this->cbegin());
+    size_type count = to - from;
+    if (count == 0)
+    {
+      return this->begin() + (difference_type) from;
+    }
+
+    if constexpr (tenno::is_trivially_relocatable_v<T>)
+    {
+      if (!std::is_constant_evaluated())
+      {
+        for (size_type i = from; i < to; ++i)
+        {
+          std::destroy_at(&_data[i]);
+        }
+        if (to < _size)
+        {
+          std::memmove(static_cast<void *>(&_data[from]),
+                       static_cast<const void *>(&_data[to]),
+                       (_size - to) * sizeof(T));
+        }
+        _size -= count;
+        return this->begin() + (difference_type) from;
+      }
+    }
+
+    for (size_type i = to; i < _size; ++i)
+    {
+      _data[i - count] = tenno::move(_data[i]);
+    }
+    for (size_type i = _size - count; i < _size; ++i)
+    {
+      std::destroy_at(&_data[i]);
+    }
+    _size -= count;
+    return this->begin() + (difference_type) from;
+  }
+
+  /**
+   * @brief Insert the elements of a range before pos
+   *
+   * The storage grows at most once. Contiguous ranges of trivially
+   * copyable elements are copied with a single memcpy.
+   *
+   * @param pos The position to insert the elements at
+   * @param rg The range to insert, must not alias the vector
+   * @return iterator Iterator to the first inserted element
+   */
+  template <class R> constexpr iterator insert_range(const_iterator pos, R &&rg)
+  {
+    size_type insert_idx = (size_type) (pos - this->cbegin());
+    if constexpr (requires { rg.size(); })
+    {
+      return this->insert_n(insert_idx, std::begin(rg), (size_type) rg.size());
+    }
+    else if constexpr (std::ranges::forward_range<R>)
+    {
+      size_type count = (size_type) std::ranges::distance(rg);
+      return this->insert_n(insert_idx, std::ranges::begin(rg), count);
+    }
+    else
+    {
+      // A single pass range can not be measured up front, buffer it so
+      // that the tail is shifted once
+      vector buffer(_allocator);
+      for (auto &&elem : rg)
+      {
+        buffer.emplace_back(std::forward<decltype(elem)>(elem));
+      }
+      return this->insert_n(insert_idx,
+                            std::make_move_iterator(buffer.begin()),
+                            buffer.size());
+    }
+  }
+
+  /**
+   * @brief Append the elements of a range at the end of the vector
+   *
+   * The storage grows at most once. Contiguous ranges of trivially
+   * copyable elements are copied with a single memcpy.
+   *
+   * # Example
+   * ```cpp
+   * tenno::vector<int> vec = {1, 2};
+   * int more[] = {3, 4, 5};
+   * vec.append_range(more);
+   * ```
+   */
+  template <class R> constexpr void append_range(R &&rg)
+  {
+    this->insert_range(this->cend(), std::forward<R>(rg));
+  }
+
+  /**
+   * @brief Resize the vector without value-initializing new elements
+   *
+   * New elements are default-initialized, so for trivial types their
+   * content is indeterminate and no memory is written. This is meant
+   * for buffers that are overwritten right away through data().
+   *
+   * # Example
+   * ```cpp
+   * tenno::vector<char> buf;
+   * buf.resize_for_overwrite(4096);
+   * auto n = read(fd, buf.data().value(), buf.size());
+   * buf.resize(n);
+   * ```
+   */
+  constexpr void resize_for_overwrite(size_type count)
+  {
+    if (count < _size)
+    {
+      for (size_type i = count; i < _size; ++i)
+      {
+        std::destroy_at(&_data[i]);
+      }
+    }
+    else if (count > _size)
+    {
+      if (count > _capacity)
+      {
+        this->grow(count);
+      }
+      if (std::is_constant_evaluated())
+      {
+        // Constant evaluation can not leave objects uninitialized
+        for (size_type i = _size; i < count; ++i)
+        {
+          std::construct_at(&_data[i]);
+        }
+      }
+      else if constexpr (!std::is_trivially_default_constructible_v<T>)
+      {
+        for (size_type i = _size; i < count; ++i)
+        {
+          new (&_data[i]) T;
+        }
+      }
+    }
+    _size = count;
+  }
+
+  /**
+   * @brief Alias of resize_for_overwrite
+   */
+  constexpr void resize_default_init(size_type count)
+  {
+    this->resize_for_overwrite(count);
+  }
+  
+private:
+
+  // Relocate the elements into new_data, a buffer of new_cap elements.
+  // If an element throws, new_data is freed and the vector is left
+  // untouched.
+  constexpr void relocate_into(pointer new_data, size_type new_cap)
+  {
+    try
+    {
+      tenno::uninitialized_relocate_n(_data, _size, new_data);
+    }
+    catch (...)
+    {
+      _allocator.deallocate(new_data, new_cap);
+      throw;
+    }
+  }
+
+  // Make room for at least `required` elements following the growth
+  // policy
+  constexpr void grow(size_type required)
+  {
+    this->reserve(GrowthPolicy::grow(_capacity, required, sizeof(T)));
+  }
+
+  // Report a change of capacity to allocators that track it, see
+  // tenno/instrumented_allocator.hpp
+  constexpr void record_growth(size_type old_capacity, size_type moved)
+  {
+    if constexpr (requires(Allocator &a, size_type n) {
+                    a.record_growth(n, n, n, n);
+                  })
+    {
+      _allocator.record_growth(old_capacity, _capacity, _size, moved);
+    }
+    else
+    {
+      (void) old_capacity;
+      (void) moved;
+    }
+  }
+
+  // Insert count elements read from first before insert_idx
+  template <class InputIt>
+  constexpr iterator insert_n(size_type insert_idx, InputIt first, size_type count)
+  {
+    if (count == 0) return this->begin() + (difference_type) insert_idx;
 
     if (_size + count > _capacity)
     {
-      reserve(tenno::max(_size + count, _capacity * 2));
+      this->grow(_size + count);
     }
 
     size_type old_size = _size;
+
+    if constexpr (tenno::is_trivially_relocatable_v<T>)
+    {
+      if (!std::is_constant_evaluated())
+      {
+        // Open the gap with a single memmove and copy the new elements
+        // into the uninitialized hole. If a copy throws, the tail is
+        // moved back so that the vector is left as it was.
+        size_type tail = old_size - insert_idx;
+        if (tail != 0)
+        {
+          std::memmove(static_cast<void *>(&_data[insert_idx + count]),
+                       static_cast<const void *>(&_data[insert_idx]),
+                       tail * sizeof(T));
+        }
+        try
+        {
+          tenno::uninitialized_copy_n(first, count, &_data[insert_idx]);
+        }
+        catch (...)
+        {
+          if (tail != 0)
+          {
+            std::memmove(static_cast<void *>(&_data[insert_idx]),
+                         static_cast<const void *>(&_data[insert_idx + count]),
+                         tail * sizeof(T));
+          }
+          throw;
+        }
+        _size += count;
+        return this->begin() + (difference_type) insert_idx;
+      }
+    }
+
     _size += count;
 
     for (size_type i = old_size; i > insert_idx; --i)
@@ -795,7 +902,7 @@ public:
 
       if (dst_idx >= old_size)
       {
-        new (&_data[dst_idx]) T(tenno::move(_data[src_idx]));
+        std::construct_at(&_data[dst_idx], tenno::move(_data[src_idx]));
       }
       else
       {
@@ -807,10 +914,10 @@ public:
     for (size_type i = 0; i < count; ++i)
     {
       size_type dst_idx = insert_idx + i;
-        
+
       if (dst_idx >= old_size)
       {
-        new (&_data[dst_idx]) T(*current_input);
+        std::construct_at(&_data[dst_idx], *current_input);
       }
       else
       {
@@ -819,10 +926,38 @@ public:
       ++current_input;
     }
 
-    return iterator(*this, insert_idx);
+    return this->begin() + (difference_type) insert_idx;
+  }
+
+  // Resize the storage in place through Allocator::reallocate, if the
+  // allocator provides it and the elements can be moved bytewise.
+  // Returns false if the storage was left untouched.
+  constexpr bool try_reallocate(size_type new_cap) noexcept
+  {
+    if constexpr (tenno::is_trivially_relocatable_v<T>
+                  && requires(Allocator &a, pointer p, size_type n) {
+                       { a.reallocate(p, n, n) } -> std::same_as<pointer>;
+                     })
+    {
+      if (_data == nullptr || std::is_constant_evaluated())
+      {
+        return false;
+      }
+      pointer new_data = _allocator.reallocate(_data, _capacity, new_cap);
+      if (new_data == nullptr)
+      {
+        return false;
+      }
+      _data     = new_data;
+      _capacity = new_cap;
+      return true;
+    }
+    else
+    {
+      (void) new_cap;
+      return false;
+    }
   }
-  
-private:
   
   size_type _size;
   size_type _capacity;
@@ -831,4 +966,40 @@ private:
   
 };
 
+/**
+ * @brief Erase the elements of vec for which pred returns true
+ *
+ * The remaining elements keep their order and each is moved at most
+ * once, see tenno::remove_if.
+ *
+ * @return tenno::size The number of erased elements
+ *
+ * # Example
+ * ```cpp
+ * tenno::vector<int> vec = {1, 2, 3, 4};
+ * tenno::erase_if(vec, [](int x) { return x % 2 == 0; }); // {1, 3}
+ * ```
+ */
+template <class T, class Allocator, class GrowthPolicy, class Pred>
+constexpr tenno::size erase_if(tenno::vector<T, Allocator, GrowthPolicy> &vec,
+                               Pred pred)
+{
+  auto it = tenno::remove_if(vec.begin(), vec.end(), pred);
+  tenno::size count = (tenno::size) (vec.end() - it);
+  vec.erase(it, vec.end());
+  return count;
+}
+
+/**
+ * @brief Erase the elements of vec equal to value
+ *
+ * @return tenno::size The number of erased elements
+ */
+template <class T, class Allocator, class GrowthPolicy, class U>
+constexpr tenno::size erase(tenno::vector<T, Allocator, GrowthPolicy> &vec,
+                            const U &value)
+{
+  return tenno::erase_if(vec, [&value](const T &elem) { return elem == value; });
+}
+
 } // namespace tenno
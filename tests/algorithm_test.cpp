@@ -4,6 +4,7 @@
 // Github:  @San7o
 
 #include <tenno/algorithm.hpp>
+#include <string>
 #include <tenno/array.hpp>
 #include <valfuzz/valfuzz.hpp>
 
@@ -66,3 +67,33 @@ TEST(algorithm_swap, "tenno::swap")
   ASSERT(a == 2);
   ASSERT(b == 1);
 }
+
+TEST(algorithm_remove_if, "tenno::remove_if")
+{
+  int arr[] = {1, 2, 3, 4, 5, 6, 7};
+  int *end = tenno::remove_if(arr, arr + 7, [](int x) { return x % 2 == 0; });
+  ASSERT_EQ(end - arr, 4);
+  ASSERT_EQ(arr[0], 1);
+  ASSERT_EQ(arr[1], 3);
+  ASSERT_EQ(arr[2], 5);
+  ASSERT_EQ(arr[3], 7);
+
+  std::string words[] = {"keep", "drop", "keep too", "drop"};
+  std::string *words_end = tenno::remove(words, words + 4, "drop");
+  ASSERT_EQ(words_end - words, 2);
+  ASSERT_EQ(words[0], "keep");
+  ASSERT_EQ(words[1], "keep too");
+}
+
+TEST(algorithm_remove_if_constexpr, "tenno::remove_if constexpr")
+{
+  constexpr int kept = []() {
+    tenno::array<int, 6> arr{0, 1, 0, 2, 0, 3};
+    int data[6];
+    tenno::copy(arr.cbegin(), arr.cend(), data);
+    int *end = tenno::remove(data, data + 6, 0);
+    return (int) (end - data) * 100 + data[0] * 10 + data[2];
+  }();
+  static_assert(kept == 313);
+  ASSERT_EQ(kept, 313);
+}
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <tenno/arena.hpp>
+#include <tenno/memory.hpp>
+#include <tenno/vector.hpp>
+#include <valfuzz/valfuzz.hpp>
+
+TEST(monotonic_arena_allocate, "tenno::monotonic_arena allocate")
+{
+  tenno::monotonic_arena arena(64);
+  char *a = static_cast<char *>(arena.allocate(10, 1));
+  char *b = static_cast<char *>(arena.allocate(10, 1));
+  ASSERT(b == a + 10);
+  ASSERT_EQ(arena.used(), 20);
+
+  // Larger than the first block
+  void *big = arena.allocate(1000, 16);
+  ASSERT(big != nullptr);
+  ASSERT_EQ((tenno::size) big % 16, 0);
+
+  long *l = static_cast<long *>(arena.allocate(sizeof(long), alignof(long)));
+  *l = 42;
+  ASSERT_EQ(*l, 42);
+
+  arena.release();
+  ASSERT_EQ(arena.used(), 0);
+}
+
+TEST(monotonic_arena_buffer, "tenno::monotonic_arena initial buffer")
+{
+  alignas(16) char buffer[256];
+  tenno::monotonic_arena arena(buffer, sizeof(buffer));
+  void *p = arena.allocate(100, 16);
+  ASSERT(p == buffer);
+  void *q = arena.allocate(200, 16);
+  ASSERT(q != nullptr);
+  ASSERT(!((char *) q >= buffer && (char *) q < buffer + sizeof(buffer)));
+
+  arena.release();
+  ASSERT(arena.allocate(8, 1) == buffer);
+}
+
+TEST(monotonic_arena_extend, "tenno::monotonic_arena extend")
+{
+  tenno::monotonic_arena arena(1024);
+  void *a = arena.allocate(16, 8);
+  ASSERT(arena.extend(a, 16, 64));
+  void *b = arena.allocate(16, 8);
+  ASSERT(!arena.extend(a, 64, 128));
+  ASSERT(arena.extend(b, 16, 8));
+  ASSERT(!arena.extend(b, 8, 4096));
+}
+
+TEST(arena_allocator_vector, "tenno::vector with tenno::arena_allocator")
+{
+  tenno::monotonic_arena arena;
+  tenno::arena_allocator<int> alloc(arena);
+  tenno::vector<int, tenno::arena_allocator<int>> v(alloc);
+  for (int i = 0; i < 1000; i++)
+  {
+    v.push_back(i);
+  }
+  ASSERT_EQ(v.size(), 1000);
+  ASSERT_EQ(v[999], 999);
+
+  // The buffer is the last allocation, so it grows in place
+  ASSERT(arena.used() < 2 * 1000 * sizeof(int));
+
+  auto copy = v;
+  ASSERT(copy.get_allocator() == alloc);
+  ASSERT_EQ(copy[500], 500);
+}
+
+TEST(arena_allocator_shared_ptr, "tenno::shared_ptr with tenno::arena_allocator")
+{
+  tenno::monotonic_arena arena;
+  tenno::arena_allocator<long> alloc(arena);
+  {
+    auto sp = tenno::allocate_shared<long>(alloc, 5);
+    tenno::weak_ptr<long> weak(sp);
+    ASSERT_EQ(*sp, 5);
+    sp.reset();
+    ASSERT(weak.expired());
+
+    tenno::shared_ptr<long, tenno::default_delete<long>,
+                      tenno::arena_allocator<long>>
+      sp2(new long(6), tenno::default_delete<long>(), alloc);
+    ASSERT_EQ(*sp2, 6);
+  }
+  ASSERT(arena.used() > 0);
+}
@@ -4,6 +4,9 @@
 // Github:  @San7o
 
 #include <tenno/atomic.hpp>
+#include <tenno/memory.hpp>
+#include <tenno/thread.hpp>
+#include <tenno/vector.hpp>
 #include <valfuzz/valfuzz.hpp>
 
 TEST(atomic_create, "creating tenno::atomic")
@@ -419,3 +422,116 @@ TEST(atomic_long_compare_exhange_strong_success,
   auto value = a.load();
   ASSERT(value == 43);
 }
+
+// shared_ptr
+
+TEST(atomic_shared_ptr_load_store, "tenno::atomic<tenno::shared_ptr> load store")
+{
+  tenno::atomic<tenno::shared_ptr<int>> a;
+  ASSERT(a.is_lock_free());
+  ASSERT(!a.load());
+
+  auto first = tenno::make_shared<int>(1);
+  a.store(first);
+  ASSERT_EQ(first.use_count(), 2);
+  {
+    auto loaded = a.load();
+    ASSERT_EQ(*loaded, 1);
+    ASSERT_EQ(first.use_count(), 3);
+  }
+  ASSERT_EQ(first.use_count(), 2);
+
+  a.store(tenno::make_shared<int>(2));
+  ASSERT_EQ(first.use_count(), 1);
+  ASSERT_EQ(*a.load(), 2);
+}
+
+TEST(atomic_shared_ptr_exchange, "tenno::atomic<tenno::shared_ptr> exchange")
+{
+  tenno::atomic<tenno::shared_ptr<int>> a(tenno::make_shared<int>(1));
+  auto old = a.exchange(tenno::make_shared<int>(2));
+  ASSERT_EQ(*old, 1);
+  ASSERT_EQ(old.use_count(), 1);
+  ASSERT_EQ(*a.load(), 2);
+}
+
+TEST(atomic_shared_ptr_compare_exchange,
+     "tenno::atomic<tenno::shared_ptr> compare_exchange")
+{
+  auto first = tenno::make_shared<int>(1);
+  tenno::atomic<tenno::shared_ptr<int>> a(first);
+
+  auto other = tenno::make_shared<int>(3);
+  auto expected = other;
+  ASSERT(!a.compare_exchange_strong(expected, tenno::make_shared<int>(2)));
+  ASSERT_EQ(*expected, 1);
+
+  ASSERT(a.compare_exchange_strong(expected, tenno::make_shared<int>(2)));
+  ASSERT_EQ(*a.load(), 2);
+  ASSERT_EQ(first.use_count(), 2); // first and expected
+}
+
+struct atomic_pair
+{
+  int first;
+  int second;
+};
+
+TEST(atomic_shared_ptr_aliased, "tenno::atomic<tenno::shared_ptr> aliased")
+{
+  auto pair = tenno::make_shared<atomic_pair>(1, 2);
+  tenno::shared_ptr<int> second(pair, &pair->second);
+  tenno::atomic<tenno::shared_ptr<int>> a(second);
+  second.reset();
+  ASSERT_EQ(*a.load(), 2);
+  ASSERT_EQ(pair.use_count(), 2);
+  a.store(tenno::shared_ptr<int>());
+  ASSERT_EQ(pair.use_count(), 1);
+}
+
+TEST(atomic_shared_ptr_threads, "tenno::atomic<tenno::shared_ptr> readers and writers")
+{
+  auto first = tenno::make_shared<int>(0);
+  tenno::atomic<tenno::shared_ptr<int>> a(first);
+  int failures = 0;
+  {
+    tenno::vector<tenno::jthread> threads;
+    for (int t = 0; t < 3; t++)
+    {
+      threads.emplace_back(
+        [&a, &failures]()
+        {
+          int last = 0;
+          for (int i = 0; i < 20000; i++)
+          {
+            auto snapshot = a.load();
+            if (!snapshot || *snapshot < last)
+            {
+              __atomic_fetch_add(&failures, 1, __ATOMIC_RELAXED);
+            }
+            last = *snapshot;
+          }
+        });
+    }
+    threads.emplace_back(
+      [&a]()
+      {
+        for (int i = 1; i <= 2000; i++)
+        {
+          a.store(tenno::make_shared<int>(i));
+        }
+      });
+  }
+  ASSERT_EQ(failures, 0);
+  ASSERT_EQ(*a.load(), 2000);
+  ASSERT_EQ(first.use_count(), 1);
+}
+
+TEST(atomic_shared_ptr_packed_pointer,
+     "tenno::atomic<tenno::shared_ptr> control blocks fit in 48 bits")
+{
+  auto sp = tenno::make_shared<int>(5);
+  tenno::check_packed_pointer(sp._control_block);
+  ASSERT_EQ((unsigned long) sp._control_block >> tenno::packed_pointer_bits,
+            0);
+}
@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <string>
+#include <tenno/concurrent_vector.hpp>
+#include <tenno/instrumented_allocator.hpp>
+#include <tenno/thread.hpp>
+#include <tenno/vector.hpp>
+#include <valfuzz/valfuzz.hpp>
+
+TEST(concurrent_vector_empty, "tenno::concurrent_vector empty constructor")
+{
+  tenno::concurrent_vector<int> v;
+  ASSERT_EQ(v.size(), 0);
+  ASSERT(v.empty());
+  ASSERT_EQ(v.capacity(), 0);
+  ASSERT_EQ(v.at(0).error(), tenno::error::out_of_range);
+}
+
+TEST(concurrent_vector_push_back, "tenno::concurrent_vector push_back")
+{
+  tenno::concurrent_vector<int> v;
+  for (int i = 0; i < 1000; i++)
+  {
+    int &ref = v.push_back(i);
+    ASSERT_EQ(ref, i);
+  }
+  ASSERT_EQ(v.size(), 1000);
+  ASSERT(v.capacity() >= 1000);
+  for (tenno::size i = 0; i < 1000; i++)
+  {
+    ASSERT_EQ(v[i], (int) i);
+    ASSERT_EQ(v.at(i).value(), (int) i);
+  }
+  int i = 0;
+  for (auto it = v.begin(); it != v.end(); ++it)
+  {
+    ASSERT_EQ(*it, i++);
+  }
+}
+
+TEST(concurrent_vector_stable_references,
+     "tenno::concurrent_vector references are stable")
+{
+  tenno::concurrent_vector<std::string> v;
+  std::string &first = v.emplace_back("first");
+  std::string *first_addr = &first;
+  for (int i = 0; i < 10000; i++)
+  {
+    v.emplace_back("element");
+  }
+  ASSERT(&v[0] == first_addr);
+  ASSERT_EQ(first, "first");
+}
+
+TEST(concurrent_vector_reserve, "tenno::concurrent_vector reserve")
+{
+  tenno::concurrent_vector<int> v;
+  v.reserve(100);
+  ASSERT(v.capacity() >= 100);
+  ASSERT_EQ(v.size(), 0);
+}
+
+TEST(concurrent_vector_clear, "tenno::concurrent_vector clear")
+{
+  tenno::concurrent_vector<std::string> v;
+  v.push_back("a");
+  v.push_back("b");
+  v.clear();
+  ASSERT_EQ(v.size(), 0);
+  ASSERT_EQ(v.at(0).error(), tenno::error::out_of_range);
+  v.push_back("c");
+  ASSERT_EQ(v[0], "c");
+}
+
+TEST(concurrent_vector_concurrent_push_back,
+     "tenno::concurrent_vector concurrent push_back")
+{
+  const int num_threads = 16;
+  const int per_thread  = 2000;
+  tenno::concurrent_vector<long> v;
+  {
+    tenno::vector<tenno::jthread> threads;
+    for (int t = 0; t < num_threads; t++)
+    {
+      threads.emplace_back(
+        [&v, t]()
+        {
+          for (int i = 0; i < per_thread; i++)
+          {
+            long &ref = v.push_back((long) t * per_thread + i);
+            if (ref != (long) t * per_thread + i)
+            {
+              v.push_back(-1);
+            }
+          }
+        });
+    }
+  }
+  ASSERT_EQ(v.size(), (tenno::size) num_threads * per_thread);
+
+  tenno::vector<int> seen((tenno::size) num_threads * per_thread, 0);
+  for (tenno::size i = 0; i < v.size(); i++)
+  {
+    ASSERT(v.at(i).has_value());
+    ASSERT(v[i] >= 0);
+    seen[(tenno::size) v[i]]++;
+  }
+  for (tenno::size i = 0; i < seen.size(); i++)
+  {
+    ASSERT_EQ(seen[i], 1);
+  }
+}
+
+struct throwing_element
+{
+  static inline int alive = 0;
+
+  explicit throwing_element(bool fail)
+  {
+    if (fail)
+    {
+      throw 42;
+    }
+    alive++;
+  }
+
+  ~throwing_element()
+  {
+    alive--;
+  }
+};
+
+TEST(concurrent_vector_throwing_constructor,
+     "tenno::concurrent_vector constructor that throws")
+{
+  throwing_element::alive = 0;
+  {
+    tenno::concurrent_vector<throwing_element> v;
+    v.emplace_back(false);
+    bool thrown = false;
+    try
+    {
+      v.emplace_back(true);
+    }
+    catch (int)
+    {
+      thrown = true;
+    }
+    ASSERT(thrown);
+    for (int i = 0; i < 20; i++)
+    {
+      v.emplace_back(false);
+    }
+    ASSERT_EQ(v.size(), 22);
+    ASSERT_EQ(v.at(1).error(), tenno::error::not_initialized);
+    ASSERT(v.at(2).has_value());
+    ASSERT_EQ(throwing_element::alive, 21);
+    v.clear();
+    ASSERT_EQ(throwing_element::alive, 0);
+    v.emplace_back(false);
+    ASSERT(v.at(0).has_value());
+  }
+  ASSERT_EQ(throwing_element::alive, 0);
+}
+
+struct segment_allocations
+{
+};
+
+TEST(concurrent_vector_single_segment_allocation,
+     "tenno::concurrent_vector keeps one copy of each segment")
+{
+  using alloc = tenno::instrumented_allocator<long, segment_allocations>;
+  tenno::allocation_counters<segment_allocations>::reset();
+  {
+    tenno::concurrent_vector<long, alloc> v;
+    {
+      tenno::vector<tenno::jthread> threads;
+      for (int t = 0; t < 32; t++)
+      {
+        threads.emplace_back(
+          [&v]()
+          {
+            for (long i = 0; i < 1000; i++)
+            {
+              v.push_back(i);
+            }
+          });
+      }
+    }
+    ASSERT_EQ(v.size(), 32000);
+    // 8 * (2^12 - 1) = 32760 elements fit in 12 segments, the 13th was
+    // allocated when the 12th got half full. Copies allocated by
+    // threads that lost a race are already freed.
+    auto stats = tenno::allocation_counters<segment_allocations>::snapshot();
+    ASSERT_EQ(stats.allocations - stats.deallocations, 13);
+  }
+}
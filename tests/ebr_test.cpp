@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <tenno/ebr.hpp>
+#include <tenno/thread.hpp>
+#include <tenno/vector.hpp>
+#include <valfuzz/valfuzz.hpp>
+
+static long ebr_nodes_alive = 0;
+
+struct ebr_node
+{
+  long      value;
+  ebr_node *next = nullptr;
+
+  ebr_node(long v) : value(v)
+  {
+    __atomic_fetch_add(&ebr_nodes_alive, 1, __ATOMIC_RELAXED);
+  }
+
+  ~ebr_node()
+  {
+    value = -1;
+    __atomic_fetch_sub(&ebr_nodes_alive, 1, __ATOMIC_RELAXED);
+  }
+};
+
+TEST(ebr_guard, "tenno::ebr_domain::guard holds back reclamation")
+{
+  struct tag;
+  using domain = tenno::ebr_domain<tag>;
+  ebr_node *n = new ebr_node(42);
+  {
+    domain::guard g;
+    domain::guard nested;
+    domain::retire(n);
+    domain::cleanup();
+    ASSERT_EQ(domain::pending(), 1);
+    ASSERT_EQ(n->value, 42);
+  }
+  domain::cleanup();
+  ASSERT_EQ(domain::pending(), 0);
+  ASSERT_EQ(ebr_nodes_alive, 0);
+}
+
+TEST(ebr_epoch, "tenno::ebr_domain epoch advances without readers")
+{
+  struct tag;
+  using domain = tenno::ebr_domain<tag>;
+  unsigned long before = domain::epoch();
+  for (long i = 0; i < 1000; i++)
+  {
+    domain::retire(new ebr_node(i));
+  }
+  ASSERT(domain::epoch() > before);
+  ASSERT(domain::pending() < 1000);
+  domain::cleanup();
+  ASSERT_EQ(domain::pending(), 0);
+  ASSERT_EQ(ebr_nodes_alive, 0);
+}
+
+// A Treiber stack, popped nodes are reclaimed with epochs
+struct ebr_stack_tag;
+using ebr_stack_domain = tenno::ebr_domain<ebr_stack_tag>;
+
+struct ebr_stack
+{
+  ebr_node *head = nullptr;
+
+  void push(long value)
+  {
+    ebr_node *n = new ebr_node(value);
+    n->next     = __atomic_load_n(&this->head, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&this->head, &n->next, n, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    {
+    }
+  }
+
+  bool pop(long &value)
+  {
+    ebr_stack_domain::guard g;
+    ebr_node *top = __atomic_load_n(&this->head, __ATOMIC_ACQUIRE);
+    while (top != nullptr)
+    {
+      if (__atomic_compare_exchange_n(&this->head, &top, top->next, false,
+                                      __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+      {
+        value = top->value;
+        ebr_stack_domain::retire(top);
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+TEST(ebr_stress, "tenno::ebr_domain Treiber stack stress")
+{
+  ebr_stack stack;
+  long pushed = 0;
+  long popped = 0;
+  int failures = 0;
+  {
+    tenno::vector<tenno::jthread> threads;
+    for (int t = 0; t < 8; t++)
+    {
+      threads.emplace_back(
+        [&stack, &pushed, &popped, &failures]()
+        {
+          long local_pushed = 0;
+          long local_popped = 0;
+          for (long i = 1; i <= 20000; i++)
+          {
+            stack.push(i);
+            local_pushed += i;
+            long value;
+            if (stack.pop(value))
+            {
+              if (value <= 0)
+              {
+                __atomic_fetch_add(&failures, 1, __ATOMIC_RELAXED);
+              }
+              local_popped += value;
+            }
+          }
+          __atomic_fetch_add(&pushed, local_pushed, __ATOMIC_RELAXED);
+          __atomic_fetch_add(&popped, local_popped, __ATOMIC_RELAXED);
+        });
+    }
+  }
+  long value;
+  while (stack.pop(value))
+  {
+    popped += value;
+  }
+  ebr_stack_domain::cleanup();
+  ASSERT_EQ(failures, 0);
+  ASSERT_EQ(pushed, popped);
+  ASSERT_EQ(ebr_stack_domain::pending(), 0);
+  ASSERT_EQ(ebr_nodes_alive, 0);
+}
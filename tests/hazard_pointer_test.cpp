@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <tenno/hazard_pointer.hpp>
+#include <tenno/thread.hpp>
+#include <tenno/vector.hpp>
+#include <valfuzz/valfuzz.hpp>
+
+static long hp_nodes_alive = 0;
+
+struct hp_node
+{
+  long    value;
+  hp_node *next = nullptr;
+
+  hp_node(long v) : value(v)
+  {
+    __atomic_fetch_add(&hp_nodes_alive, 1, __ATOMIC_RELAXED);
+  }
+
+  ~hp_node()
+  {
+    value = -1;
+    __atomic_fetch_sub(&hp_nodes_alive, 1, __ATOMIC_RELAXED);
+  }
+};
+
+TEST(hazard_pointer_protect, "tenno::hazard_pointer protects from retire")
+{
+  struct tag;
+  using domain = tenno::hazard_domain<tag>;
+  hp_node *shared = new hp_node(42);
+  {
+    tenno::hazard_pointer<tag> hp;
+    hp_node *p = hp.protect(shared);
+    ASSERT(p == shared);
+
+    // The writer unlinks the node and retires it
+    __atomic_store_n(&shared, nullptr, __ATOMIC_RELEASE);
+    domain::retire(p);
+    domain::cleanup();
+    ASSERT_EQ(domain::pending(), 1);
+    ASSERT_EQ(p->value, 42);
+
+    hp.reset_protection();
+    domain::cleanup();
+    ASSERT_EQ(domain::pending(), 0);
+  }
+  ASSERT_EQ(hp_nodes_alive, 0);
+}
+
+TEST(hazard_pointer_try_protect, "tenno::hazard_pointer::try_protect")
+{
+  struct tag;
+  hp_node *a = new hp_node(1);
+  hp_node *b = new hp_node(2);
+  hp_node *src = a;
+  tenno::hazard_pointer<tag> hp;
+  hp_node *ptr = b;
+  ASSERT(!hp.try_protect(ptr, src));
+  ASSERT(ptr == a);
+  ASSERT(hp.try_protect(ptr, src));
+  hp.reset_protection();
+  delete a;
+  delete b;
+}
+
+TEST(hazard_pointer_move, "tenno::hazard_pointer move")
+{
+  struct tag;
+  using domain = tenno::hazard_domain<tag>;
+  hp_node *shared = new hp_node(7);
+  tenno::hazard_pointer<tag> hp;
+  hp.protect(shared);
+  tenno::hazard_pointer<tag> moved(tenno::move(hp));
+  domain::retire(shared);
+  domain::cleanup();
+  ASSERT_EQ(domain::pending(), 1);
+  moved.reset_protection();
+  domain::cleanup();
+  ASSERT_EQ(domain::pending(), 0);
+}
+
+struct hp_late_tag;
+
+// Destroyed after the thread state of the domain, like a hazard
+// pointer with static storage
+struct hp_late_holder
+{
+  tenno::hazard_pointer<hp_late_tag> *hp = nullptr;
+
+  ~hp_late_holder()
+  {
+    delete hp;
+  }
+};
+
+TEST(hazard_pointer_outlives_thread_state,
+     "tenno::hazard_pointer destroyed after the thread state")
+{
+  using domain = tenno::hazard_domain<hp_late_tag>;
+  hp_node *shared = new hp_node(3);
+  {
+    tenno::jthread t(
+      [&shared]()
+      {
+        thread_local hp_late_holder holder;
+        holder.hp = new tenno::hazard_pointer<hp_late_tag>();
+        holder.hp->protect(shared);
+      });
+  }
+  domain::retire(shared);
+  domain::cleanup();
+  ASSERT_EQ(domain::pending(), 0);
+  ASSERT_EQ(hp_nodes_alive, 0);
+}
+
+// A Treiber stack, popped nodes are reclaimed with hazard pointers
+struct hp_stack_tag;
+
+struct hp_stack
+{
+  hp_node *head = nullptr;
+
+  void push(long value)
+  {
+    hp_node *n = new hp_node(value);
+    n->next    = __atomic_load_n(&this->head, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&this->head, &n->next, n, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    {
+    }
+  }
+
+  bool pop(long &value)
+  {
+    tenno::hazard_pointer<hp_stack_tag> hp;
+    while (true)
+    {
+      hp_node *top = hp.protect(this->head);
+      if (top == nullptr)
+      {
+        return false;
+      }
+      hp_node *next = top->next;
+      if (__atomic_compare_exchange_n(&this->head, &top, next, false,
+                                      __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+      {
+        value = top->value;
+        hp.reset_protection();
+        tenno::hazard_domain<hp_stack_tag>::retire(top);
+        return true;
+      }
+    }
+  }
+};
+
+TEST(hazard_pointer_stress, "tenno::hazard_pointer Treiber stack stress")
+{
+  hp_stack stack;
+  long pushed = 0;
+  long popped = 0;
+  int failures = 0;
+  {
+    tenno::vector<tenno::jthread> threads;
+    for (int t = 0; t < 8; t++)
+    {
+      threads.emplace_back(
+        [&stack, &pushed, &popped, &failures]()
+        {
+          long local_pushed = 0;
+          long local_popped = 0;
+          for (long i = 1; i <= 20000; i++)
+          {
+            stack.push(i);
+            local_pushed += i;
+            long value;
+            if (stack.pop(value))
+            {
+              if (value <= 0)
+              {
+                __atomic_fetch_add(&failures, 1, __ATOMIC_RELAXED);
+              }
+              local_popped += value;
+            }
+          }
+          __atomic_fetch_add(&pushed, local_pushed, __ATOMIC_RELAXED);
+          __atomic_fetch_add(&popped, local_popped, __ATOMIC_RELAXED);
+        });
+    }
+  }
+  long value;
+  while (stack.pop(value))
+  {
+    popped += value;
+  }
+  tenno::hazard_domain<hp_stack_tag>::cleanup();
+  ASSERT_EQ(failures, 0);
+  ASSERT_EQ(pushed, popped);
+  ASSERT_EQ(tenno::hazard_domain<hp_stack_tag>::pending(), 0);
+  ASSERT_EQ(hp_nodes_alive, 0);
+}
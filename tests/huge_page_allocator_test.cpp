@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <tenno/huge_page_allocator.hpp>
+#include <tenno/vector.hpp>
+#include <valfuzz/valfuzz.hpp>
+
+TEST(huge_page_allocator_small, "tenno::huge_page_allocator small allocation")
+{
+  tenno::huge_page_allocator<int> alloc;
+  ASSERT(!alloc.is_mapped(16));
+  int *p = alloc.allocate(16);
+  for (int i = 0; i < 16; i++)
+  {
+    p[i] = i;
+  }
+  ASSERT_EQ(p[15], 15);
+  alloc.deallocate(p, 16);
+}
+
+TEST(huge_page_allocator_large, "tenno::huge_page_allocator large allocation")
+{
+  tenno::huge_page_allocator<char> alloc;
+  tenno::size n = 3 * tenno::huge_page_allocator<char>::huge_page_size + 1;
+  char *p = alloc.allocate(n);
+#if defined(__linux__)
+  ASSERT(alloc.is_mapped(n));
+  ASSERT_EQ((tenno::size) p
+              % tenno::huge_page_allocator<char>::huge_page_size,
+            0);
+#endif
+  p[0] = 'a';
+  p[n - 1] = 'z';
+  ASSERT_EQ(p[0], 'a');
+  ASSERT_EQ(p[n - 1], 'z');
+  alloc.deallocate(p, n);
+}
+
+TEST(huge_page_allocator_vector, "tenno::vector with tenno::huge_page_allocator")
+{
+  tenno::vector<long, tenno::huge_page_allocator<long>> v;
+  for (long i = 0; i < 1000000; i++)
+  {
+    v.push_back(i);
+  }
+  ASSERT_EQ(v.size(), 1000000);
+  for (long i = 0; i < 1000000; i++)
+  {
+    ASSERT_EQ(v[(tenno::size) i], i);
+  }
+}
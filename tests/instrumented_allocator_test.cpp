@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <tenno/instrumented_allocator.hpp>
+#include <tenno/mmap_allocator.hpp>
+#include <tenno/vector.hpp>
+#include <valfuzz/valfuzz.hpp>
+
+struct instrumented_site_a
+{
+};
+struct instrumented_site_b
+{
+};
+
+TEST(instrumented_allocator_counts, "tenno::instrumented_allocator counters")
+{
+  using alloc = tenno::instrumented_allocator<int, instrumented_site_a>;
+  alloc::reset();
+  {
+    alloc a;
+    int *p = a.allocate(10);
+    int *q = a.allocate(20);
+    auto stats = alloc::snapshot();
+    ASSERT_EQ(stats.allocations, 2);
+    ASSERT_EQ(stats.bytes_allocated, 30 * sizeof(int));
+    ASSERT_EQ(stats.bytes_in_use, 30 * sizeof(int));
+    a.deallocate(p, 10);
+    a.deallocate(q, 20);
+  }
+  auto stats = alloc::snapshot();
+  ASSERT_EQ(stats.deallocations, 2);
+  ASSERT_EQ(stats.bytes_in_use, 0);
+  ASSERT_EQ(stats.peak_bytes_in_use, 30 * sizeof(int));
+}
+
+TEST(instrumented_allocator_vector, "tenno::vector with instrumented_allocator")
+{
+  using alloc = tenno::instrumented_allocator<int, instrumented_site_b>;
+  alloc::reset();
+  {
+    tenno::vector<int, alloc> v;
+    for (int i = 0; i < 100; i++)
+    {
+      v.push_back(i);
+    }
+    // Capacity goes 1, 2, 4, ..., 128
+    auto stats = alloc::snapshot();
+    ASSERT_EQ(stats.allocations, 8);
+    ASSERT_EQ(stats.reallocations, 7);
+    ASSERT_EQ(stats.bytes_moved, (1 + 2 + 4 + 8 + 16 + 32 + 64) * sizeof(int));
+    ASSERT_EQ(stats.peak_capacity, 128);
+    ASSERT_EQ(stats.peak_size, 64);
+    // Capacity and size of each growth, 1/0, 2/1, 4/2, ..., 128/64
+    ASSERT_EQ(stats.growth_capacity, 255);
+    ASSERT_EQ(stats.growth_size, 127);
+    ASSERT_EQ(stats.capacity_ratio(), 255.0 / 127.0);
+  }
+  ASSERT_EQ(alloc::snapshot().bytes_in_use, 0);
+
+  // Counters are per tag
+  ASSERT_EQ(tenno::instrumented_allocator<long>::snapshot().allocations, 0);
+}
+
+TEST(instrumented_allocator_reallocate,
+     "tenno::instrumented_allocator forwards reallocate")
+{
+  struct mapped_site
+  {
+  };
+  using alloc = tenno::instrumented_allocator<char, mapped_site,
+                                              tenno::mmap_allocator<char, 4096>>;
+  alloc::reset();
+  {
+    tenno::vector<char, alloc> v;
+    v.reserve(8192);
+    v.resize(8192);
+    v.reserve(65536);
+    auto stats = alloc::snapshot();
+    ASSERT_EQ(stats.reallocations, 1);
+#if defined(__linux__)
+    // Grown in place by mremap, nothing moved
+    ASSERT_EQ(stats.allocations, 1);
+    ASSERT_EQ(stats.bytes_moved, 0);
+    // Only the new pages count, the old ones were never freed
+    ASSERT_EQ(stats.bytes_allocated, 65536);
+    ASSERT_EQ(stats.peak_bytes_in_use, 65536);
+#endif
+    ASSERT_EQ(stats.bytes_in_use, 65536);
+    ASSERT_EQ(stats.peak_capacity, 65536);
+  }
+  ASSERT_EQ(alloc::snapshot().bytes_in_use, 0);
+}
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <tenno/intrusive_ptr.hpp>
+#include <tenno/thread.hpp>
+#include <tenno/vector.hpp>
+#include <valfuzz/valfuzz.hpp>
+
+static int intrusive_destroyed = 0;
+
+struct intrusive_object : tenno::intrusive_ref_counter<intrusive_object>
+{
+  int value;
+
+  explicit intrusive_object(int v) : value(v)
+  {
+  }
+
+  virtual ~intrusive_object()
+  {
+    intrusive_destroyed++;
+  }
+};
+
+struct intrusive_derived : intrusive_object
+{
+  intrusive_derived() : intrusive_object(2)
+  {
+  }
+};
+
+struct local_object
+    : tenno::intrusive_ref_counter<local_object, tenno::thread_unsafe_counter>
+{
+  int value = 3;
+};
+
+TEST(intrusive_ptr_size, "tenno::intrusive_ptr is a single pointer")
+{
+  ASSERT_EQ(sizeof(tenno::intrusive_ptr<intrusive_object>), sizeof(void *));
+}
+
+TEST(intrusive_ptr_constructor, "tenno::intrusive_ptr constructor")
+{
+  intrusive_destroyed = 0;
+  tenno::intrusive_ptr<intrusive_object> empty;
+  ASSERT(!empty);
+  ASSERT(empty == nullptr);
+  {
+    tenno::intrusive_ptr<intrusive_object> p(new intrusive_object(10));
+    ASSERT_EQ(p->use_count(), 1);
+    auto copy = p;
+    ASSERT_EQ(p->use_count(), 2);
+    ASSERT(copy == p);
+    empty = copy;
+    ASSERT_EQ(p->use_count(), 3);
+  }
+  ASSERT_EQ(intrusive_destroyed, 0);
+  ASSERT_EQ(empty->use_count(), 1);
+  ASSERT_EQ((*empty).value, 10);
+  empty.reset();
+  ASSERT_EQ(intrusive_destroyed, 1);
+}
+
+TEST(intrusive_ptr_self_assignment, "tenno::intrusive_ptr self assignment")
+{
+  auto p = tenno::make_intrusive<intrusive_object>(5);
+  auto &alias = p;
+  p = alias;
+  ASSERT_EQ(p->use_count(), 1);
+  ASSERT_EQ(p->value, 5);
+}
+
+TEST(intrusive_ptr_raw_pointer, "tenno::intrusive_ptr from a raw pointer")
+{
+  auto p = tenno::make_intrusive<intrusive_object>(7);
+  intrusive_object *raw = p.get();
+  tenno::intrusive_ptr<intrusive_object> again(raw);
+  ASSERT_EQ(p->use_count(), 2);
+
+  intrusive_object *detached = again.detach();
+  ASSERT(!again);
+  ASSERT_EQ(p->use_count(), 2);
+  tenno::intrusive_ptr<intrusive_object> adopted(detached, false);
+  ASSERT_EQ(p->use_count(), 2);
+}
+
+TEST(intrusive_ptr_conversion, "tenno::intrusive_ptr derived to base")
+{
+  intrusive_destroyed = 0;
+  {
+    tenno::intrusive_ptr<intrusive_derived> d(new intrusive_derived());
+    tenno::intrusive_ptr<intrusive_object> b = d;
+    ASSERT_EQ(b->value, 2);
+    ASSERT_EQ(d->use_count(), 2);
+    tenno::intrusive_ptr<intrusive_object> moved = tenno::move(d);
+    ASSERT(!d);
+    ASSERT_EQ(b->use_count(), 2);
+  }
+  ASSERT_EQ(intrusive_destroyed, 1);
+}
+
+TEST(intrusive_ptr_from_unique_ptr, "tenno::intrusive_ptr from unique_ptr")
+{
+  intrusive_destroyed = 0;
+  {
+    tenno::unique_ptr<intrusive_object> u(new intrusive_object(8));
+    tenno::intrusive_ptr<intrusive_object> p(tenno::move(u));
+    ASSERT(!u);
+    ASSERT_EQ(p->use_count(), 1);
+    ASSERT_EQ(p->value, 8);
+  }
+  ASSERT_EQ(intrusive_destroyed, 1);
+}
+
+TEST(intrusive_ptr_thread_unsafe, "tenno::intrusive_ptr thread unsafe counter")
+{
+  auto p = tenno::make_intrusive<local_object>();
+  {
+    auto copy = p;
+    ASSERT_EQ(p->use_count(), 2);
+  }
+  ASSERT_EQ(p->use_count(), 1);
+  ASSERT_EQ(p->value, 3);
+}
+
+TEST(intrusive_ptr_threads, "tenno::intrusive_ptr copies from many threads")
+{
+  intrusive_destroyed = 0;
+  {
+    auto p = tenno::make_intrusive<intrusive_object>(1);
+    {
+      tenno::vector<tenno::jthread> threads;
+      for (int t = 0; t < 4; t++)
+      {
+        threads.emplace_back(
+          [&p]()
+          {
+            for (int i = 0; i < 10000; i++)
+            {
+              auto copy = p;
+              (void) copy;
+            }
+          });
+      }
+    }
+    ASSERT_EQ(p->use_count(), 1);
+  }
+  ASSERT_EQ(intrusive_destroyed, 1);
+}
@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <tenno/local_shared_ptr.hpp>
+#include <tenno/thread.hpp>
+#include <valfuzz/valfuzz.hpp>
+
+TEST(local_shared_ptr_constructor, "tenno::local_shared_ptr constructor")
+{
+  tenno::local_shared_ptr<int> sp;
+  ASSERT_EQ(sp.use_count(), 0);
+  ASSERT(!sp);
+  {
+    auto sp2 = tenno::local_shared_ptr<int>(new int(10));
+    sp = sp2;
+    ASSERT_EQ(sp.use_count(), 2);
+  }
+  ASSERT_EQ(sp.use_count(), 1);
+  ASSERT_EQ(*sp, 10);
+}
+
+TEST(local_shared_ptr_make, "tenno::make_local_shared")
+{
+  auto sp = tenno::make_local_shared<int>(5);
+  ASSERT_EQ(*sp, 5);
+  auto sp2 = tenno::move(sp);
+  ASSERT(!sp);
+  ASSERT_EQ(sp2.use_count(), 1);
+  sp2.reset();
+  ASSERT_EQ(sp2.use_count(), 0);
+}
+
+TEST(local_shared_ptr_self_assignment, "tenno::local_shared_ptr self assignment")
+{
+  auto sp = tenno::make_local_shared<int>(5);
+  auto &alias = sp;
+  sp = alias;
+  ASSERT_EQ(sp.use_count(), 1);
+  ASSERT_EQ(*sp, 5);
+}
+
+struct local_base
+{
+  virtual ~local_base() = default;
+  virtual int id() const
+  {
+    return 1;
+  }
+};
+
+struct local_derived : local_base
+{
+  int id() const override
+  {
+    return 2;
+  }
+};
+
+TEST(local_shared_ptr_conversion, "tenno::local_shared_ptr derived to base")
+{
+  auto derived = tenno::make_local_shared<local_derived>();
+  tenno::local_shared_ptr<local_base> base = derived;
+  ASSERT_EQ(base->id(), 2);
+  ASSERT_EQ(derived.use_count(), 2);
+  ASSERT(base.owner_equal(derived));
+}
+
+TEST(local_shared_ptr_to_shared_ptr, "tenno::local_shared_ptr escapes its thread")
+{
+  tenno::shared_ptr<int> escaped;
+  {
+    auto local = tenno::make_local_shared<int>(7);
+    escaped = local;
+    ASSERT_EQ(escaped.use_count(), 2);
+    ASSERT_EQ(local.use_count(), 1);
+  }
+  // The local pointers are gone, the object is still alive
+  ASSERT_EQ(escaped.use_count(), 1);
+  ASSERT_EQ(*escaped, 7);
+
+  int seen = 0;
+  {
+    tenno::jthread t([escaped, &seen]() { seen = *escaped; });
+  }
+  ASSERT_EQ(seen, 7);
+}
+
+TEST(local_shared_ptr_from_shared_ptr, "tenno::local_shared_ptr from shared_ptr")
+{
+  auto sp = tenno::make_shared<int>(3);
+  tenno::local_shared_ptr<int> local(sp);
+  ASSERT_EQ(sp.use_count(), 2);
+  auto copy = local;
+  ASSERT_EQ(sp.use_count(), 2);
+  local.reset();
+  copy.reset();
+  ASSERT_EQ(sp.use_count(), 1);
+}
+
+struct local_counter
+{
+  int *count;
+  explicit local_counter(int *c) : count(c)
+  {
+  }
+  ~local_counter()
+  {
+    (*count)++;
+  }
+};
+
+TEST(local_weak_ptr_lock, "tenno::local_weak_ptr lock and expired")
+{
+  int destroyed = 0;
+  tenno::local_weak_ptr<local_counter> wp;
+  ASSERT(wp.expired());
+  {
+    auto sp = tenno::make_local_shared<local_counter>(&destroyed);
+    wp = sp;
+    ASSERT(!wp.expired());
+    ASSERT_EQ(wp.use_count(), 1);
+    auto locked = wp.lock();
+    ASSERT_EQ(sp.use_count(), 2);
+    ASSERT(locked.get() == sp.get());
+  }
+  ASSERT_EQ(destroyed, 1);
+  ASSERT(wp.expired());
+  ASSERT(!wp.lock());
+
+  tenno::local_weak_ptr<local_counter> copy = wp;
+  wp.reset();
+  ASSERT(copy.expired());
+}
+
+TEST(local_shared_ptr_escape_lifetime,
+     "tenno::make_local_shared object outlives its local pointers")
+{
+  int destroyed = 0;
+  tenno::shared_ptr<local_counter> escaped;
+  tenno::local_weak_ptr<local_counter> wp;
+  {
+    auto local = tenno::make_local_shared<local_counter>(&destroyed);
+    wp = local;
+    escaped = local;
+    tenno::shared_ptr<local_counter> again = local;
+    ASSERT(again.get() == escaped.get());
+    ASSERT_EQ(escaped.use_count(), 3);
+  }
+  // The local pointers are gone, the weak one keeps the local block
+  ASSERT(wp.expired());
+  ASSERT_EQ(destroyed, 0);
+  wp.reset();
+
+  tenno::weak_ptr<local_counter> escaped_weak = escaped;
+  {
+    tenno::jthread t([moved = tenno::move(escaped)]() mutable
+                     { moved.reset(); });
+  }
+  ASSERT_EQ(destroyed, 1);
+  ASSERT(escaped_weak.expired());
+}
+
+TEST(local_shared_ptr_escape_after_local,
+     "tenno::make_local_shared object dies with its last shared_ptr")
+{
+  int destroyed = 0;
+  auto local = tenno::make_local_shared<local_counter>(&destroyed);
+  tenno::local_weak_ptr<local_counter> wp = local;
+  tenno::shared_ptr<local_counter> escaped = local;
+  escaped.reset();
+  ASSERT_EQ(destroyed, 0);
+  local.reset();
+  ASSERT_EQ(destroyed, 1);
+  ASSERT(wp.expired());
+}
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <new>
+#include <tenno/memory_resource.hpp>
+#include <valfuzz/valfuzz.hpp>
+
+TEST(memory_resource_new_delete, "tenno::pmr::new_delete_resource")
+{
+  tenno::memory_resource *r = tenno::pmr::new_delete_resource();
+  r->enable_stats();
+  auto before = r->stats();
+  void *p = r->allocate(100, 64);
+  ASSERT_EQ((tenno::size) p % 64, 0);
+  ASSERT_EQ(r->stats().allocations, before.allocations + 1);
+  r->deallocate(p, 100, 64);
+  ASSERT_EQ(r->stats().bytes_in_use, before.bytes_in_use);
+  ASSERT(*r == *tenno::pmr::new_delete_resource());
+  r->enable_stats(false);
+}
+
+TEST(memory_resource_stats_off, "tenno::memory_resource stats are opt-in")
+{
+  tenno::pmr::monotonic_buffer_resource arena;
+  ASSERT(!arena.stats_enabled());
+  arena.allocate(16, 8);
+  ASSERT_EQ(arena.stats().allocations, 0);
+  arena.enable_stats();
+  arena.allocate(16, 8);
+  ASSERT_EQ(arena.stats().allocations, 1);
+  ASSERT_EQ(arena.stats().bytes_in_use, 16);
+}
+
+TEST(memory_resource_null, "tenno::pmr::null_memory_resource")
+{
+  bool thrown = false;
+  try
+  {
+    tenno::pmr::null_memory_resource()->allocate(8);
+  }
+  catch (const std::bad_alloc &)
+  {
+    thrown = true;
+  }
+  ASSERT(thrown);
+}
+
+TEST(memory_resource_default, "tenno::pmr default resource")
+{
+  tenno::pmr::monotonic_buffer_resource arena;
+  tenno::memory_resource *old = tenno::pmr::set_default_resource(&arena);
+  ASSERT(tenno::pmr::polymorphic_allocator<int>().resource() == &arena);
+  tenno::pmr::set_default_resource(old);
+  ASSERT(tenno::pmr::get_default_resource() == old);
+}
+
+TEST(memory_resource_monotonic, "tenno::pmr::monotonic_buffer_resource")
+{
+  alignas(16) char buffer[128];
+  tenno::pmr::monotonic_buffer_resource upstream;
+  upstream.enable_stats();
+  {
+    tenno::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                                &upstream);
+    arena.enable_stats();
+    void *a = arena.allocate(64, 16);
+    ASSERT(a == buffer);
+    arena.deallocate(a, 64, 16);
+    ASSERT_EQ(upstream.stats().allocations, 0);
+
+    // Past the buffer the blocks come from the upstream
+    void *b = arena.allocate(200, 8);
+    ASSERT(b != nullptr);
+    ASSERT_EQ(upstream.stats().allocations, 1);
+    ASSERT_EQ(arena.stats().allocations, 2);
+    ASSERT_EQ(arena.stats().deallocations, 1);
+
+    arena.release();
+    ASSERT_EQ(upstream.stats().deallocations, 1);
+    ASSERT(arena.allocate(8, 8) == buffer);
+  }
+}
+
+TEST(memory_resource_monotonic_null_upstream,
+     "tenno::pmr::monotonic_buffer_resource over a null upstream")
+{
+  char buffer[64];
+  tenno::pmr::monotonic_buffer_resource arena(
+    buffer, sizeof(buffer), tenno::pmr::null_memory_resource());
+  arena.allocate(32, 1);
+  bool thrown = false;
+  try
+  {
+    arena.allocate(64, 1);
+  }
+  catch (const std::bad_alloc &)
+  {
+    thrown = true;
+  }
+  ASSERT(thrown);
+}
+
+TEST(memory_resource_pool, "tenno::pmr::unsynchronized_pool_resource")
+{
+  tenno::pmr::monotonic_buffer_resource upstream;
+  tenno::pmr::unsynchronized_pool_resource pool(&upstream);
+  upstream.enable_stats();
+  pool.enable_stats();
+  void *a = pool.allocate(24, 8);
+  void *b = pool.allocate(24, 8);
+  ASSERT(a != b);
+  ASSERT_EQ(upstream.stats().allocations, 1);
+  pool.deallocate(a, 24, 8);
+  ASSERT(pool.allocate(24, 8) == a);
+
+  // Large requests go to the upstream
+  void *big = pool.allocate(10000, 8);
+  ASSERT_EQ(upstream.stats().allocations, 2);
+  pool.deallocate(big, 10000, 8);
+
+  ASSERT_EQ(pool.stats().allocations, 4);
+  ASSERT_EQ(pool.stats().deallocations, 2);
+  pool.deallocate(b, 24, 8);
+}
+
+TEST(memory_resource_pmr_vector, "tenno::pmr::vector")
+{
+  tenno::pmr::synchronized_pool_resource pool;
+  tenno::pmr::monotonic_buffer_resource arena;
+  pool.enable_stats();
+  arena.enable_stats();
+
+  tenno::pmr::vector<int> a{tenno::pmr::polymorphic_allocator<int>(&pool)};
+  tenno::pmr::vector<int> b{tenno::pmr::polymorphic_allocator<int>(&arena)};
+  for (int i = 0; i < 100; i++)
+  {
+    a.push_back(i);
+    b.push_back(i);
+  }
+  ASSERT_EQ(a[99], 99);
+  ASSERT_EQ(b[99], 99);
+  ASSERT(pool.stats().allocations > 0);
+  ASSERT(arena.stats().allocations > 0);
+
+  // Copies keep the resource of the original
+  auto copy = b;
+  ASSERT(copy.get_allocator().resource() == &arena);
+
+  a.clear();
+  a.shrink_to_fit();
+  ASSERT_EQ(pool.stats().bytes_in_use, 0);
+}
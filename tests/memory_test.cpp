@@ -4,6 +4,7 @@
 // Github:  @San7o
 
 #include <tenno/array.hpp>
+#include <tenno/instrumented_allocator.hpp>
 #include <tenno/memory.hpp>
 #include <tenno/vector.hpp>
 #include <valfuzz/valfuzz.hpp>
@@ -31,6 +32,32 @@ TEST(make_shared_array, "tenno::make_shared T[]")
   ASSERT_EQ(sp.use_count(), 1);
 }
 
+TEST(make_shared_unbounded_array, "tenno::make_shared T[]")
+{
+  auto sp = tenno::make_shared<long[]>(64);
+  ASSERT_EQ(sp.use_count(), 1);
+  ASSERT_EQ(sp[63], 0);
+  sp[10] = 5;
+  auto copy = sp;
+  ASSERT_EQ(copy[10], 5);
+}
+
+TEST(make_shared_for_overwrite, "tenno::make_shared_for_overwrite")
+{
+  auto sp = tenno::make_shared_for_overwrite<long>();
+  *sp = 7;
+  ASSERT_EQ(*sp, 7);
+  ASSERT_EQ(sp.use_count(), 1);
+
+  auto buf = tenno::make_shared_for_overwrite<char[]>(4096);
+  buf[4095] = 'x';
+  ASSERT_EQ(buf[4095], 'x');
+
+  auto str = tenno::make_shared_for_overwrite<tenno::array<int, 4>>();
+  (*str)[0] = 1;
+  ASSERT_EQ((*str)[0], 1);
+}
+
 TEST(make_shared_tenno_array, "tenno::make_shared tenno::array")
 {
   tenno::array<int, 10> arr = {1, 2, 3, 4};
@@ -68,6 +95,51 @@ TEST(allocate_shared_args, "tenno::allocate_shared with args")
   ASSERT_EQ(*sp, 5);
 }
 
+struct make_shared_site
+{
+};
+
+TEST(allocate_shared_single_allocation,
+     "tenno::allocate_shared allocates object and control block together")
+{
+  using alloc_t = tenno::instrumented_allocator<long, make_shared_site>;
+  alloc_t::reset();
+  {
+    auto sp = tenno::allocate_shared<long>(alloc_t(), 7L);
+    ASSERT_EQ(*sp, 7);
+    ASSERT_EQ(alloc_t::snapshot().allocations, 1);
+    auto copy = sp;
+    ASSERT_EQ(alloc_t::snapshot().allocations, 1);
+  }
+  ASSERT_EQ(alloc_t::snapshot().deallocations, 1);
+  ASSERT_EQ(alloc_t::snapshot().bytes_in_use, 0);
+}
+
+struct destruction_counter
+{
+  int *count;
+  explicit destruction_counter(int *c) : count(c)
+  {
+  }
+  ~destruction_counter()
+  {
+    (*count)++;
+  }
+};
+
+TEST(make_shared_weak_outlives, "tenno::make_shared object dies before block")
+{
+  int destroyed = 0;
+  tenno::weak_ptr<destruction_counter> wp;
+  {
+    auto sp = tenno::make_shared<destruction_counter>(&destroyed);
+    wp = sp;
+    ASSERT_EQ(destroyed, 0);
+  }
+  ASSERT_EQ(destroyed, 1);
+  ASSERT(wp.expired());
+}
+
 TEST(make_unique, "tenno::make_unique")
 {
   auto up = tenno::make_unique<int>(5);
@@ -86,3 +158,50 @@ TEST(allocate_shared_array, "tenno::allocate_shared array")
     ASSERT_EQ(sp.use_count(), 1);
 }
 */
+
+struct alignas(64) cache_line_padded
+{
+  long value;
+};
+
+TEST(allocator_over_aligned, "tenno::allocator over-aligned types")
+{
+  tenno::allocator<cache_line_padded> alloc;
+  ASSERT(tenno::allocator<cache_line_padded>::is_over_aligned);
+  ASSERT(!tenno::allocator<long>::is_over_aligned);
+  for (tenno::size n = 1; n < 8; n++)
+  {
+    cache_line_padded *p = alloc.allocate(n);
+    ASSERT_EQ((tenno::size) p % 64, 0);
+    alloc.deallocate(p, n);
+  }
+
+  tenno::vector<cache_line_padded> v;
+  for (long i = 0; i < 100; i++)
+  {
+    v.push_back({i});
+    ASSERT_EQ((tenno::size) v.data().value() % 64, 0);
+  }
+  ASSERT_EQ(v[99].value, 99);
+}
+
+TEST(aligned_allocator, "tenno::aligned_allocator")
+{
+  using alloc_t = tenno::aligned_allocator<float, 64>;
+  ASSERT_EQ(alloc_t::alignment, 64);
+  ASSERT_EQ((tenno::aligned_allocator<cache_line_padded, 16>::alignment),
+            64);
+
+  tenno::vector<float, alloc_t> v;
+  for (int i = 0; i < 1000; i++)
+  {
+    v.push_back((float) i);
+    ASSERT_EQ((tenno::size) v.data().value() % 64, 0);
+  }
+  ASSERT_EQ(v[999], 999.0f);
+
+  using rebound = std::allocator_traits<alloc_t>::rebind_alloc<double>;
+  ASSERT((std::is_same_v<rebound, tenno::aligned_allocator<double, 64>>));
+  auto sp = tenno::allocate_shared<double>(alloc_t(), 4.0);
+  ASSERT_EQ(*sp, 4.0);
+}
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <tenno/mmap_allocator.hpp>
+#include <tenno/vector.hpp>
+#include <valfuzz/valfuzz.hpp>
+
+TEST(mmap_allocator_small, "tenno::mmap_allocator small allocation")
+{
+  tenno::mmap_allocator<int, 4096> alloc;
+  ASSERT(!alloc.is_mapped(16));
+  int *p = alloc.allocate(16);
+  for (int i = 0; i < 16; i++)
+  {
+    p[i] = i;
+  }
+  ASSERT_EQ(p[15], 15);
+  ASSERT(alloc.reallocate(p, 16, 32) == nullptr);
+  alloc.deallocate(p, 16);
+}
+
+TEST(mmap_allocator_reallocate, "tenno::mmap_allocator reallocate")
+{
+  tenno::mmap_allocator<int, 4096> alloc;
+  tenno::size n = 4096;
+  int *p = alloc.allocate(n);
+  for (tenno::size i = 0; i < n; i++)
+  {
+    p[i] = (int) i;
+  }
+  int *q = alloc.reallocate(p, n, n * 8);
+#if defined(__linux__)
+  ASSERT(q != nullptr);
+  for (tenno::size i = 0; i < n; i++)
+  {
+    ASSERT_EQ(q[i], (int) i);
+  }
+  q[n * 8 - 1] = 42;
+  alloc.deallocate(q, n * 8);
+#else
+  ASSERT(q == nullptr);
+  alloc.deallocate(p, n);
+#endif
+}
+
+TEST(mmap_allocator_vector, "tenno::vector with tenno::mmap_allocator")
+{
+  tenno::vector<long, tenno::mmap_allocator<long, 4096>> v;
+  for (long i = 0; i < 100000; i++)
+  {
+    v.push_back(i);
+  }
+  ASSERT_EQ(v.size(), 100000);
+  for (long i = 0; i < 100000; i++)
+  {
+    ASSERT_EQ(v[(tenno::size) i], i);
+  }
+  v.resize(10);
+  v.shrink_to_fit();
+  ASSERT_EQ(v.capacity(), 10);
+  ASSERT_EQ(v[9], 9);
+}
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <tenno/numa_allocator.hpp>
+#include <tenno/vector.hpp>
+#include <valfuzz/valfuzz.hpp>
+
+TEST(numa_node_count, "tenno::numa_node_count")
+{
+  ASSERT(tenno::numa_node_count() >= 1);
+}
+
+TEST(numa_parse_node_list, "tenno::parse_numa_node_list")
+{
+  auto nodes = tenno::parse_numa_node_list("0-3,6\n");
+  ASSERT_EQ(nodes.count, 5);
+  ASSERT_EQ(nodes.mask, 0b1001111);
+
+  nodes = tenno::parse_numa_node_list("0");
+  ASSERT_EQ(nodes.count, 1);
+  ASSERT_EQ(nodes.mask, 1);
+
+  ASSERT(tenno::numa_online_nodes().mask != 0);
+  ASSERT(&tenno::numa_online_nodes() == &tenno::numa_online_nodes());
+}
+
+TEST(numa_allocator_policy, "tenno::numa_allocator policy and equality")
+{
+  tenno::numa_allocator<int> interleave;
+  ASSERT(interleave.policy() == tenno::numa_policy::interleave);
+  ASSERT_EQ(interleave.nodemask(), tenno::numa_allocator<int>::all_nodes);
+
+  tenno::numa_allocator<int> bind(tenno::numa_policy::bind, 1);
+  ASSERT(bind.policy() == tenno::numa_policy::bind);
+  ASSERT_EQ(bind.nodemask(), 1);
+  ASSERT(bind != interleave);
+
+  tenno::numa_allocator<long> rebound(bind);
+  ASSERT(rebound.policy() == tenno::numa_policy::bind);
+  ASSERT_EQ(rebound.nodemask(), 1);
+}
+
+TEST(numa_allocator_allocate, "tenno::numa_allocator allocate")
+{
+  tenno::numa_policy policies[] = {
+    tenno::numa_policy::local, tenno::numa_policy::bind,
+    tenno::numa_policy::interleave, tenno::numa_policy::preferred};
+  for (auto policy : policies)
+  {
+    tenno::numa_allocator<int> alloc(policy, 1);
+    int *p = alloc.allocate(10000);
+    for (int i = 0; i < 10000; i++)
+    {
+      p[i] = i;
+    }
+    ASSERT_EQ(p[9999], 9999);
+    alloc.deallocate(p, 10000);
+  }
+}
+
+TEST(numa_allocator_vector, "tenno::vector with tenno::numa_allocator")
+{
+  tenno::numa_allocator<int> alloc(tenno::numa_policy::bind, 1);
+  tenno::vector<int, tenno::numa_allocator<int>> v(alloc);
+  for (int i = 0; i < 100000; i++)
+  {
+    v.push_back(i);
+  }
+  ASSERT_EQ(v.size(), 100000);
+  ASSERT_EQ(v[99999], 99999);
+  ASSERT(v.get_allocator() == alloc);
+
+  auto copy = v;
+  ASSERT(copy.get_allocator() == alloc);
+  ASSERT_EQ(copy[12345], 12345);
+}
@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <tenno/memory.hpp>
+#include <tenno/object_pool.hpp>
+#include <tenno/thread.hpp>
+#include <tenno/vector.hpp>
+#include <valfuzz/valfuzz.hpp>
+
+static int pool_message_alive = 0;
+
+struct pool_message
+{
+  long id;
+  char payload[56];
+
+  pool_message(long i) : id(i), payload{}
+  {
+    __atomic_fetch_add(&pool_message_alive, 1, __ATOMIC_RELAXED);
+  }
+
+  ~pool_message()
+  {
+    __atomic_fetch_sub(&pool_message_alive, 1, __ATOMIC_RELAXED);
+  }
+};
+
+TEST(object_pool_reuse, "tenno::object_pool reuses freed objects")
+{
+  using pool = tenno::object_pool<long>;
+  void *a = pool::allocate();
+  pool::deallocate(a);
+  void *b = pool::allocate();
+  ASSERT(a == b);
+  pool::deallocate(b);
+}
+
+TEST(object_pool_make_unique, "tenno::object_pool::make_unique")
+{
+  tenno::object_pool<pool_message> pool;
+  {
+    auto m = pool.make_unique(42);
+    ASSERT_EQ((*m).id, 42);
+    ASSERT_EQ(pool_message_alive, 1);
+    auto moved = tenno::move(m);
+    ASSERT(!m);
+    ASSERT_EQ(moved.get()->id, 42);
+  }
+  ASSERT_EQ(pool_message_alive, 0);
+}
+
+TEST(object_pool_make_shared, "tenno::object_pool::make_shared")
+{
+  tenno::object_pool<pool_message> pool;
+  {
+    auto m = pool.make_shared(7);
+    ASSERT_EQ(m->id, 7);
+    ASSERT_EQ(m.use_count(), 1);
+    {
+      auto copy = m;
+      ASSERT_EQ(m.use_count(), 2);
+    }
+    ASSERT_EQ(m.use_count(), 1);
+    ASSERT_EQ(pool_message_alive, 1);
+  }
+  ASSERT_EQ(pool_message_alive, 0);
+}
+
+TEST(object_pool_high_water, "tenno::object_pool high water and trim")
+{
+  using pool = tenno::object_pool<double>;
+  pool::set_high_water(pool::magazine_size);
+  ASSERT_EQ(pool::high_water(), pool::magazine_size);
+
+  tenno::vector<void *> objects;
+  for (tenno::size i = 0; i < 8 * pool::magazine_size; i++)
+  {
+    objects.push_back(pool::allocate());
+  }
+  for (void *p : objects)
+  {
+    pool::deallocate(p);
+  }
+  ASSERT(pool::cached() > 0);
+  ASSERT(pool::cached() <= pool::magazine_size);
+
+  pool::trim();
+  ASSERT_EQ(pool::cached(), 0);
+  pool::set_high_water(pool::default_high_water);
+}
+
+TEST(object_pool_threads, "tenno::object_pool freed from other threads")
+{
+  tenno::object_pool<pool_message> pool;
+  int failures = 0;
+  {
+    tenno::vector<tenno::jthread> threads;
+    for (int t = 0; t < 8; t++)
+    {
+      threads.emplace_back(
+        [&pool, &failures, t]()
+        {
+          for (int round = 0; round < 100; round++)
+          {
+            // Objects created here are freed by another thread
+            tenno::vector<tenno::object_pool<pool_message>::unique_ptr> made;
+            for (long i = 0; i < 100; i++)
+            {
+              made.push_back(pool.make_unique(t * 1000 + i));
+            }
+            tenno::jthread consumer(
+              [&made, &failures, t]()
+              {
+                long i = 0;
+                for (auto &m : made)
+                {
+                  if ((*m).id != t * 1000 + i++)
+                  {
+                    __atomic_fetch_add(&failures, 1, __ATOMIC_RELAXED);
+                  }
+                  m.reset();
+                }
+              });
+          }
+          auto shared = pool.make_shared(t);
+          if (shared->id != t)
+          {
+            __atomic_fetch_add(&failures, 1, __ATOMIC_RELAXED);
+          }
+        });
+    }
+  }
+  ASSERT_EQ(failures, 0);
+  ASSERT_EQ(pool_message_alive, 0);
+}
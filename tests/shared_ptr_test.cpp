@@ -5,7 +5,10 @@
 
 #include <tenno/array.hpp>
 #include <tenno/memory.hpp>
+#include <tenno/thread.hpp>
 #include <tenno/utility.hpp>
+#include <tenno/vector.hpp>
+#include <type_traits>
 #include <valfuzz/valfuzz.hpp>
 
 TEST(shared_ptr_constructor, "constructor tenno::shared_ptr")
@@ -139,3 +142,116 @@ TEST(shared_ptr_copy_constructor2, "tenno::shared_ptr::shared_ptr copy2")
   b(sp1);
   ASSERT_EQ(sp1.use_count(), 1);
 }
+
+TEST(shared_ptr_self_assignment, "tenno::shared_ptr self assignment")
+{
+  auto sp = tenno::shared_ptr<int>(new int(10));
+  auto &alias = sp;
+  sp = alias;
+  ASSERT_EQ(sp.use_count(), 1);
+  ASSERT_EQ(*sp, 10);
+}
+
+TEST(shared_ptr_concurrent_copies, "tenno::shared_ptr copies from many threads")
+{
+  auto sp = tenno::shared_ptr<int>(new int(42));
+  int failures = 0;
+  {
+    tenno::vector<tenno::jthread> threads;
+    for (int t = 0; t < 8; t++)
+    {
+      threads.emplace_back(
+        [&sp, &failures]()
+        {
+          for (int i = 0; i < 10000; i++)
+          {
+            tenno::shared_ptr<int> copy = sp;
+            tenno::weak_ptr<int> weak(copy);
+            if (*weak.lock() != 42)
+            {
+              __atomic_fetch_add(&failures, 1, __ATOMIC_RELAXED);
+            }
+          }
+        });
+    }
+  }
+  ASSERT_EQ(failures, 0);
+  ASSERT_EQ(sp.use_count(), 1);
+}
+
+TEST(shared_ptr_layout, "tenno::shared_ptr is two pointers, no vtable")
+{
+  ASSERT(!std::is_polymorphic_v<tenno::control_block_base>);
+  ASSERT_EQ(sizeof(tenno::shared_ptr<int>), 2 * sizeof(void *));
+  ASSERT_EQ(sizeof(tenno::weak_ptr<int>), 2 * sizeof(void *));
+}
+
+TEST(shared_ptr_swap_ptr, "tenno::shared_ptr::swap_ptr")
+{
+  auto a = tenno::shared_ptr<int>(new int(1));
+  auto b = tenno::shared_ptr<int>(new int(2));
+  a.swap_ptr(b);
+  ASSERT_EQ(*a, 2);
+  ASSERT_EQ(*b, 1);
+  ASSERT_EQ(a.use_count(), 1);
+  ASSERT_EQ(b.use_count(), 1);
+
+  // Swap the objects back through weak pointers
+  tenno::weak_ptr<int> wa(a);
+  tenno::weak_ptr<int> wb(b);
+  ASSERT(wa.swap_ptr(wb));
+  ASSERT_EQ(*wa.lock(), 1);
+  ASSERT_EQ(*wb.lock(), 2);
+}
+
+TEST(shared_ptr_swap_ptr_allocate_shared,
+     "tenno::shared_ptr::swap_ptr allocate_shared and weak_ptr")
+{
+  auto a = tenno::allocate_shared<int>(tenno::allocator<int>(), 1);
+  auto b = tenno::allocate_shared<int>(tenno::allocator<int>(), 2);
+  tenno::weak_ptr<int> wa(a);
+  tenno::weak_ptr<int> wb(b);
+  ASSERT(!wa.swap_ptr(wb));
+  ASSERT(!wa.swap_ptr(b));
+  ASSERT_EQ(*a, 1);
+  ASSERT_EQ(*b, 2);
+  b.reset();
+  ASSERT_EQ(*a, 1);
+  ASSERT(wb.expired());
+}
+
+TEST(shared_ptr_swap_ptr_make_shared,
+     "tenno::shared_ptr::swap_ptr make_shared objects stay in place")
+{
+  auto a = tenno::make_shared<int>(1);
+  auto b = tenno::make_shared<int>(2);
+  ASSERT(!a.swap_ptr(b));
+  ASSERT_EQ(*a, 1);
+  ASSERT_EQ(*b, 2);
+  b.reset();
+  ASSERT_EQ(*a, 1);
+
+  // A block that owns its object through a pointer can not take an
+  // object stored inside another block either
+  auto c = tenno::shared_ptr<int>(new int(3));
+  ASSERT(!c.swap_ptr(a));
+  ASSERT(!a.swap_ptr(c));
+  ASSERT_EQ(*c, 3);
+  ASSERT_EQ(*a, 1);
+}
+
+static_assert(sizeof(tenno::shared_ptr<int>::control_block)
+                == sizeof(tenno::control_block_base),
+              "a stateless deleter and allocator must take no space");
+static_assert(sizeof(tenno::inplace_control_block<long, tenno::allocator<long>>)
+                == sizeof(tenno::control_block_base) + sizeof(long),
+              "a stateless allocator must take no space");
+
+TEST(shared_ptr_control_block_size, "tenno::shared_ptr control block size")
+{
+  using stateful = void (*)(int *);
+  ASSERT_EQ(sizeof(tenno::shared_ptr<int>::control_block),
+            sizeof(tenno::control_block_base));
+  ASSERT_EQ(sizeof(tenno::shared_ptr<int, stateful>::control_block),
+            sizeof(tenno::control_block_base) + sizeof(stateful));
+}
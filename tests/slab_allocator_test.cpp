@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <tenno/memory.hpp>
+#include <tenno/slab_allocator.hpp>
+#include <tenno/thread.hpp>
+#include <tenno/vector.hpp>
+#include <valfuzz/valfuzz.hpp>
+
+TEST(slab_allocator_reuse, "tenno::slab_allocator reuses freed blocks")
+{
+  tenno::slab_allocator<long> alloc;
+  long *a = alloc.allocate(1);
+  long *b = alloc.allocate(1);
+  ASSERT(a != b);
+  *a = 1;
+  *b = 2;
+  ASSERT_EQ(*a, 1);
+  alloc.deallocate(b, 1);
+  long *c = alloc.allocate(1);
+  ASSERT(c == b);
+  alloc.deallocate(a, 1);
+  alloc.deallocate(c, 1);
+}
+
+TEST(slab_allocator_array, "tenno::slab_allocator many objects at once")
+{
+  tenno::slab_allocator<int> alloc;
+  int *p = alloc.allocate(100);
+  for (int i = 0; i < 100; i++)
+  {
+    p[i] = i;
+  }
+  ASSERT_EQ(p[99], 99);
+  alloc.deallocate(p, 100);
+}
+
+struct alignas(64) slab_aligned
+{
+  char data[64];
+};
+
+TEST(slab_allocator_alignment, "tenno::slab_allocator alignment")
+{
+  tenno::slab_allocator<slab_aligned> alloc;
+  tenno::vector<slab_aligned *> blocks;
+  for (int i = 0; i < 100; i++)
+  {
+    blocks.push_back(alloc.allocate(1));
+  }
+  for (slab_aligned *p : blocks)
+  {
+    ASSERT_EQ((tenno::size) p % 64, 0);
+    alloc.deallocate(p, 1);
+  }
+}
+
+TEST(slab_allocator_shared_ptr, "tenno::shared_ptr with tenno::slab_allocator")
+{
+  using alloc_t = tenno::slab_allocator<int>;
+  tenno::shared_ptr<int, tenno::default_delete<int>, alloc_t> sp(
+    new int(5), tenno::default_delete<int>(), alloc_t());
+  auto copy = sp;
+  ASSERT_EQ(*copy, 5);
+  ASSERT_EQ(sp.use_count(), 2);
+
+  auto made = tenno::allocate_shared<int>(alloc_t(), 7);
+  tenno::weak_ptr<int> weak(made);
+  ASSERT_EQ(*made, 7);
+  made.reset();
+  ASSERT(weak.expired());
+}
+
+TEST(slab_allocator_threads, "tenno::slab_allocator from many threads")
+{
+  // Blocks are allocated on one thread and freed on another
+  const int per_thread = 5000;
+  tenno::vector<tenno::shared_ptr<long>> shared;
+  for (int i = 0; i < 4 * per_thread; i++)
+  {
+    shared.push_back(
+      tenno::allocate_shared<long>(tenno::slab_allocator<long>(), i));
+  }
+
+  long failures = 0;
+  {
+    tenno::vector<tenno::jthread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+      threads.emplace_back(
+        [&shared, &failures, t]()
+        {
+          for (int i = t * per_thread; i < (t + 1) * per_thread; i++)
+          {
+            auto sp = tenno::move(shared[(tenno::size) i]);
+            if (*sp != i)
+            {
+              __atomic_fetch_add(&failures, 1, __ATOMIC_RELAXED);
+            }
+            auto fresh =
+              tenno::allocate_shared<long>(tenno::slab_allocator<long>(), i);
+            if (*fresh != i)
+            {
+              __atomic_fetch_add(&failures, 1, __ATOMIC_RELAXED);
+            }
+          }
+        });
+    }
+  }
+  ASSERT_EQ(failures, 0);
+}
@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <string>
+#include <tenno/small_vector.hpp>
+#include <valfuzz/valfuzz.hpp>
+
+TEST(small_vector_empty_constructor, "small_vector empty constructor")
+{
+  tenno::small_vector<int, 4> v;
+  ASSERT_EQ(v.size(), 0);
+  ASSERT_EQ(v.capacity(), 4);
+  ASSERT(v.is_inline());
+}
+
+TEST(small_vector_constructor_count_value,
+     "small_vector constructor with count and value")
+{
+  tenno::small_vector<int, 4> v(3, 10);
+  ASSERT_EQ(v.size(), 3);
+  ASSERT(v.is_inline());
+  for (tenno::size i = 0; i < 3; i++)
+  {
+    ASSERT_EQ(v[i], 10);
+  }
+
+  tenno::small_vector<int, 4> v2(8, 10);
+  ASSERT_EQ(v2.size(), 8);
+  ASSERT(!v2.is_inline());
+  for (tenno::size i = 0; i < 8; i++)
+  {
+    ASSERT_EQ(v2[i], 10);
+  }
+}
+
+TEST(small_vector_initializer_list,
+     "small_vector constructor with initializer list")
+{
+  tenno::small_vector<int, 8> v = {1, 2, 3, 4, 5};
+  ASSERT_EQ(v.size(), 5);
+  ASSERT(v.is_inline());
+  for (tenno::size i = 0; i < 5; i++)
+  {
+    ASSERT_EQ(v[i], (int) i + 1);
+  }
+}
+
+TEST(small_vector_push_back_spill, "small_vector push_back spills to heap")
+{
+  tenno::small_vector<int, 4> v;
+  for (int i = 0; i < 4; i++)
+  {
+    v.push_back(i);
+  }
+  ASSERT(v.is_inline());
+  v.push_back(4);
+  ASSERT(!v.is_inline());
+  ASSERT_EQ(v.size(), 5);
+  ASSERT_EQ(v.capacity(), 8);
+  for (tenno::size i = 0; i < 5; i++)
+  {
+    ASSERT_EQ(v[i], (int) i);
+  }
+}
+
+TEST(small_vector_shrink_to_fit, "small_vector shrink_to_fit back to inline")
+{
+  tenno::small_vector<std::string, 2> v;
+  v.push_back("a string long enough to need heap storage of its own");
+  v.push_back("b");
+  v.push_back("c");
+  ASSERT(!v.is_inline());
+  v.pop_back();
+  v.shrink_to_fit();
+  ASSERT(v.is_inline());
+  ASSERT_EQ(v.capacity(), 2);
+  ASSERT_EQ(v[0], "a string long enough to need heap storage of its own");
+  ASSERT_EQ(v[1], "b");
+}
+
+TEST(small_vector_copy, "small_vector copy")
+{
+  tenno::small_vector<std::string, 2> v1 = {"a", "b", "c"};
+  tenno::small_vector<std::string, 2> v2(v1);
+  ASSERT_EQ(v2.size(), 3);
+  ASSERT_EQ(v2[2], "c");
+  tenno::small_vector<std::string, 2> v3;
+  v3 = v1;
+  ASSERT_EQ(v3.size(), 3);
+  ASSERT_EQ(v3[0], "a");
+}
+
+TEST(small_vector_move, "small_vector move")
+{
+  tenno::small_vector<std::string, 2> inline_v = {"a", "b"};
+  tenno::small_vector<std::string, 2> moved_inline(tenno::move(inline_v));
+  ASSERT_EQ(moved_inline.size(), 2);
+  ASSERT_EQ(moved_inline[1], "b");
+  ASSERT_EQ(inline_v.size(), 0);
+
+  tenno::small_vector<std::string, 2> heap_v = {"a", "b", "c"};
+  std::string *heap_data = heap_v.data().value();
+  tenno::small_vector<std::string, 2> moved_heap;
+  moved_heap = tenno::move(heap_v);
+  ASSERT_EQ(moved_heap.size(), 3);
+  ASSERT(moved_heap.data().value() == heap_data);
+  ASSERT(heap_v.is_inline());
+  ASSERT_EQ(heap_v.size(), 0);
+}
+
+TEST(small_vector_swap, "small_vector swap")
+{
+  tenno::small_vector<int, 2> v1 = {1, 2};
+  tenno::small_vector<int, 2> v2 = {3, 4, 5};
+  v1.swap(v2);
+  ASSERT_EQ(v1.size(), 3);
+  ASSERT_EQ(v1[2], 5);
+  ASSERT_EQ(v2.size(), 2);
+  ASSERT_EQ(v2[0], 1);
+}
+
+TEST(small_vector_at, "small_vector at")
+{
+  tenno::small_vector<int, 4> v = {1, 2, 3};
+  ASSERT_EQ(v.at(0).value(), 1);
+  ASSERT_EQ(v.at(3).has_value(), false);
+  ASSERT_EQ(v.at(3).error(), tenno::error::out_of_range);
+  v.at(1).value().get() = 20;
+  ASSERT_EQ(v[1], 20);
+}
+
+TEST(small_vector_front_back, "small_vector front and back")
+{
+  tenno::small_vector<int, 4> v;
+  ASSERT_EQ(v.front().error(), tenno::error::empty);
+  ASSERT_EQ(v.back().error(), tenno::error::empty);
+  v = {1, 2, 3};
+  ASSERT_EQ(v.front().value(), 1);
+  ASSERT_EQ(v.back().value(), 3);
+}
+
+TEST(small_vector_iterator, "small_vector iterator")
+{
+  tenno::small_vector<int, 4> v = {1, 2, 3, 4, 5};
+  int i = 0;
+  for (auto it = v.begin(); it != v.end(); it++)
+  {
+    ASSERT_EQ(*it, ++i);
+  }
+  ASSERT_EQ(i, 5);
+  for (auto it = v.rbegin(); it != v.rend(); it++)
+  {
+    ASSERT_EQ(*it, i--);
+  }
+  ASSERT_EQ(i, 0);
+}
+
+TEST(small_vector_resize, "small_vector resize")
+{
+  tenno::small_vector<int, 4> v = {1, 2, 3};
+  v.resize(6, 7);
+  ASSERT_EQ(v.size(), 6);
+  ASSERT_EQ(v[5], 7);
+  v.resize(2);
+  ASSERT_EQ(v.size(), 2);
+  ASSERT_EQ(v[1], 2);
+}
+
+struct ThrowingMove
+{
+  ThrowingMove() = default;
+  ThrowingMove(const ThrowingMove &) = default;
+  ThrowingMove(ThrowingMove &&) noexcept(false) {}
+};
+
+TEST(small_vector_noexcept_move, "small_vector noexcept move")
+{
+  using ints = tenno::small_vector<int, 4>;
+  using strings = tenno::small_vector<std::string, 4>;
+  using throwing = tenno::small_vector<ThrowingMove, 4>;
+  ASSERT(std::is_nothrow_move_constructible_v<ints>);
+  ASSERT(std::is_nothrow_move_assignable_v<strings>);
+  ASSERT(!std::is_nothrow_move_constructible_v<throwing>);
+  ASSERT(!std::is_nothrow_move_assignable_v<throwing>);
+  ASSERT(!noexcept(std::declval<throwing &>().swap(
+    std::declval<throwing &>())));
+}
+
+TEST(small_vector_growth_policy, "small_vector growth policy")
+{
+  tenno::small_vector<int, 2, tenno::allocator<int>, tenno::growth_fixed<8>>
+    v = {1, 2};
+  v.push_back(3);
+  ASSERT_EQ(v.capacity(), 10);
+  for (int i = 4; i <= 11; i++)
+  {
+    v.push_back(i);
+  }
+  ASSERT_EQ(v.capacity(), 18);
+  ASSERT_EQ(v[10], 11);
+}
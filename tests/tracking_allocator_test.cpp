@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: MIT
+// Author:  Giovanni Santini
+// Mail:    giovanni.santini@proton.me
+// Github:  @San7o
+
+#include <cstdio>
+#include <cstring>
+#include <tenno/memory.hpp>
+#include <tenno/thread.hpp>
+#include <tenno/tracking_allocator.hpp>
+#include <tenno/vector.hpp>
+#include <valfuzz/valfuzz.hpp>
+
+TEST(tracking_allocator_counts, "tenno::tracking_allocator counters")
+{
+  tenno::allocation_tracker tracker("counts");
+  tenno::tracking_allocator<long> alloc(tracker);
+  long *a = alloc.allocate(1);
+  long *b = alloc.allocate(100);
+  // The snapshot catches the peak below peak_granularity
+  ASSERT_EQ(tracker.snapshot().stats.peak_bytes_in_use, 101 * sizeof(long));
+  alloc.deallocate(a, 1);
+
+  auto p = tracker.snapshot();
+  ASSERT_EQ(p.stats.allocations, 2);
+  ASSERT_EQ(p.stats.deallocations, 1);
+  ASSERT_EQ(p.stats.bytes_allocated, 101 * sizeof(long));
+  ASSERT_EQ(p.stats.bytes_in_use, 100 * sizeof(long));
+  ASSERT_EQ(p.stats.peak_bytes_in_use, 101 * sizeof(long));
+  ASSERT_EQ(p.histogram[tenno::heap_profile::size_class(8)], 1);
+  ASSERT_EQ(p.histogram[tenno::heap_profile::size_class(800)], 1);
+  ASSERT_EQ(tenno::heap_profile::size_class(800), 10);
+
+  alloc.deallocate(b, 100);
+  ASSERT_EQ(tracker.snapshot().stats.bytes_in_use, 0);
+  tracker.reset();
+  ASSERT_EQ(tracker.snapshot().stats.allocations, 0);
+}
+
+TEST(tracking_allocator_vector, "tenno::vector with tracking_allocator")
+{
+  tenno::allocation_tracker tracker("vector");
+  {
+    tenno::vector<int, tenno::tracking_allocator<int>> v(
+      (tenno::tracking_allocator<int>(tracker)));
+    for (int i = 0; i < 1000; i++)
+    {
+      v.push_back(i);
+    }
+    ASSERT(&v.get_allocator().tracker() == &tracker);
+  }
+  auto p = tracker.snapshot();
+  ASSERT(p.stats.allocations > 1);
+  ASSERT_EQ(p.stats.allocations, p.stats.deallocations);
+  ASSERT(p.stats.reallocations > 0);
+  ASSERT(p.stats.peak_capacity >= 1000);
+  ASSERT(p.stats.peak_size >= 512);
+  ASSERT_EQ(p.stats.bytes_in_use, 0);
+}
+
+struct tracked_node
+{
+  long key;
+  long value;
+
+  tracked_node(long k, long v) : key(k), value(v)
+  {
+  }
+};
+
+TEST(tracking_allocator_pointers, "tenno::tracking_allocator smart pointers")
+{
+  tenno::allocation_tracker tracker("pointers");
+  tenno::tracking_allocator<tracked_node> alloc(tracker);
+  {
+    auto sp = tenno::allocate_shared<tracked_node>(alloc, 1, 2);
+    auto up = tenno::allocate_unique<tracked_node>(alloc, 3, 4);
+    ASSERT_EQ(sp->value, 2);
+    ASSERT_EQ(up->value, 4);
+    ASSERT_EQ(tracker.snapshot().stats.allocations, 2);
+  }
+  auto p = tracker.snapshot();
+  ASSERT_EQ(p.stats.deallocations, 2);
+  ASSERT_EQ(p.stats.bytes_in_use, 0);
+
+  // A stateless allocator keeps the pointer small
+  auto up = tenno::allocate_unique<long>(tenno::allocator<long>(), 42);
+  ASSERT_EQ(*up, 42);
+  ASSERT_EQ(sizeof(up), sizeof(long *));
+}
+
+TEST(tracking_allocator_threads, "tenno::tracking_allocator from many threads")
+{
+  tenno::allocation_tracker tracker("threads");
+  {
+    tenno::vector<tenno::jthread> threads;
+    for (int t = 0; t < 8; t++)
+    {
+      threads.emplace_back(
+        [&tracker]()
+        {
+          tenno::tracking_allocator<long> alloc(tracker);
+          for (int i = 0; i < 1000; i++)
+          {
+            long *p = alloc.allocate(4);
+            alloc.deallocate(p, 4);
+          }
+        });
+    }
+  }
+  auto p = tracker.snapshot();
+  ASSERT_EQ(p.stats.allocations, 8000);
+  ASSERT_EQ(p.stats.deallocations, 8000);
+  ASSERT_EQ(p.stats.bytes_allocated, 8000 * 4 * sizeof(long));
+  ASSERT_EQ(p.stats.bytes_in_use, 0);
+  ASSERT(p.stats.peak_bytes_in_use >= 4 * sizeof(long));
+}
+
+TEST(tracking_allocator_peak, "tenno::allocation_tracker peak")
+{
+  tenno::allocation_tracker tracker("peak");
+  tenno::tracking_allocator<char> alloc(tracker);
+  constexpr tenno::size granularity =
+    tenno::allocation_tracker::peak_granularity;
+  tenno::size big = 4 * granularity;
+  char *p = alloc.allocate(big);
+  alloc.deallocate(p, big);
+  auto profile = tracker.snapshot();
+  ASSERT(profile.stats.peak_bytes_in_use + granularity > big);
+  ASSERT_EQ(profile.stats.bytes_in_use, 0);
+}
+
+TEST(tracking_allocator_dump, "tenno::allocation_tracker::dump_all")
+{
+  tenno::allocation_tracker tracker("dump-subsystem");
+  tenno::tracking_allocator<char> alloc(tracker);
+  char *p = alloc.allocate(3000);
+
+  FILE *out = std::tmpfile();
+  tenno::allocation_tracker::dump_all(out);
+  std::rewind(out);
+  char line[256];
+  bool found_name = false;
+  bool found_class = false;
+  while (std::fgets(line, sizeof(line), out) != nullptr)
+  {
+    found_name |= std::strstr(line, "dump-subsystem: 1 allocations") != nullptr;
+    found_class |= std::strstr(line, "4096 bytes: 1") != nullptr;
+  }
+  std::fclose(out);
+  alloc.deallocate(p, 3000);
+  ASSERT(found_name);
+  ASSERT(found_class);
+}
@@ -80,3 +80,108 @@ TEST(unique_ptr_move_assignment, "tenno::unique_ptr move assign")
   ASSERT(ptr1.get() == nullptr);
   ASSERT(ptr2.get() != nullptr);
 }
+
+static_assert(sizeof(tenno::unique_ptr<int>) == sizeof(int *),
+              "default_delete must take no space");
+static_assert(sizeof(tenno::unique_ptr<int, void (*)(int *)>)
+                == 2 * sizeof(void *),
+              "a function pointer deleter is stored");
+
+TEST(unique_ptr_layout, "tenno::unique_ptr is pointer-sized")
+{
+  ASSERT_EQ(sizeof(tenno::unique_ptr<int>), sizeof(int *));
+  auto deleter = [](int *p) { delete p; };
+  ASSERT_EQ(sizeof(tenno::unique_ptr<int, decltype(deleter)>),
+            sizeof(int *));
+}
+
+TEST(unique_ptr_arrow, "tenno::unique_ptr::operator->")
+{
+  struct point
+  {
+    int x;
+    int y;
+  };
+  auto ptr = tenno::unique_ptr<point>(new point{1, 2});
+  ptr->x = 3;
+  ASSERT_EQ(ptr->x, 3);
+  ASSERT_EQ(ptr->y, 2);
+}
+
+TEST(unique_ptr_swap_pointers, "tenno::unique_ptr::swap exchanges pointers")
+{
+  int *p1 = new int(1);
+  int *p2 = new int(2);
+  auto ptr1 = tenno::unique_ptr<int>(p1);
+  auto ptr2 = tenno::unique_ptr<int>(p2);
+  ptr1.swap(ptr2);
+  ASSERT(ptr1.get() == p2);
+  ASSERT(ptr2.get() == p1);
+}
+
+static_assert(sizeof(tenno::unique_ptr<int[]>) == sizeof(int *),
+              "default_delete<T[]> must take no space");
+
+TEST(unique_ptr_array, "tenno::unique_ptr<T[]>")
+{
+  auto ptr = tenno::unique_ptr<int[]>(new int[4]{1, 2, 3, 4});
+  ASSERT_EQ(ptr[0], 1);
+  ptr[3] = 5;
+  ASSERT_EQ(ptr.get()[3], 5);
+  ptr.reset(new int[2]{6, 7});
+  ASSERT_EQ(ptr[1], 7);
+  auto other = tenno::move(ptr);
+  ASSERT(!ptr);
+  ASSERT_EQ(other[0], 6);
+}
+
+struct counted
+{
+  static inline int destroyed = 0;
+  int               value     = 3;
+
+  ~counted()
+  {
+    destroyed++;
+  }
+};
+
+TEST(make_unique_array, "tenno::make_unique<T[]>")
+{
+  auto zeros = tenno::make_unique<long[]>(100);
+  bool all_zero = true;
+  for (tenno::size i = 0; i < 100; i++)
+  {
+    all_zero &= zeros[i] == 0;
+  }
+  ASSERT(all_zero);
+
+  counted::destroyed = 0;
+  {
+    auto objects = tenno::make_unique<counted[]>(10);
+    ASSERT_EQ(objects[9].value, 3);
+  }
+  ASSERT_EQ(counted::destroyed, 10);
+}
+
+TEST(make_unique_for_overwrite, "tenno::make_unique_for_overwrite")
+{
+  auto value = tenno::make_unique_for_overwrite<long>();
+  *value = 42;
+  ASSERT_EQ(*value, 42);
+
+  auto buffer = tenno::make_unique_for_overwrite<char[]>(1 << 20);
+  for (tenno::size i = 0; i < (1 << 20); i++)
+  {
+    buffer[i] = (char) i;
+  }
+  ASSERT_EQ(buffer[257], 1);
+
+  // Class types are still constructed
+  counted::destroyed = 0;
+  {
+    auto objects = tenno::make_unique_for_overwrite<counted[]>(4);
+    ASSERT_EQ(objects[3].value, 3);
+  }
+  ASSERT_EQ(counted::destroyed, 4);
+}
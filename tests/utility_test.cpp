@@ -21,3 +21,40 @@ TEST(move_constexpr, "constexpr tenno::move")
   static_assert(i == 5);
   static_assert(j == 5);
 }
+
+struct empty_a
+{
+};
+
+struct empty_b
+{
+};
+
+static_assert(sizeof(tenno::compressed_pair<int *, empty_a>) == sizeof(int *));
+static_assert(sizeof(tenno::compressed_pair<empty_a, int *>) == sizeof(int *));
+static_assert(sizeof(tenno::compressed_pair<empty_a, empty_b>) == 1);
+static_assert(sizeof(tenno::compressed_pair<long, long>) == 2 * sizeof(long));
+
+TEST(compressed_pair, "tenno::compressed_pair")
+{
+  tenno::compressed_pair<int, empty_a> p(42, empty_a());
+  ASSERT_EQ(p.first(), 42);
+  p.first() = 43;
+  const auto &cp = p;
+  ASSERT_EQ(cp.first(), 43);
+
+  tenno::compressed_pair<int, long> a(1, 2L);
+  tenno::compressed_pair<int, long> b(3, 4L);
+  a.swap(b);
+  ASSERT_EQ(a.first(), 3);
+  ASSERT_EQ(a.second(), 4L);
+  ASSERT_EQ(b.first(), 1);
+  ASSERT_EQ(b.second(), 2L);
+}
+
+TEST(compressed_pair_same_empty,
+     "tenno::compressed_pair of the same empty type")
+{
+  tenno::compressed_pair<empty_a, empty_a> p;
+  ASSERT((void *) &p.first() != (void *) &p.second());
+}
@@ -3,6 +3,10 @@
 // Mail:    giovanni.santini@proton.me
 // Github:  @San7o
 
+#include <algorithm>
+#include <sstream>
+#include <tenno/algorithm.hpp>
+#include <tenno/array.hpp>
 #include <tenno/ranges.hpp>
 #include <tenno/vector.hpp>
 #include <valfuzz/valfuzz.hpp>
@@ -346,6 +350,73 @@ TEST(vector_reverse_iterator, "vector reverse iterator")
   ASSERT_EQ(i, 0);
 }
 
+TEST(vector_iterator_contiguous, "vector iterator models contiguous_iterator")
+{
+  using vec = tenno::vector<int>;
+  static_assert(std::contiguous_iterator<vec::iterator>);
+  static_assert(std::contiguous_iterator<vec::const_iterator>);
+  static_assert(std::random_access_iterator<vec::reverse_iterator>);
+  static_assert(sizeof(vec::iterator) == sizeof(int *));
+
+  vec v = {1, 2, 3, 4, 5};
+  auto it = v.begin();
+  ASSERT_EQ(v.end() - it, 5);
+  ASSERT_EQ(*(it + 2), 3);
+  ASSERT_EQ(it[4], 5);
+  it += 3;
+  ASSERT_EQ(*it, 4);
+  --it;
+  ASSERT_EQ(*it, 3);
+  ASSERT(v.begin() < it);
+  ASSERT(std::to_address(v.begin()) == v.data().value());
+  vec::const_iterator cit = it;
+  ASSERT(cit == it);
+}
+
+TEST(vector_iterator_std_sort, "vector iterator with std::sort")
+{
+  tenno::vector<int> v = {5, 3, 1, 4, 2};
+  std::sort(v.begin(), v.end());
+  for (tenno::size i = 0; i < 5; i++)
+  {
+    ASSERT_EQ(v[i], (int) i + 1);
+  }
+}
+
+TEST(vector_iterator_copy, "vector iterator with tenno::copy")
+{
+  tenno::vector<int> src = {1, 2, 3, 4, 5};
+  tenno::vector<int> dst(5, 0);
+  auto end = tenno::copy(src.cbegin(), src.cend(), dst.begin());
+  ASSERT(end == dst.end());
+  for (tenno::size i = 0; i < 5; i++)
+  {
+    ASSERT_EQ(dst[i], (int) i + 1);
+  }
+
+  tenno::vector<std::string> ssrc = {"a", "b"};
+  tenno::vector<std::string> sdst(2);
+  tenno::copy(ssrc.begin(), ssrc.end(), sdst.begin());
+  ASSERT_EQ(sdst[1], "b");
+}
+
+TEST(vector_range_for, "vector range for")
+{
+  tenno::vector<int> v = {1, 2, 3};
+  int sum = 0;
+  for (int &x : v)
+  {
+    sum += x;
+  }
+  ASSERT_EQ(sum, 6);
+  const tenno::vector<int> &cv = v;
+  for (auto it = cv.rbegin(); it != cv.rend(); ++it)
+  {
+    sum -= *it;
+  }
+  ASSERT_EQ(sum, 0);
+}
+
 TEST(vector_empty, "vector empty")
 {
   tenno::vector<int> v;
@@ -625,3 +696,466 @@ TEST(vector_lifecycle_test3, "vector pop_back destructor")
   ASSERT_EQ(v.size(), 1);
   ASSERT_EQ(LifecycleSpy::destructions, before_pop + 1);
 }
+
+struct RelocatableSpy
+{
+  static int moves;
+
+  int *value;
+
+  RelocatableSpy(int v = 0) : value(new int(v)) {}
+  RelocatableSpy(const RelocatableSpy &other) : value(new int(*other.value)) {}
+  RelocatableSpy(RelocatableSpy &&other) : value(other.value)
+  {
+    other.value = nullptr;
+    moves++;
+  }
+  ~RelocatableSpy()
+  {
+    delete value;
+  }
+};
+
+int RelocatableSpy::moves = 0;
+
+template <> struct tenno::is_trivially_relocatable<RelocatableSpy>
+    : std::true_type
+{
+};
+
+TEST(vector_trivially_relocatable_trait, "vector trivially relocatable trait")
+{
+  struct pod
+  {
+    int a;
+    float b;
+  };
+  ASSERT(tenno::is_trivially_relocatable_v<int>);
+  ASSERT(tenno::is_trivially_relocatable_v<pod>);
+  ASSERT(!tenno::is_trivially_relocatable_v<std::string>);
+  ASSERT(!tenno::is_trivially_relocatable_v<LifecycleSpy>);
+  ASSERT(tenno::is_trivially_relocatable_v<RelocatableSpy>);
+}
+
+TEST(vector_relocate_reserve, "vector reserve relocates opt-in types")
+{
+  RelocatableSpy::moves = 0;
+  tenno::vector<RelocatableSpy> v;
+  v.reserve(2);
+  v.emplace_back(1);
+  v.emplace_back(2);
+  v.reserve(64);
+  v.emplace_back(3);
+  v.shrink_to_fit();
+  ASSERT_EQ(RelocatableSpy::moves, 0);
+  ASSERT_EQ(v.capacity(), 3);
+  for (int i = 0; i < 3; i++)
+  {
+    ASSERT_EQ(*v[(tenno::size) i].value, i + 1);
+  }
+}
+
+TEST(vector_relocate_push_back_growth, "vector push_back growth relocation")
+{
+  tenno::vector<long> v;
+  for (long i = 0; i < 1000; i++)
+  {
+    v.push_back(i);
+  }
+  ASSERT_EQ(v.size(), 1000);
+  for (long i = 0; i < 1000; i++)
+  {
+    ASSERT_EQ(v[(tenno::size) i], i);
+  }
+}
+
+TEST(vector_growth_factor_2, "vector growth policy factor 2")
+{
+  tenno::vector<int, tenno::allocator<int>, tenno::growth_factor_2> v;
+  v.push_back(1);
+  ASSERT_EQ(v.capacity(), 1);
+  v.push_back(2);
+  ASSERT_EQ(v.capacity(), 2);
+  v.push_back(3);
+  ASSERT_EQ(v.capacity(), 4);
+}
+
+TEST(vector_growth_factor_1_5, "vector growth policy factor 1.5")
+{
+  tenno::vector<int, tenno::allocator<int>, tenno::growth_factor_1_5> v;
+  v.reserve(10);
+  for (int i = 0; i < 11; i++)
+  {
+    v.push_back(i);
+  }
+  ASSERT_EQ(v.capacity(), 15);
+  for (int i = 0; i < 11; i++)
+  {
+    ASSERT_EQ(v[(tenno::size) i], i);
+  }
+}
+
+TEST(vector_growth_page_rounded, "vector growth policy page rounded")
+{
+  tenno::vector<int, tenno::allocator<int>, tenno::growth_page_rounded<4096>>
+    v;
+  v.push_back(1);
+  ASSERT_EQ(v.capacity(), 4096 / sizeof(int));
+  for (int i = 0; i < 1024; i++)
+  {
+    v.push_back(i);
+  }
+  ASSERT_EQ((v.capacity() * sizeof(int)) % 4096, 0);
+}
+
+TEST(vector_growth_fixed, "vector growth policy fixed increment")
+{
+  tenno::vector<int, tenno::allocator<int>, tenno::growth_fixed<8>> v;
+  v.push_back(1);
+  ASSERT_EQ(v.capacity(), 8);
+  for (int i = 0; i < 8; i++)
+  {
+    v.push_back(i);
+  }
+  ASSERT_EQ(v.capacity(), 16);
+}
+
+TEST(vector_append_range, "vector append_range")
+{
+  tenno::vector<int> v = {1, 2};
+  int more[] = {3, 4, 5};
+  v.append_range(more);
+  ASSERT_EQ(v.size(), 5);
+  for (tenno::size i = 0; i < 5; i++)
+  {
+    ASSERT_EQ(v[i], (int) i + 1);
+  }
+
+  std::vector<std::string> strings = {"b", "c"};
+  tenno::vector<std::string> sv = {"a"};
+  sv.append_range(strings);
+  ASSERT_EQ(sv.size(), 3);
+  ASSERT_EQ(sv[2], "c");
+
+  tenno::vector<int> from_range;
+  from_range.append_range(tenno::range<int>(0, 100));
+  ASSERT_EQ(from_range.size(), 100);
+  ASSERT_EQ(from_range[99], 99);
+}
+
+TEST(vector_insert_range, "vector insert_range")
+{
+  tenno::vector<int> v = {1, 5};
+  int middle[] = {2, 3, 4};
+  auto it = v.insert_range(v.begin() + 1, middle);
+  ASSERT_EQ(*it, 2);
+  ASSERT_EQ(v.size(), 5);
+  for (tenno::size i = 0; i < 5; i++)
+  {
+    ASSERT_EQ(v[i], (int) i + 1);
+  }
+
+  tenno::vector<std::string> sv = {"a", "d"};
+  std::vector<std::string> strings = {"b", "c"};
+  sv.insert_range(sv.begin() + 1, strings);
+  ASSERT_EQ(sv.size(), 4);
+  ASSERT_EQ(sv[0], "a");
+  ASSERT_EQ(sv[1], "b");
+  ASSERT_EQ(sv[2], "c");
+  ASSERT_EQ(sv[3], "d");
+}
+
+TEST(vector_insert_range_input, "vector insert_range single pass range")
+{
+  tenno::vector<int> v = {1, 2, 6, 7};
+  std::istringstream in("3 4 5");
+  auto it = v.insert_range(v.begin() + 2, std::views::istream<int>(in));
+  ASSERT(it == v.begin() + 2);
+  ASSERT_EQ(*it, 3);
+  ASSERT_EQ(v.size(), 7);
+  for (tenno::size i = 0; i < 7; i++)
+  {
+    ASSERT_EQ(v[i], (int) i + 1);
+  }
+
+  tenno::vector<std::string> sv = {"a", "d"};
+  std::istringstream words("b c");
+  auto sit = sv.insert_range(sv.begin() + 1,
+                             std::views::istream<std::string>(words));
+  ASSERT_EQ(*sit, "b");
+  ASSERT_EQ(sv.size(), 4);
+  ASSERT_EQ(sv[2], "c");
+  ASSERT_EQ(sv[3], "d");
+}
+
+TEST(vector_insert_iterators, "vector insert iterators")
+{
+  tenno::vector<int> v = {1, 2, 6};
+  tenno::vector<int> other = {3, 4, 5};
+  v.insert(v.begin() + 2, other.begin(), other.end());
+  ASSERT_EQ(v.size(), 6);
+  for (tenno::size i = 0; i < 6; i++)
+  {
+    ASSERT_EQ(v[i], (int) i + 1);
+  }
+}
+
+TEST(vector_insert_input_iterators, "vector insert single pass iterators")
+{
+  tenno::vector<int> v = {1, 2, 6};
+  std::istringstream in("3 4 5");
+  auto it = v.insert(v.begin() + 2, std::istream_iterator<int>(in),
+                     std::istream_iterator<int>());
+  ASSERT_EQ(*it, 3);
+  ASSERT_EQ(v.size(), 6);
+  for (tenno::size i = 0; i < 6; i++)
+  {
+    ASSERT_EQ(v[i], (int) i + 1);
+  }
+}
+
+struct ThrowingCopy
+{
+  int value;
+
+  ThrowingCopy(int v = 0) : value(v) {}
+  ThrowingCopy(const ThrowingCopy &other) : value(other.value)
+  {
+    if (value < 0)
+    {
+      throw value;
+    }
+  }
+  ThrowingCopy &operator=(const ThrowingCopy &other) = default;
+};
+
+template <> struct tenno::is_trivially_relocatable<ThrowingCopy>
+    : std::true_type
+{
+};
+
+TEST(vector_insert_throwing_copy, "vector insert keeps the tail on throw")
+{
+  tenno::vector<ThrowingCopy> v = {1, 2, 3};
+  v.reserve(8);
+  ThrowingCopy inserted[] = {10, -1, 12};
+  bool thrown = false;
+  try
+  {
+    v.insert(v.begin() + 1, inserted, inserted + 3);
+  }
+  catch (int)
+  {
+    thrown = true;
+  }
+  ASSERT(thrown);
+  ASSERT_EQ(v.size(), 3);
+  ASSERT_EQ(v[0].value, 1);
+  ASSERT_EQ(v[1].value, 2);
+  ASSERT_EQ(v[2].value, 3);
+}
+
+TEST(vector_resize_for_overwrite, "vector resize_for_overwrite")
+{
+  tenno::vector<char> buf;
+  buf.resize_for_overwrite(64);
+  ASSERT_EQ(buf.size(), 64);
+  ASSERT(buf.capacity() >= 64);
+  char *data = buf.data().value();
+  for (tenno::size i = 0; i < 64; i++)
+  {
+    data[i] = (char) i;
+  }
+  buf.resize_default_init(128);
+  ASSERT_EQ(buf.size(), 128);
+  ASSERT_EQ(buf[63], 63);
+  buf.resize_for_overwrite(10);
+  ASSERT_EQ(buf.size(), 10);
+
+  tenno::vector<std::string> sv;
+  sv.resize_for_overwrite(3);
+  ASSERT_EQ(sv.size(), 3);
+  ASSERT(sv[2].empty());
+}
+
+// Built with tenno::vector at compile time
+constexpr tenno::array<int, 8> make_squares()
+{
+  tenno::vector<int> v;
+  for (int i = 7; i >= 0; i--)
+  {
+    v.push_back(i * i);
+  }
+  int front[] = {-1, -2};
+  v.insert_range(v.cbegin(), front);
+  v.reserve(64);
+  v.shrink_to_fit();
+
+  tenno::vector<int> copy = v;
+  tenno::array<int, 8> out;
+  for (tenno::size i = 0; i < 8; i++)
+  {
+    out[i] = copy[copy.size() - 1 - i];
+  }
+  return out;
+}
+
+constexpr tenno::size constexpr_string_lengths()
+{
+  tenno::vector<std::string> v;
+  v.emplace_back("hello");
+  v.push_back("world!");
+  v.resize(3);
+  v.resize_for_overwrite(4);
+  std::string first[] = {"a"};
+  v.insert_range(v.cbegin(), first);
+  tenno::size total = 0;
+  for (const auto &s : v)
+  {
+    total += s.size();
+  }
+  v.pop_back();
+  v.clear();
+  return total + v.size();
+}
+
+TEST(vector_constexpr, "vector in constant evaluation")
+{
+  constexpr tenno::array<int, 8> squares = make_squares();
+  static_assert(squares[0] == 0);
+  static_assert(squares[7] == 49);
+  static_assert(constexpr_string_lengths() == 12);
+  for (tenno::size i = 0; i < 8; i++)
+  {
+    ASSERT_EQ(squares[i], (int) (i * i));
+  }
+}
+
+TEST(vector_erase, "vector erase")
+{
+  tenno::vector<int> v = {0, 1, 2, 3, 4, 5, 6};
+  auto it = v.erase(v.cbegin() + 1);
+  ASSERT_EQ(*it, 2);
+  ASSERT_EQ(v.size(), 6);
+  it = v.erase(v.cbegin() + 2, v.cbegin() + 4);
+  ASSERT_EQ(*it, 5);
+  ASSERT_EQ(v.size(), 4);
+  ASSERT_EQ(v[0], 0);
+  ASSERT_EQ(v[1], 2);
+  ASSERT_EQ(v[2], 5);
+  ASSERT_EQ(v[3], 6);
+  it = v.erase(v.cbegin() + 2, v.cend());
+  ASSERT(it == v.end());
+  ASSERT_EQ(v.size(), 2);
+
+  tenno::vector<std::string> sv = {"a", "b", "c", "d"};
+  sv.erase(sv.cbegin(), sv.cbegin() + 3);
+  ASSERT_EQ(sv.size(), 1);
+  ASSERT_EQ(sv[0], "d");
+}
+
+TEST(vector_erase_if, "tenno::erase_if and tenno::erase on vector")
+{
+  tenno::vector<int> v;
+  for (int i = 0; i < 1000; i++)
+  {
+    v.push_back(i);
+  }
+  tenno::size erased = tenno::erase_if(v, [](int x) { return x % 3 != 0; });
+  ASSERT_EQ(erased, 666);
+  ASSERT_EQ(v.size(), 334);
+  for (tenno::size i = 0; i < v.size(); i++)
+  {
+    ASSERT_EQ(v[i], (int) i * 3);
+  }
+  ASSERT_EQ(tenno::erase(v, 3), 1);
+  ASSERT_EQ(v[1], 6);
+
+  tenno::vector<std::string> sv = {"x", "expired", "y", "expired", "z"};
+  ASSERT_EQ(tenno::erase(sv, "expired"), 2);
+  ASSERT_EQ(sv.size(), 3);
+  ASSERT_EQ(sv[0], "x");
+  ASSERT_EQ(sv[1], "y");
+  ASSERT_EQ(sv[2], "z");
+}
+
+constexpr int constexpr_erase_if()
+{
+  tenno::vector<int> v = {1, 2, 3, 4, 5, 6};
+  tenno::erase_if(v, [](int x) { return x % 2 == 0; });
+  v.erase(v.cbegin());
+  return (int) v.size() * 10 + v[0];
+}
+
+TEST(vector_erase_if_constexpr, "tenno::erase_if in constant evaluation")
+{
+  static_assert(constexpr_erase_if() == 23);
+  ASSERT_EQ(constexpr_erase_if(), 23);
+}
+
+struct throwing_move
+{
+  static inline int copies    = 0;
+  static inline int throw_at  = -1;
+  int               value     = 0;
+
+  throwing_move(int v) : value(v)
+  {
+  }
+
+  throwing_move(const throwing_move &other) : value(other.value)
+  {
+    if (copies++ == throw_at)
+    {
+      throw 42;
+    }
+  }
+
+  throwing_move(throwing_move &&other) noexcept(false) : value(other.value)
+  {
+  }
+
+  throwing_move &operator=(const throwing_move &) = default;
+};
+
+static_assert(noexcept(tenno::uninitialized_relocate_n<int>(nullptr, 0,
+                                                            nullptr)));
+static_assert(!noexcept(tenno::uninitialized_relocate_n<throwing_move>(
+  nullptr, 0, nullptr)));
+
+TEST(vector_reserve_throwing_move, "vector reserve with a throwing move")
+{
+  tenno::vector<throwing_move> v;
+  v.reserve(4);
+  for (int i = 0; i < 4; i++)
+  {
+    v.emplace_back(i);
+  }
+
+  // The move constructor may throw, the elements are copied
+  throwing_move::copies   = 0;
+  throwing_move::throw_at = -1;
+  v.reserve(8);
+  ASSERT_EQ(throwing_move::copies, 4);
+
+  // A failed relocation leaves the vector as it was
+  throwing_move::copies   = 0;
+  throwing_move::throw_at = 2;
+  bool thrown = false;
+  try
+  {
+    v.reserve(100);
+  }
+  catch (int)
+  {
+    thrown = true;
+  }
+  throwing_move::throw_at = -1;
+  ASSERT(thrown);
+  ASSERT_EQ(v.capacity(), 8);
+  ASSERT_EQ(v.size(), 4);
+  for (tenno::size i = 0; i < 4; i++)
+  {
+    ASSERT_EQ(v[i].value, (int) i);
+  }
+}
@@ -5,6 +5,7 @@
 
 #include <tenno/array.hpp>
 #include <tenno/memory.hpp>
+#include <tenno/thread.hpp>
 #include <tenno/utility.hpp>
 #include <valfuzz/valfuzz.hpp>
 
@@ -123,3 +124,31 @@ TEST(weak_ptr_swap, "tenno::weak_ptr swap")
   ASSERT(wp1.use_count() == 1);
   ASSERT(wp2.use_count() == 1);
 }
+
+TEST(weak_ptr_lock_race, "tenno::weak_ptr lock while the last owner resets")
+{
+  int failures = 0;
+  for (int round = 0; round < 200; round++)
+  {
+    auto sp = tenno::shared_ptr<int>(new int(round));
+    tenno::weak_ptr<int> wp(sp);
+    {
+      tenno::jthread locker(
+        [&wp, &failures, round]()
+        {
+          for (int i = 0; i < 100; i++)
+          {
+            tenno::shared_ptr<int> locked = wp.lock();
+            if (locked && *locked != round)
+            {
+              failures++;
+            }
+          }
+        });
+      sp.reset();
+    }
+    ASSERT_EQ(failures, 0);
+    ASSERT(wp.expired());
+    ASSERT(!wp.lock());
+  }
+}